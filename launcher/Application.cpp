@@ -106,7 +106,11 @@
 
 #include <minecraft/auth/AccountList.h>
 #include "icons/IconList.h"
+#include "ContentStore.h"
+#include "java/JavaCheckerCache.h"
+#include "net/FileSink.h"
 #include "net/HttpMetaCache.h"
+#include "net/RequestScheduler.h"
 
 #include "java/JavaInstallList.h"
 
@@ -816,6 +820,12 @@ Application::Application(int& argc, char** argv) : QApplication(argc, argv)
         QString user = settings()->get("ProxyUser").toString();
         QString pass = settings()->get("ProxyPass").toString();
         updateProxySettings(proxyTypeStr, addr, port, user, pass);
+
+        // the download limit is per host across all jobs, so installing several things at once doesn't multiply it
+        auto maxDownloads = m_settings->getSetting("NumberOfConcurrentDownloads");
+        Net::RequestScheduler::instance()->setMaxPerHost(maxDownloads->get().toInt());
+        connect(maxDownloads.get(), &Setting::SettingChanged,
+                [](const Setting&, QVariant value) { Net::RequestScheduler::instance()->setMaxPerHost(value.toInt()); });
         qDebug() << "<> Network done.";
     }
 
@@ -886,7 +896,13 @@ Application::Application(int& argc, char** argv) : QApplication(argc, argv)
         m_metacache->addBase("translations", QDir("translations").absolutePath());
         m_metacache->addBase("meta", QDir("meta").absolutePath());
         m_metacache->addBase("java", QDir("cache/java").absolutePath());
+        m_metacache->addBase("natives", QDir("cache/natives").absolutePath());
         m_metacache->Load();
+        Net::FileSink::setPartialFolder(QDir("cache/partial").absolutePath());
+        // left behind by downloads the launcher was closed in the middle of, and never tried again
+        Net::FileSink::expirePartials(7 * 24 * 60 * 60);
+        m_contentStore = std::make_shared<ContentStore>(QDir("cache/store").absolutePath());
+        m_javaCheckerCache = std::make_shared<JavaCheckerCache>(QDir("cache/javacheck.bin").absolutePath());
         qDebug() << "<> Cache initialized.";
     }
 
@@ -1666,6 +1682,16 @@ shared_qobject_ptr<HttpMetaCache> Application::metacache()
     return m_metacache;
 }
 
+std::shared_ptr<ContentStore> Application::contentStore()
+{
+    return m_contentStore;
+}
+
+std::shared_ptr<JavaCheckerCache> Application::javaCheckerCache()
+{
+    return m_javaCheckerCache;
+}
+
 shared_qobject_ptr<QNetworkAccessManager> Application::network()
 {
     return m_network;
@@ -57,6 +57,8 @@ class SetupWizard;
 class GenericPageProvider;
 class QFile;
 class HttpMetaCache;
+class ContentStore;
+class JavaCheckerCache;
 class SettingsObject;
 class InstanceList;
 class AccountList;
@@ -137,6 +139,10 @@ class Application : public QApplication {
 
     shared_qobject_ptr<HttpMetaCache> metacache();
 
+    std::shared_ptr<ContentStore> contentStore();
+
+    std::shared_ptr<JavaCheckerCache> javaCheckerCache();
+
     shared_qobject_ptr<Meta::Index> metadataIndex();
 
     void updateCapabilities();
@@ -237,6 +243,8 @@ class Application : public QApplication {
     shared_qobject_ptr<AccountList> m_accounts;
 
     shared_qobject_ptr<HttpMetaCache> m_metacache;
+    std::shared_ptr<ContentStore> m_contentStore;
+    std::shared_ptr<JavaCheckerCache> m_javaCheckerCache;
     shared_qobject_ptr<Meta::Index> m_metadataIndex;
 
     std::shared_ptr<SettingsObject> m_settings;
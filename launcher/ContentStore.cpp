@@ -0,0 +1,228 @@
+// SPDX-License-Identifier: GPL-3.0-only
+/*
+ *  Prism Launcher - Minecraft Launcher
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, version 3.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "ContentStore.h"
+
+#include <QDateTime>
+#include <QDebug>
+#include <QDirIterator>
+#include <QFileInfo>
+#include <QUuid>
+
+#include <algorithm>
+
+#include "FileSystem.h"
+
+namespace {
+const QString s_refs_suffix = ".refs";
+const QString s_partial_marker = ".part-";
+
+// blobs that were added without being used anywhere (e.g. prefetched) get some time before being considered unused
+const qint64 s_grace_period_secs = 7 * 24 * 60 * 60;
+
+QString algorithmName(QCryptographicHash::Algorithm algorithm)
+{
+    switch (algorithm) {
+        case QCryptographicHash::Sha1:
+            return "sha1";
+        case QCryptographicHash::Sha256:
+            return "sha256";
+        case QCryptographicHash::Sha512:
+            return "sha512";
+        default:
+            return {};
+    }
+}
+}  // namespace
+
+ContentStore::ContentStore(QString root) : m_root(root) {}
+
+QString ContentStore::blobPath(QCryptographicHash::Algorithm algorithm, const QString& hash) const
+{
+    auto name = algorithmName(algorithm);
+    auto digest = hash.toLower();
+    // the hashes come from the network, never let them be anything else than a digest
+    if (name.isEmpty() || digest.size() != QCryptographicHash::hashLength(algorithm) * 2)
+        return {};
+    for (auto c : digest) {
+        if (!c.isDigit() && (c < 'a' || c > 'f'))
+            return {};
+    }
+    return FS::PathCombine(m_root, name, digest.left(2), digest);
+}
+
+bool ContentStore::contains(QCryptographicHash::Algorithm algorithm, const QString& hash) const
+{
+    auto blob = blobPath(algorithm, hash);
+    return !blob.isEmpty() && QFileInfo(blob).isFile();
+}
+
+bool ContentStore::materialize(QCryptographicHash::Algorithm algorithm, const QString& hash, const QString& target)
+{
+    auto blob = blobPath(algorithm, hash);
+    if (blob.isEmpty())
+        return false;
+
+    // blobs are only ever added once verified, and never linked to anything that could change them in place, so they
+    // are trusted as they are: hashing them again here would read every mod of a pack on the GUI thread
+    QMutexLocker locker(&m_lock);
+    if (!QFileInfo(blob).isFile() || !FS::ensureFilePathExists(target))
+        return false;
+
+    // a reflink or a copy, never a hard link, or editing the file in one instance would change it in all the others
+    auto mode = FS::bestShareMode(blob, target);
+    if (!FS::shareFile(blob, target, mode, false))
+        return false;
+    addReference(blob, target);
+    return true;
+}
+
+bool ContentStore::add(QCryptographicHash::Algorithm algorithm, const QString& hash, const QString& path)
+{
+    auto blob = blobPath(algorithm, hash);
+    if (blob.isEmpty() || !QFileInfo(path).isFile())
+        return false;
+
+    QMutexLocker locker(&m_lock);
+    if (!QFileInfo(blob).isFile()) {
+        // share into a temporary file first, so a blob that exists is always complete
+        // never hard link it though, the file is part of an instance and whatever changes it in place would change the blob
+        auto partial = blob + s_partial_marker + QUuid::createUuid().toString(QUuid::WithoutBraces);
+        auto mode = FS::bestShareMode(path, partial);
+        if (!FS::ensureFilePathExists(partial) || !FS::shareFile(path, partial, mode, false) || !QFile::rename(partial, blob)) {
+            qWarning() << "Failed to add" << path << "to the content store";
+            FS::deletePath(partial);
+            return QFileInfo(blob).isFile();
+        }
+    }
+    addReference(blob, path);
+    return true;
+}
+
+void ContentStore::addReference(const QString& blob, const QString& target)
+{
+    m_pending.insert(QFileInfo(target).absoluteFilePath(), blob);
+}
+
+void ContentStore::commitReferences(const QString& staging, const QString& destination)
+{
+    QMutexLocker locker(&m_lock);
+
+    auto from = QFileInfo(staging).absoluteFilePath() + '/';
+    auto to = QFileInfo(destination).absoluteFilePath() + '/';
+    for (auto it = m_pending.begin(); it != m_pending.end();) {
+        if (!it.key().startsWith(from)) {
+            ++it;
+            continue;
+        }
+        writeReference(it.value(), to + it.key().mid(from.size()));
+        it = m_pending.erase(it);
+    }
+}
+
+void ContentStore::dropReferences(const QString& staging)
+{
+    QMutexLocker locker(&m_lock);
+
+    auto from = QFileInfo(staging).absoluteFilePath() + '/';
+    for (auto it = m_pending.begin(); it != m_pending.end();) {
+        if (it.key().startsWith(from))
+            it = m_pending.erase(it);
+        else
+            ++it;
+    }
+}
+
+void ContentStore::writeReference(const QString& blob, const QString& target)
+{
+    try {
+        FS::append(blob + s_refs_suffix, target.toUtf8() + '\n');
+    } catch (const Exception& e) {
+        qWarning() << "Failed to record the use of" << blob << ":" << e.what();
+    }
+}
+
+int ContentStore::collectGarbage()
+{
+    auto now = QDateTime::currentDateTime();
+    int deleted = 0;
+    QDirIterator it(m_root, QDir::Files, QDirIterator::Subdirectories);
+    while (it.hasNext()) {
+        auto path = it.next();
+        auto info = it.fileInfo();
+
+        if (path.contains(s_partial_marker)) {
+            // left over by an interrupted add
+            if (info.lastModified().secsTo(now) > s_grace_period_secs)
+                FS::deletePath(path);
+            continue;
+        }
+        if (path.endsWith(s_refs_suffix))
+            continue;
+
+        // only for one blob at a time, instances being created materialize their files meanwhile
+        QMutexLocker locker(&m_lock);
+        // hard linked somewhere (by older versions) or about to be committed, definitely in use
+        if (FS::hardLinkCount(path) > 1 || std::find(m_pending.cbegin(), m_pending.cend(), path) != m_pending.cend())
+            continue;
+
+        auto refs_path = path + s_refs_suffix;
+        QFileInfo refs_info(refs_path);
+        QByteArray refs;
+        try {
+            if (refs_info.isFile())
+                refs = FS::read(refs_path);
+        } catch (const Exception& e) {
+            qWarning() << "Failed to read the uses of" << path << ":" << e.what();
+            continue;
+        }
+
+        // a reference is still alive if there is a file of the same size where the blob was materialized
+        QByteArray alive;
+        for (auto& ref : refs.split('\n')) {
+            if (ref.isEmpty())
+                continue;
+            QFileInfo target(QString::fromUtf8(ref));
+            if (target.isFile() && target.size() == info.size() && !alive.contains(ref + '\n'))
+                alive += ref + '\n';
+        }
+
+        if (!alive.isEmpty()) {
+            if (alive.size() != refs.size()) {
+                try {
+                    FS::write(refs_path, alive);
+                } catch (const Exception& e) {
+                    qWarning() << "Failed to update the uses of" << path << ":" << e.what();
+                }
+            }
+            continue;
+        }
+
+        auto last_used = refs_info.exists() ? refs_info.lastModified() : info.lastModified();
+        if (last_used.secsTo(now) < s_grace_period_secs)
+            continue;
+
+        if (FS::deletePath(path)) {
+            FS::deletePath(refs_path);
+            deleted++;
+        }
+    }
+
+    if (deleted)
+        qDebug() << "Removed" << deleted << "unused files from the content store";
+    return deleted;
+}
@@ -0,0 +1,71 @@
+// SPDX-License-Identifier: GPL-3.0-only
+/*
+ *  Prism Launcher - Minecraft Launcher
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, version 3.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <QCryptographicHash>
+#include <QHash>
+#include <QMutex>
+#include <QString>
+
+#include <memory>
+
+/**
+ * Launcher wide store of downloaded files (mods, resource packs...), addressed by their hash.
+ *
+ * Instances get their files from the store as reflinks when the filesystem allows it, so the same jar installed in many
+ * instances is only downloaded and stored once. Otherwise they get plain copies, which still saves downloading them
+ * again. Never hard links: those would let an instance change a blob, and every other instance's file, in place.
+ *
+ * Every file materialized from a blob is remembered next to it, so blobs nothing uses anymore can be collected. As
+ * instances are created in a staging folder that's moved in place at the end, those uses are only written down once
+ * the folder is committed, with their final paths.
+ */
+class ContentStore {
+   public:
+    using Ptr = std::shared_ptr<ContentStore>;
+
+    explicit ContentStore(QString root);
+
+    /** Where the blob with that hash is, or would be. Empty if the hash isn't a valid hex digest. */
+    QString blobPath(QCryptographicHash::Algorithm algorithm, const QString& hash) const;
+    bool contains(QCryptographicHash::Algorithm algorithm, const QString& hash) const;
+
+    /** Puts the contents of the blob at `target`, replacing it. */
+    bool materialize(QCryptographicHash::Algorithm algorithm, const QString& hash, const QString& target);
+
+    /** Adds a file that was already verified to have that hash, like a download that passed its checksum validation. */
+    bool add(QCryptographicHash::Algorithm algorithm, const QString& hash, const QString& path);
+
+    /** Records the uses of the files materialized or added under `staging`, now that it was moved to `destination`. */
+    void commitReferences(const QString& staging, const QString& destination);
+    /** Forgets the uses of the files materialized or added under `staging`, as it's being deleted. */
+    void dropReferences(const QString& staging);
+
+    /** Deletes the blobs that aren't used by any file anymore, returning how many were deleted. */
+    int collectGarbage();
+
+   private:
+    void addReference(const QString& blob, const QString& target);
+    void writeReference(const QString& blob, const QString& target);
+
+    QString m_root;
+    // files materialized or added that aren't committed yet, and the blob they use
+    QHash<QString, QString> m_pending;
+    // NOTE: only guards against collecting a blob while it's being added, materialized or committed
+    QMutex m_lock;
+};
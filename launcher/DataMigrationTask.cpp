@@ -52,12 +52,13 @@ void DataMigrationTask::dryRunFinished()
     // 2. Copy
     // Actually copy all files now.
     m_toCopy = m_copy.totalCopied();
-    connect(&m_copy, &FS::copy::fileCopied, [&, this](const QString& relativeName) {
+    // the files are copied on the pool, the progress is reported from our own thread
+    connect(&m_copy, &FS::copy::fileCopied, this, [this, copied = 0](const QString& relativeName) mutable {
         QString shortenedName = relativeName;
         // shorten the filename to hopefully fit into one line
         if (shortenedName.length() > 50)
             shortenedName = relativeName.left(20) + "…" + relativeName.right(29);
-        setProgress(m_copy.totalCopied(), m_toCopy);
+        setProgress(++copied, m_toCopy);
         setStatus(tr("Copying %1…").arg(shortenedName));
     });
     m_copyFuture = QtConcurrent::run(QThreadPool::globalInstance(), [&] {
@@ -0,0 +1,225 @@
+// SPDX-License-Identifier: GPL-3.0-only
+/*
+ *  Prism Launcher - Minecraft Launcher
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, version 3.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "FileDigestCache.h"
+
+#include <QDataStream>
+#include <QDateTime>
+#include <QDebug>
+#include <QFile>
+#include <QFileInfo>
+
+#include "FileSystem.h"
+
+#if defined(Q_OS_UNIX)
+#include <sys/stat.h>
+#endif
+
+namespace {
+// bump when the on-disk layout changes, old indexes are then simply dropped
+const quint32 s_index_magic = 0x50444331;  // "PDC1"
+const quint32 s_index_version = 3;
+// the least an entry takes up in the index: its path, the stamp and the number of digests
+const qint64 s_min_entry_size = 4 + 3 * 8 + 1;
+
+const qint64 s_read_chunk_size = 1024 * 1024;
+}  // namespace
+
+FileDigestCache::FileDigestCache(QString index_file) : m_index_file(index_file) {}
+
+auto FileDigestCache::stampOf(const QString& path) -> Stamp
+{
+    Stamp stamp;
+    QFileInfo info(path);
+    if (!info.isFile())
+        return stamp;
+
+    stamp.size = info.size();
+    stamp.mtime = info.lastModified().toUTC().toMSecsSinceEpoch();
+#if defined(Q_OS_UNIX)
+    struct stat st;
+    if (::stat(QFile::encodeName(path).constData(), &st) == 0)
+        stamp.inode = static_cast<quint64>(st.st_ino);
+#endif
+    return stamp;
+}
+
+QByteArray FileDigestCache::hashFile(const QString& path, QCryptographicHash::Algorithm algorithm)
+{
+    QFile input(path);
+    if (!input.open(QIODevice::ReadOnly))
+        return {};
+
+    QCryptographicHash hash(algorithm);
+    QByteArray buffer(s_read_chunk_size, Qt::Uninitialized);
+    while (!input.atEnd()) {
+        auto read = input.read(buffer.data(), buffer.size());
+        if (read < 0) {
+            qWarning() << "Failed to read" << path << "while hashing it:" << input.errorString();
+            return {};
+        }
+        hash.addData(QByteArray::fromRawData(buffer.constData(), read));
+    }
+    return hash.result().toHex();
+}
+
+QByteArray FileDigestCache::lookup(const QString& path, const Stamp& stamp, QCryptographicHash::Algorithm algorithm)
+{
+    // anything else than the exact same stamp means reading the whole file again, a file edited in place keeps its size
+    // and inode and nothing short of that tells which parts of it changed
+    QMutexLocker locker(&m_lock);
+    auto it = m_entries.constFind(path);
+    if (it == m_entries.constEnd() || it->stamp != stamp)
+        return {};
+    return it->digests.value(algorithm);
+}
+
+void FileDigestCache::record(const QString& path, const Stamp& stamp, QCryptographicHash::Algorithm algorithm, const QByteArray& hex_digest)
+{
+    QMutexLocker locker(&m_lock);
+    auto& entry = m_entries[path];
+    if (entry.stamp != stamp) {
+        entry.stamp = stamp;
+        entry.digests.clear();
+    }
+    entry.digests.insert(algorithm, hex_digest);
+    m_dirty = true;
+}
+
+QByteArray FileDigestCache::digest(const QString& path, QCryptographicHash::Algorithm algorithm)
+{
+    auto stamp = stampOf(path);
+    if (!stamp.isValid())
+        return {};
+
+    if (auto cached = lookup(path, stamp, algorithm); !cached.isEmpty())
+        return cached;
+
+    // hash without holding the lock, so other files can be looked up in the meantime
+    auto result = hashFile(path, algorithm);
+    if (result.isEmpty())
+        return {};
+
+    // the file changed while we were reading it, don't record a digest we can't trust
+    if (stampOf(path) != stamp)
+        return result;
+
+    record(path, stamp, algorithm, result);
+    return result;
+}
+
+QByteArray FileDigestCache::cachedDigest(const QString& path, QCryptographicHash::Algorithm algorithm)
+{
+    auto stamp = stampOf(path);
+    if (!stamp.isValid())
+        return {};
+    return lookup(path, stamp, algorithm);
+}
+
+void FileDigestCache::insert(const QString& path, QCryptographicHash::Algorithm algorithm, const QByteArray& hex_digest)
+{
+    auto stamp = stampOf(path);
+    if (!stamp.isValid() || hex_digest.isEmpty())
+        return;
+    record(path, stamp, algorithm, hex_digest);
+}
+
+void FileDigestCache::remove(const QString& path)
+{
+    QMutexLocker locker(&m_lock);
+    if (m_entries.remove(path))
+        m_dirty = true;
+}
+
+void FileDigestCache::load()
+{
+    if (m_index_file.isEmpty())
+        return;
+
+    QFile index(m_index_file);
+    if (!index.open(QIODevice::ReadOnly))
+        return;
+
+    QDataStream in(&index);
+    in.setVersion(QDataStream::Qt_5_12);
+
+    quint32 magic, version, count;
+    in >> magic >> version >> count;
+    if (in.status() != QDataStream::Ok || magic != s_index_magic || version != s_index_version) {
+        qWarning() << "Ignoring incompatible file digest index" << m_index_file;
+        return;
+    }
+    // don't allocate for more entries than the rest of the file can hold, the count may be garbage
+    if (count > index.bytesAvailable() / s_min_entry_size) {
+        qWarning() << "File digest index" << m_index_file << "is corrupted, ignoring it";
+        return;
+    }
+
+    QHash<QString, Entry> entries;
+    entries.reserve(count);
+    for (quint32 i = 0; i < count && in.status() == QDataStream::Ok; i++) {
+        QString path;
+        Entry entry;
+        quint8 digest_count;
+        in >> path >> entry.stamp.size >> entry.stamp.mtime >> entry.stamp.inode >> digest_count;
+        for (quint8 j = 0; j < digest_count; j++) {
+            qint32 algorithm;
+            QByteArray digest;
+            in >> algorithm >> digest;
+            entry.digests.insert(algorithm, digest);
+        }
+        entries.insert(path, entry);
+    }
+
+    if (in.status() != QDataStream::Ok) {
+        qWarning() << "File digest index" << m_index_file << "is truncated, ignoring it";
+        return;
+    }
+
+    QMutexLocker locker(&m_lock);
+    m_entries = entries;
+    m_dirty = false;
+}
+
+void FileDigestCache::save()
+{
+    if (m_index_file.isEmpty())
+        return;
+
+    QByteArray data;
+    {
+        QMutexLocker locker(&m_lock);
+        if (!m_dirty)
+            return;
+
+        QDataStream out(&data, QIODevice::WriteOnly);
+        out.setVersion(QDataStream::Qt_5_12);
+        out << s_index_magic << s_index_version << quint32(m_entries.size());
+        for (auto it = m_entries.constBegin(); it != m_entries.constEnd(); ++it) {
+            out << it.key() << it->stamp.size << it->stamp.mtime << it->stamp.inode << quint8(it->digests.size());
+            for (auto digest = it->digests.constBegin(); digest != it->digests.constEnd(); ++digest)
+                out << qint32(digest.key()) << digest.value();
+        }
+        m_dirty = false;
+    }
+
+    try {
+        FS::write(m_index_file, data);
+    } catch (const Exception& e) {
+        qWarning() << "Error writing file digest index:" << e.what();
+    }
+}
@@ -0,0 +1,82 @@
+// SPDX-License-Identifier: GPL-3.0-only
+/*
+ *  Prism Launcher - Minecraft Launcher
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, version 3.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <QByteArray>
+#include <QCryptographicHash>
+#include <QHash>
+#include <QMutex>
+#include <QString>
+
+/**
+ * Persistent index of file digests, keyed by the file path and validated by a cheap stat() stamp.
+ *
+ * As long as the (size, mtime, inode) stamp of a file matches the one recorded together with a digest,
+ * the digest is returned without reading the file. Otherwise the file is re-hashed in a streaming fashion.
+ *
+ * All the methods are thread-safe.
+ */
+class FileDigestCache {
+   public:
+    struct Stamp {
+        qint64 size = -1;
+        qint64 mtime = 0;
+        quint64 inode = 0;
+
+        bool isValid() const { return size >= 0; }
+        bool operator==(const Stamp& other) const { return size == other.size && mtime == other.mtime && inode == other.inode; }
+        bool operator!=(const Stamp& other) const { return !(*this == other); }
+    };
+
+    // supply path to the index file, or nothing for an in-memory only index
+    explicit FileDigestCache(QString index_file = QString());
+
+    /** Stats the file. Returns an invalid stamp if the file doesn't exist or isn't a regular file. */
+    static Stamp stampOf(const QString& path);
+
+    /** Hashes the whole file without loading it into memory. Returns the hex digest, or an empty array on failure. */
+    static QByteArray hashFile(const QString& path, QCryptographicHash::Algorithm algorithm);
+
+    /** Returns the hex digest of the file, only reading it when its stamp changed since it was last hashed. */
+    QByteArray digest(const QString& path, QCryptographicHash::Algorithm algorithm);
+
+    /** Returns the recorded digest of the file if it is still current, or an empty array otherwise. Never hashes the whole file. */
+    QByteArray cachedDigest(const QString& path, QCryptographicHash::Algorithm algorithm);
+
+    /** Records an externally computed hex digest for the current state of the file. */
+    void insert(const QString& path, QCryptographicHash::Algorithm algorithm, const QByteArray& hex_digest);
+
+    void remove(const QString& path);
+
+    void load();
+    void save();
+
+   private:
+    struct Entry {
+        Stamp stamp;
+        QHash<int, QByteArray> digests;
+    };
+
+    QByteArray lookup(const QString& path, const Stamp& stamp, QCryptographicHash::Algorithm algorithm);
+    void record(const QString& path, const Stamp& stamp, QCryptographicHash::Algorithm algorithm, const QByteArray& hex_digest);
+
+    QString m_index_file;
+    QHash<QString, Entry> m_entries;
+    bool m_dirty = false;
+    QMutex m_lock;
+};
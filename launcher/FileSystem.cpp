@@ -45,12 +45,15 @@
 #include <QDirIterator>
 #include <QFile>
 #include <QFileInfo>
+#include <QMutex>
 #include <QSaveFile>
 #include <QStandardPaths>
 #include <QStorageInfo>
 #include <QTextStream>
 #include <QUrl>
+#include <QtConcurrentMap>
 #include <QtNetwork>
+#include <atomic>
 #include <system_error>
 
 #include "DesktopServices.h"
@@ -102,7 +105,13 @@ namespace fs = ghc::filesystem;
 #include <fcntl.h> /* Definition of FICLONE* constants */
 #include <linux/fs.h>
 #include <sys/ioctl.h>
+#include <sys/stat.h>
 #include <unistd.h>
+#if defined(__GLIBC__)
+#if __GLIBC_PREREQ(2, 27)
+#define HAVE_COPY_FILE_RANGE
+#endif
+#endif
 #elif defined(Q_OS_MACOS)
 #include <sys/attr.h>
 #include <sys/clonefile.h>
@@ -310,6 +319,106 @@ void copyFolderAttributes(QString src, QString dst, QString relative)
     }
 }
 
+#if defined(Q_OS_LINUX)
+/**
+ * @brief copies a regular file without moving its contents through user space when possible:
+ * as a reflink if the filesystem can do them, otherwise with copy_file_range
+ *
+ * @param try_clone cleared on the first failed reflink, so the following files go straight to copying
+ */
+static bool linux_copy_file(const std::string& src_path,
+                            const std::string& dst_path,
+                            bool overwrite,
+                            std::atomic<bool>& try_clone,
+                            std::error_code& ec)
+{
+    int src_fd = open(src_path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (src_fd == -1) {
+        ec = std::make_error_code(static_cast<std::errc>(errno));
+        return false;
+    }
+    struct stat src_stat;
+    if (fstat(src_fd, &src_stat) == -1) {
+        ec = std::make_error_code(static_cast<std::errc>(errno));
+        close(src_fd);
+        return false;
+    }
+    int dst_fd = open(dst_path.c_str(), O_WRONLY | O_CREAT | O_CLOEXEC | (overwrite ? O_TRUNC : O_EXCL), src_stat.st_mode & 07777);
+    if (dst_fd == -1) {
+        ec = std::make_error_code(static_cast<std::errc>(errno));
+        close(src_fd);
+        return false;
+    }
+
+    bool done = false;
+    if (try_clone) {
+        if (ioctl(dst_fd, FICLONE, src_fd) == 0)
+            done = true;
+        else
+            try_clone = false;
+    }
+#ifdef HAVE_COPY_FILE_RANGE
+    while (!done) {
+        auto copied = copy_file_range(src_fd, nullptr, dst_fd, nullptr, 1 << 30, 0);
+        if (copied == 0)
+            done = true;
+        else if (copied < 0 && errno != EINTR)
+            break;  // not supported between these files, whatever was copied so far is kept by the fallback below
+    }
+#endif
+    if (!done) {
+        char buffer[64 * 1024];
+        while (!done && !ec) {
+            auto read_bytes = ::read(src_fd, buffer, sizeof(buffer));
+            if (read_bytes == 0) {
+                done = true;
+            } else if (read_bytes < 0) {
+                if (errno != EINTR)
+                    ec = std::make_error_code(static_cast<std::errc>(errno));
+            } else {
+                for (ssize_t written = 0; written < read_bytes && !ec;) {
+                    auto result = ::write(dst_fd, buffer + written, read_bytes - written);
+                    if (result >= 0)
+                        written += result;
+                    else if (errno != EINTR)
+                        ec = std::make_error_code(static_cast<std::errc>(errno));
+                }
+            }
+        }
+    }
+
+    close(src_fd);
+    if (close(dst_fd) == -1 && done) {
+        ec = std::make_error_code(static_cast<std::errc>(errno));
+        done = false;
+    }
+    return done;
+}
+#endif
+
+/**
+ * @brief copies one entry of a copy job, letting the kernel do the work where the platform allows it
+ *
+ */
+static void copy_entry(const QString& src, const QString& dst, fs::copy_options opt, std::atomic<bool>& try_clone, std::error_code& ec)
+{
+    auto src_path = StringUtils::toStdString(src);
+    auto dst_path = StringUtils::toStdString(dst);
+#if defined(Q_OS_LINUX)
+    bool follow = (opt & fs::copy_options::copy_symlinks) == fs::copy_options::none;
+    auto status = follow ? fs::status(src_path, ec) : fs::symlink_status(src_path, ec);
+    if (!ec && fs::is_regular_file(status)) {
+        linux_copy_file(src_path, dst_path, (opt & fs::copy_options::overwrite_existing) != fs::copy_options::none, try_clone, ec);
+        return;
+    }
+    ec.clear();
+#else
+    Q_UNUSED(try_clone)
+#endif
+    // symlinks, and every other platform, where the standard library already uses the native copy
+    fs::copy(src_path, dst_path, opt, ec);
+}
+
 /**
  * @brief Copies a directory and it's contents from src to dest
  * @param offset subdirectory form src to copy to dest
@@ -329,8 +438,6 @@ bool copy::operator()(const QString& offset, bool dryRun)
     auto src = PathCombine(m_src.absolutePath(), offset);
     auto dst = PathCombine(m_dst.absolutePath(), offset);
 
-    std::error_code err;
-
     fs::copy_options opt = copy_opts::none;
 
     // The default behavior is to follow symlinks
@@ -340,49 +447,88 @@ bool copy::operator()(const QString& offset, bool dryRun)
     if (m_overwrite)
         opt |= copy_opts::overwrite_existing;
 
-    // Function that'll do the actual copying
-    auto copy_file = [&](QString src_path, QString relative_dst_path) {
-        if (m_matcher && (m_matcher->matches(relative_dst_path) != m_whitelist))
-            return;
+    // the dry run that sizes up a copy walks the source, and the copy right after it reuses what it found
+    if (!m_enumerated || m_enumeratedOffset != offset) {
+        m_entries.clear();
+        m_totalBytes = 0;
 
-        auto dst_path = PathCombine(dst, relative_dst_path);
-        if (!dryRun) {
+        auto add_entry = [this](const QString& src_path, const QString& relative_path, qint64 size) {
+            if (m_matcher && (m_matcher->matches(relative_path) != m_whitelist))
+                return;
+            m_entries.append({ src_path, relative_path, size });
+            m_totalBytes += size;
+        };
+
+        // We can't use copy_opts::recursive because we need to take into account the
+        // blacklisted paths, so we iterate over the source directory, and if there's no blacklist
+        // match, we copy the file.
+        QDir src_dir(src);
+        QDirIterator source_it(src, QDir::Filter::Files | QDir::Filter::Hidden, QDirIterator::Subdirectories);
+
+        while (source_it.hasNext()) {
+            auto src_path = source_it.next();
+            add_entry(src_path, src_dir.relativeFilePath(src_path), source_it.fileInfo().size());
+        }
+
+        // If the root src is not a directory, the previous iterator won't run.
+        if (!fs::is_directory(StringUtils::toStdString(src)))
+            add_entry(src, "", QFileInfo(src).size());
+
+        m_enumerated = true;
+        m_enumeratedOffset = offset;
+    }
+
+    if (dryRun) {
+        for (auto& entry : m_entries) {
+            m_copied++;
+            emit fileCopied(entry.relative_path);
+        }
+        return true;
+    }
+    m_enumerated = false;
+
+    // create all the folders first, so the files can be copied in any order
+    QSet<QString> created_dirs;
+    for (auto& entry : m_entries) {
+        auto dst_path = PathCombine(dst, entry.relative_path);
+        auto dst_dir = QFileInfo(dst_path).path();
+        if (!created_dirs.contains(dst_dir)) {
+            created_dirs.insert(dst_dir);
             ensureFilePathExists(dst_path);
+        }
 #ifdef Q_OS_WIN32
-            copyFolderAttributes(src, dst, relative_dst_path);
+        copyFolderAttributes(src, dst, entry.relative_path);
 #endif
-            fs::copy(StringUtils::toStdString(src_path), StringUtils::toStdString(dst_path), opt, err);
-        }
+    }
+
+    auto first_dst_dir = m_entries.isEmpty() ? dst : QFileInfo(PathCombine(dst, m_entries.first().relative_path)).path();
+    std::atomic<bool> try_clone{ !m_entries.isEmpty() && canClone(src, first_dst_dir) };
+    qint64 copied_bytes = 0;
+    QMutex report_lock;
+
+    // many small files are bound by the latency of each operation, so copy a few at a time
+    std::function<void(const CopyEntry&)> copy_file = [&](const CopyEntry& entry) {
+        auto dst_path = PathCombine(dst, entry.relative_path);
+        std::error_code err;
+        copy_entry(entry.src_path, dst_path, opt, try_clone, err);
+
+        QMutexLocker locker(&report_lock);
         if (err) {
             qWarning() << "Failed to copy files:" << QString::fromStdString(err.message());
-            qDebug() << "Source file:" << src_path;
+            qDebug() << "Source file:" << entry.src_path;
             qDebug() << "Destination file:" << dst_path;
             m_failedPaths.append(dst_path);
-            emit copyFailed(relative_dst_path);
+            emit copyFailed(entry.relative_path);
             return;
         }
         m_copied++;
-        emit fileCopied(relative_dst_path);
+        copied_bytes += entry.size;
+        emit fileCopied(entry.relative_path);
+        emit bytesCopied(copied_bytes, m_totalBytes);
     };
+    QtConcurrent::blockingMap(m_entries.constBegin(), m_entries.constEnd(), copy_file);
 
-    // We can't use copy_opts::recursive because we need to take into account the
-    // blacklisted paths, so we iterate over the source directory, and if there's no blacklist
-    // match, we copy the file.
-    QDir src_dir(src);
-    QDirIterator source_it(src, QDir::Filter::Files | QDir::Filter::Hidden, QDirIterator::Subdirectories);
-
-    while (source_it.hasNext()) {
-        auto src_path = source_it.next();
-        auto relative_path = src_dir.relativeFilePath(src_path);
-
-        copy_file(src_path, relative_path);
-    }
-
-    // If the root src is not a directory, the previous iterator won't run.
-    if (!fs::is_directory(StringUtils::toStdString(src)))
-        copy_file(src, "");
-
-    return err.value() == 0;
+    return m_failedPaths.isEmpty();
 }
 
 /// qDebug print support for the LinkPair struct
@@ -1658,6 +1804,48 @@ uintmax_t hardLinkCount(const QString& path)
     return count;
 }
 
+ShareMode bestShareMode(const QString& src, const QString& dst)
+{
+    if (canClone(src, dst))
+        return ShareMode::Clone;
+    if (canLink(src, dst) && statFS(src).rootPath == statFS(dst).rootPath)
+        return ShareMode::HardLink;
+    return ShareMode::Copy;
+}
+
+bool shareFile(const QString& src, const QString& dst, ShareMode& mode, bool allowHardLinks)
+{
+    auto src_path = StringUtils::toStdString(src);
+    auto dst_path = StringUtils::toStdString(dst);
+
+    std::error_code err;
+    fs::remove(dst_path, err);
+
+    if (mode == ShareMode::Clone) {
+        if (clone_file(src, dst, err))
+            return true;
+        mode = allowHardLinks ? ShareMode::HardLink : ShareMode::Copy;
+        fs::remove(dst_path, err);
+    }
+
+    if (mode == ShareMode::HardLink && allowHardLinks) {
+        err.clear();
+        fs::create_hard_link(src_path, dst_path, err);
+        if (!err)
+            return true;
+        qDebug() << "Falling back to copying files, hard linking" << src << "failed:" << QString::fromStdString(err.message());
+        mode = ShareMode::Copy;
+    }
+
+    err.clear();
+    fs::copy_file(src_path, dst_path, fs::copy_options::overwrite_existing, err);
+    if (err) {
+        qWarning() << "Failed to copy" << src << "to" << dst << ":" << QString::fromStdString(err.message());
+        return false;
+    }
+    return true;
+}
+
 #ifdef Q_OS_WIN
 // returns 8.3 file format from long path
 QString shortPathName(const QString& file)
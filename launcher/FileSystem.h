@@ -113,16 +113,19 @@ class copy : public QObject {
     copy& followSymlinks(const bool follow)
     {
         m_followSymlinks = follow;
+        m_enumerated = false;
         return *this;
     }
     copy& matcher(const IPathMatcher* filter)
     {
         m_matcher = filter;
+        m_enumerated = false;
         return *this;
     }
     copy& whitelist(bool whitelist)
     {
         m_whitelist = whitelist;
+        m_enumerated = false;
         return *this;
     }
     copy& overwrite(const bool overwrite)
@@ -136,15 +139,25 @@ class copy : public QObject {
     qsizetype totalCopied() { return m_copied; }
     qsizetype totalFailed() { return m_failedPaths.length(); }
     QStringList failed() { return m_failedPaths; }
+    // size of all the files to copy, known after a dry run
+    qint64 totalBytes() { return m_totalBytes; }
 
    signals:
+    // files are copied in parallel, these come from the worker threads, one at a time
     void fileCopied(const QString& relativeName);
     void copyFailed(const QString& relativeName);
+    void bytesCopied(qint64 copied, qint64 total);
     // TODO: maybe add a "shouldCopy" signal in the future?
 
    private:
     bool operator()(const QString& offset, bool dryRun = false);
 
+    struct CopyEntry {
+        QString src_path;
+        QString relative_path;
+        qint64 size;
+    };
+
    private:
     bool m_followSymlinks = true;
     const IPathMatcher* m_matcher = nullptr;
@@ -154,6 +167,11 @@ class copy : public QObject {
     QDir m_dst;
     qsizetype m_copied;
     QStringList m_failedPaths;
+
+    QList<CopyEntry> m_entries;
+    qint64 m_totalBytes = 0;
+    bool m_enumerated = false;
+    QString m_enumeratedOffset;
 };
 
 struct LinkPair {
@@ -556,6 +574,24 @@ bool canLink(const QString& src, const QString& dst);
 
 uintmax_t hardLinkCount(const QString& path);
 
+enum class ShareMode { Clone, HardLink, Copy };
+
+/**
+ * @brief the cheapest way files can be shared from one folder to another: reflinks, hard links or plain copies
+ *
+ */
+ShareMode bestShareMode(const QString& src, const QString& dst);
+
+/**
+ * @brief Puts the contents of src at dst as cheaply as possible, replacing dst if it exists.
+ * Hard links share the file itself, so this is only meant for files nobody writes to, like the contents of caches.
+ *
+ * @param mode the cheapest method to try, lowered when it fails so the following files don't try it again
+ * @param allowHardLinks whether dst may be the same file as src, pass false when either side may get written to
+ * @return false if even copying the file failed
+ */
+bool shareFile(const QString& src, const QString& dst, ShareMode& mode, bool allowHardLinks = true);
+
 #ifdef Q_OS_WIN
 QString getPathNameInLocal8bit(const QString& file);
 #endif
@@ -4,6 +4,7 @@
 #include <memory>
 #include "FileSystem.h"
 #include "NullInstance.h"
+#include "StringUtils.h"
 #include "pathmatcher/RegexpMatcher.h"
 #include "settings/INISettingsObject.h"
 #include "tasks/Task.h"
@@ -47,7 +48,7 @@ void InstanceCopyTask::executeTask()
 
             folderClone(true);
             setProgress(0, folderClone.totalCloned());
-            connect(&folderClone, &FS::clone::fileCloned,
+            connect(&folderClone, &FS::clone::fileCloned, this,
                     [this](QString src, QString dst) { setProgress(m_progress + 1, m_progressTotal); });
             return folderClone();
         }
@@ -68,7 +69,8 @@ void InstanceCopyTask::executeTask()
                 savesCopy->followSymlinks(true);
                 (*savesCopy)(true);
                 setProgress(0, savesCopy->totalCopied());
-                connect(savesCopy.get(), &FS::copy::fileCopied, [this](QString src) { setProgress(m_progress + 1, m_progressTotal); });
+                connect(savesCopy.get(), &FS::copy::fileCopied, this,
+                        [this](QString src) { setProgress(m_progress + 1, m_progressTotal); });
             }
             FS::create_link folderLink(m_origInstance->instanceRoot(), m_stagingPath);
             int depth = m_linkRecursively ? -1 : 0;  // we need to at least link the top level instead of the instance folder
@@ -76,7 +78,7 @@ void InstanceCopyTask::executeTask()
 
             folderLink(true);
             setProgress(0, m_progressTotal + folderLink.totalToLink());
-            connect(&folderLink, &FS::create_link::fileLinked,
+            connect(&folderLink, &FS::create_link::fileLinked, this,
                     [this](QString src, QString dst) { setProgress(m_progress + 1, m_progressTotal); });
             bool there_were_errors = false;
 
@@ -129,9 +131,19 @@ void InstanceCopyTask::executeTask()
         FS::copy folderCopy(m_origInstance->instanceRoot(), m_stagingPath);
         folderCopy.followSymlinks(false).matcher(m_matcher.get());
 
+        // only sizes up the copy, the copy itself reuses the list of files
         folderCopy(true);
-        setProgress(0, folderCopy.totalCopied());
-        connect(&folderCopy, &FS::copy::fileCopied, [this](QString src) { setProgress(m_progress + 1, m_progressTotal); });
+        auto totalBytes = folderCopy.totalBytes();
+        m_copyElapsed.start();
+        // this runs on a worker thread, the progress is reported from the task's own
+        QMetaObject::invokeMethod(this, [this, totalBytes] { setProgress(0, totalBytes); }, Qt::QueuedConnection);
+        connect(&folderCopy, &FS::copy::bytesCopied, this, [this](qint64 copied, qint64 total) {
+            setProgress(copied, total);
+            auto speed = StringUtils::humanReadableFileSize(copied * 1000.0 / qMax<qint64>(m_copyElapsed.elapsed(), 1));
+            //: Amount of data copied out of the total, and the copy speed in bytes per second
+            setDetails(tr("%1 / %2\n%3 /s")
+                           .arg(StringUtils::humanReadableFileSize(copied), StringUtils::humanReadableFileSize(total), speed));
+        });
         return folderCopy();
     });
     connect(&m_copyFutureWatcher, &QFutureWatcher<bool>::finished, this, &InstanceCopyTask::copyFinished);
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <QElapsedTimer>
 #include <QFuture>
 #include <QFutureWatcher>
 #include <QUrl>
@@ -28,6 +29,7 @@ class InstanceCopyTask : public InstanceTask {
     InstancePtr m_origInstance;
     QFuture<bool> m_copyFuture;
     QFutureWatcher<bool> m_copyFutureWatcher;
+    QElapsedTimer m_copyElapsed;
     std::unique_ptr<IPathMatcher> m_matcher;
     bool m_keepPlaytime;
     bool m_useLinks = false;
@@ -38,6 +38,7 @@
 
 #include "Application.h"
 #include "FileSystem.h"
+#include "Json.h"
 #include "MMCZip.h"
 #include "NullInstance.h"
 
@@ -46,6 +47,7 @@
 #include "icons/IconUtils.h"
 
 #include "modplatform/flame/FlameInstanceCreationTask.h"
+#include "modplatform/flame/PackManifest.h"
 #include "modplatform/modrinth/ModrinthInstanceCreationTask.h"
 #include "modplatform/technic/TechnicPackProcessor.h"
 
@@ -59,6 +61,7 @@
 #include <memory>
 
 #include <quazip/quazipdir.h>
+#include <quazip/quazipfile.h>
 
 InstanceImportTask::InstanceImportTask(const QUrl& sourceUrl, QWidget* parent, QMap<QString, QString>&& extra_info)
     : m_sourceUrl(sourceUrl), m_extra_info(extra_info), m_parent(parent)
@@ -71,6 +74,8 @@ bool InstanceImportTask::abort()
 
     if (task)
         task->abort();
+    if (m_prefetch && m_prefetch->isRunning())
+        m_prefetch->abort();
     return Task::abort();
 }
 
@@ -184,6 +189,9 @@ void InstanceImportTask::processZipPack()
     }
     setStatus(tr("Extracting modpack"));
 
+    // before the extraction takes over the zip
+    startPrefetch(packZip.get(), root);
+
     // make sure we extract just the pack
     auto zipTask = makeShared<MMCZip::ExtractZipTask>(packZip, extractDir, root);
 
@@ -198,6 +206,8 @@ void InstanceImportTask::processZipPack()
     connect(zipTask.get(), &Task::failed, this, [this, progressStep](QString reason) {
         progressStep->state = TaskStepState::Failed;
         stepProgress(*progressStep);
+        if (m_prefetch && m_prefetch->isRunning())
+            m_prefetch->abort();
         emitFailed(reason);
     });
     connect(zipTask.get(), &Task::stepProgress, this, &InstanceImportTask::propagateStepProgress);
@@ -214,32 +224,65 @@ void InstanceImportTask::processZipPack()
     zipTask->start();
 }
 
-void InstanceImportTask::extractFinished()
+void InstanceImportTask::startPrefetch(QuaZip* zip, const QString& root)
 {
-    QDir extractDir(m_stagingPath);
+    QString index_name;
+    if (m_modpackType == ModpackType::Modrinth)
+        index_name = "modrinth.index.json";
+    else if (m_modpackType == ModpackType::Flame)
+        index_name = root + "manifest.json";
+    else
+        return;
 
-    qDebug() << "Fixing permissions for extracted pack files...";
-    QDirIterator it(extractDir, QDirIterator::Subdirectories);
-    while (it.hasNext()) {
-        auto filepath = it.next();
-        QFileInfo file(filepath);
-        auto permissions = QFile::permissions(filepath);
-        auto origPermissions = permissions;
-        if (file.isDir()) {
-            // Folder +rwx for current user
-            permissions |= QFileDevice::Permission::ReadUser | QFileDevice::Permission::WriteUser | QFileDevice::Permission::ExeUser;
-        } else {
-            // File +rw for current user
-            permissions |= QFileDevice::Permission::ReadUser | QFileDevice::Permission::WriteUser;
-        }
-        if (origPermissions != permissions) {
-            if (!QFile::setPermissions(filepath, permissions)) {
-                logWarning(tr("Could not fix permissions for %1").arg(filepath));
-            } else {
-                qDebug() << "Fixed" << filepath;
-            }
+    // read the manifest straight from the archive, so the mods can be downloaded while the rest is extracted
+    QuaZipFile file(zip);
+    if (!zip->setCurrentFile(index_name) || !file.open(QIODevice::ReadOnly)) {
+        qWarning() << "Could not read" << index_name << "to prefetch the modpack files";
+        return;
+    }
+    auto index = file.readAll();
+    file.close();
+
+    m_prefetch = makeShared<ModpackPrefetchTask>(APPLICATION->contentStore(), APPLICATION->network());
+    if (m_modpackType == ModpackType::Modrinth) {
+        m_prefetch->setModrinthIndex(index);
+    } else {
+        Flame::Manifest manifest;
+        try {
+            Flame::loadManifest(manifest, index);
+        } catch (const JSONValidationError& e) {
+            // the creation task reports it once the pack is extracted
+            qWarning() << "Not prefetching files of an invalid pack manifest:" << e.cause();
+            m_prefetch.reset();
+            return;
         }
+        m_prefetch->setFlameManifest(manifest);
+    }
+
+    connect(m_prefetch.get(), &Task::finished, this, [this] {
+        if (m_extracted)
+            processExtracted();
+    });
+    connect(m_prefetch.get(), &Task::stepProgress, this, &InstanceImportTask::propagateStepProgress);
+    m_prefetch->start();
+}
+
+void InstanceImportTask::extractFinished()
+{
+    m_extracted = true;
+
+    // the extraction already gave the files the permissions they need, only the mods can be missing now
+    if (m_prefetch && m_prefetch->isRunning()) {
+        setStatus(tr("Downloading mods..."));
+        return;
     }
+    processExtracted();
+}
+
+void InstanceImportTask::processExtracted()
+{
+    if (!isRunning())
+        return;
 
     switch (m_modpackType) {
         case ModpackType::MultiMC:
@@ -283,6 +326,8 @@ void InstanceImportTask::processFlame()
         // FIXME: Find a way to get IDs in directly imported ZIPs
         inst_creation_task = makeShared<FlameCreationTask>(m_stagingPath, m_globalSettings, m_parent, QString(), QString());
     }
+    if (m_prefetch)
+        inst_creation_task->setFileResolver(m_prefetch->flameResolver());
 
     inst_creation_task->setName(*this);
     inst_creation_task->setIcon(m_instIcon);
@@ -39,6 +39,7 @@
 #include <QFutureWatcher>
 #include <QUrl>
 #include "InstanceTask.h"
+#include "modplatform/ModpackPrefetchTask.h"
 
 #include <memory>
 #include <optional>
@@ -62,15 +63,20 @@ class InstanceImportTask : public InstanceTask {
     void processFlame();
     void processModrinth();
     QString getRootFromZip(QuaZip* zip, const QString& root = "");
+    void startPrefetch(QuaZip* zip, const QString& root);
 
    private slots:
     void processZipPack();
     void extractFinished();
+    void processExtracted();
 
    private: /* data */
     QUrl m_sourceUrl;
     QString m_archivePath;
     Task::Ptr task;
+    // fetches the mods while the pack is extracted, the rest of the install waits for both
+    ModpackPrefetchTask::Ptr m_prefetch;
+    bool m_extracted = false;
     enum class ModpackType {
         Unknown,
         MultiMC,
@@ -34,6 +34,7 @@
  *      limitations under the License.
  */
 
+#include <QDataStream>
 #include <QDebug>
 #include <QDir>
 #include <QDirIterator>
@@ -51,8 +52,11 @@
 #include <QTimer>
 #include <QUuid>
 #include <QXmlStreamReader>
+#include <QtConcurrentMap>
 
+#include "Application.h"
 #include "BaseInstance.h"
+#include "ContentStore.h"
 #include "ExponentialSeries.h"
 #include "FileSystem.h"
 #include "InstanceList.h"
@@ -68,6 +72,20 @@
 
 const static int GROUP_FILE_FORMAT_VERSION = 1;
 
+namespace {
+const quint32 s_header_cache_magic = 0x50494843;  // "PIHC"
+// bump when the header keys change, old caches are then simply dropped
+const quint32 s_header_cache_version = 1;
+// the least an entry takes up in the cache: the instance id, its stamp and the size of the header
+const qint64 s_min_header_cache_entry_size = 4 + 2 * 8 + 4;
+
+// what it takes to list an instance, the rest of instance.cfg is only read once the instance is actually used
+const QSet<QString> s_header_keys = { "InstanceType",         "name",           "iconKey",         "lastLaunchTime",
+                                      "totalTimePlayed",      "lastTimePlayed", "linkedInstances", "ManagedPack",
+                                      "ManagedPackType",      "ManagedPackID",  "ManagedPackName", "ManagedPackVersionID",
+                                      "ManagedPackVersionName" };
+}  // namespace
+
 InstanceList::InstanceList(SettingsObjectPtr settings, const QString& instDir, QObject* parent)
     : QAbstractListModel(parent), m_globalSettings(settings)
 {
@@ -462,18 +480,22 @@ InstanceList::InstListError InstanceList::loadList()
 {
     auto existingIds = getIdMapping(m_instances);
 
-    QList<InstancePtr> newList;
-
+    QList<InstanceId> newIds;
     for (auto& id : discoverInstances()) {
         if (existingIds.contains(id)) {
-            auto instPair = existingIds[id];
             existingIds.remove(id);
             qDebug() << "Should keep and soft-reload" << id;
         } else {
-            InstancePtr instPtr = loadInstance(id);
-            if (instPtr) {
-                newList.append(instPtr);
-            }
+            newIds.append(id);
+        }
+    }
+
+    QList<InstancePtr> newList;
+    auto newSettings = loadInstanceSettings(newIds);
+    for (int i = 0; i < newIds.size(); i++) {
+        InstancePtr instPtr = loadInstance(newIds[i], newSettings[i]);
+        if (instPtr) {
+            newList.append(instPtr);
         }
     }
 
@@ -621,14 +643,157 @@ void InstanceList::propertiesChanged(BaseInstance* inst)
     }
 }
 
-InstancePtr InstanceList::loadInstance(const InstanceId& id)
+QList<std::shared_ptr<INISettingsObject>> InstanceList::loadInstanceSettings(const QList<InstanceId>& ids)
+{
+    loadHeaderCache();
+
+    struct Load {
+        InstanceId id;
+        QString path;
+        qint64 size = -1;
+        qint64 mtime = 0;
+        INIFile contents;
+        bool cached = false;
+    };
+    QVector<Load> loads(ids.size());
+    for (int i = 0; i < ids.size(); i++) {
+        loads[i].id = ids[i];
+        loads[i].path = FS::PathCombine(m_instDir, ids[i], "instance.cfg");
+    }
+
+    // on a slow or network drive, reading hundreds of instance.cfg files one by one is what makes startup slow.
+    // unchanged instances only need a stat, and the others are parsed in parallel
+    const auto& cache = m_headerCache;
+    std::function<void(Load&)> read = [&cache](Load& load) {
+        QFileInfo file(load.path);
+        if (!file.exists())
+            return;
+        load.size = file.size();
+        load.mtime = file.lastModified().toUTC().toMSecsSinceEpoch();
+
+        auto it = cache.constFind(load.id);
+        if (it != cache.constEnd() && it->size == load.size && it->mtime == load.mtime) {
+            load.contents = it->header;
+            load.cached = true;
+            return;
+        }
+        load.contents.loadFile(load.path);
+    };
+    QtConcurrent::blockingMap(loads, read);
+
+    QList<std::shared_ptr<INISettingsObject>> out;
+    int cached = 0;
+    for (auto& load : loads) {
+        if (load.cached) {
+            out.append(std::make_shared<INISettingsObject>(load.path, load.contents, s_header_keys));
+            cached++;
+            continue;
+        }
+        out.append(std::make_shared<INISettingsObject>(load.path, load.contents));
+
+        if (load.size == -1) {
+            m_headerCacheDirty |= m_headerCache.remove(load.id) > 0;
+            continue;
+        }
+        HeaderCacheEntry entry;
+        entry.size = load.size;
+        entry.mtime = load.mtime;
+        for (auto& key : s_header_keys) {
+            if (load.contents.contains(key))
+                entry.header.insert(key, load.contents.value(key));
+        }
+        m_headerCache.insert(load.id, entry);
+        m_headerCacheDirty = true;
+    }
+    if (!loads.isEmpty())
+        qDebug() << "Loaded" << loads.size() << "instance configurations," << cached << "of them from the header cache";
+
+    // forget about instances that are gone
+    for (auto it = m_headerCache.begin(); it != m_headerCache.end();) {
+        if (!instanceSet.contains(it.key())) {
+            it = m_headerCache.erase(it);
+            m_headerCacheDirty = true;
+        } else {
+            ++it;
+        }
+    }
+    saveHeaderCache();
+
+    return out;
+}
+
+void InstanceList::loadHeaderCache()
+{
+    if (m_headerCacheLoaded)
+        return;
+    m_headerCacheLoaded = true;
+    m_headerCache.clear();
+
+    QFile cache(FS::PathCombine(m_instDir, ".instheaders"));
+    if (!cache.open(QIODevice::ReadOnly))
+        return;
+
+    QDataStream in(&cache);
+    in.setVersion(QDataStream::Qt_5_12);
+
+    quint32 magic, version, count;
+    in >> magic >> version >> count;
+    if (in.status() != QDataStream::Ok || magic != s_header_cache_magic || version != s_header_cache_version) {
+        qDebug() << "Ignoring outdated instance header cache" << cache.fileName();
+        return;
+    }
+    // don't allocate for more entries than the rest of the file can hold, the count may be garbage
+    if (count > cache.bytesAvailable() / s_min_header_cache_entry_size) {
+        qWarning() << "Instance header cache" << cache.fileName() << "is corrupted, ignoring it";
+        return;
+    }
+
+    QHash<InstanceId, HeaderCacheEntry> entries;
+    entries.reserve(count);
+    for (quint32 i = 0; i < count && in.status() == QDataStream::Ok; i++) {
+        InstanceId id;
+        HeaderCacheEntry entry;
+        in >> id >> entry.size >> entry.mtime >> static_cast<QMap<QString, QVariant>&>(entry.header);
+        entries.insert(id, entry);
+    }
+
+    if (in.status() != QDataStream::Ok) {
+        qWarning() << "Instance header cache" << cache.fileName() << "is corrupted, ignoring it";
+        return;
+    }
+
+    m_headerCache = entries;
+}
+
+void InstanceList::saveHeaderCache()
+{
+    if (!m_headerCacheDirty)
+        return;
+    m_headerCacheDirty = false;
+
+    QByteArray data;
+    QDataStream out(&data, QIODevice::WriteOnly);
+    out.setVersion(QDataStream::Qt_5_12);
+    out << s_header_cache_magic << s_header_cache_version << quint32(m_headerCache.size());
+    for (auto it = m_headerCache.constBegin(); it != m_headerCache.constEnd(); ++it) {
+        out << it.key() << it->size << it->mtime << static_cast<const QMap<QString, QVariant>&>(it->header);
+    }
+
+    WatchLock foo(m_watcher, m_instDir);
+    try {
+        FS::write(FS::PathCombine(m_instDir, ".instheaders"), data);
+    } catch (const FS::FileSystemException& e) {
+        qWarning() << "Failed to write instance header cache:" << e.cause();
+    }
+}
+
+InstancePtr InstanceList::loadInstance(const InstanceId& id, std::shared_ptr<INISettingsObject> instanceSettings)
 {
     if (!m_groupsLoaded) {
         loadGroupList();
     }
 
     auto instanceRoot = FS::PathCombine(m_instDir, id);
-    auto instanceSettings = std::make_shared<INISettingsObject>(FS::PathCombine(instanceRoot, "instance.cfg"));
     InstancePtr inst;
 
     instanceSettings->registerSetting("InstanceType", "");
@@ -840,6 +1005,7 @@ void InstanceList::on_InstFolderChanged([[maybe_unused]] const Setting& setting,
         }
         m_instDir = newInstDir;
         m_groupsLoaded = false;
+        m_headerCacheLoaded = false;
         beginRemoveRows(QModelIndex(), 0, count());
         m_instances.erase(m_instances.begin(), m_instances.end());
         endRemoveRows();
@@ -1020,6 +1186,8 @@ bool InstanceList::commitStagedInstance(const QString& path,
             increaseGroupCount(groupName);
         }
 
+        APPLICATION->contentStore()->commitReferences(path, destination);
+
         instanceSet.insert(instID);
 
         emit instancesChanged();
@@ -1032,6 +1200,7 @@ bool InstanceList::commitStagedInstance(const QString& path,
 
 bool InstanceList::destroyStagingPath(const QString& keyPath)
 {
+    APPLICATION->contentStore()->dropReferences(keyPath);
     return FS::deletePath(keyPath);
 }
 
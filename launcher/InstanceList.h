@@ -36,6 +36,7 @@
 #pragma once
 
 #include <QAbstractListModel>
+#include <QHash>
 #include <QList>
 #include <QObject>
 #include <QPair>
@@ -43,6 +44,9 @@
 #include <QStack>
 
 #include "BaseInstance.h"
+#include "settings/INIFile.h"
+
+class INISettingsObject;
 
 class QFileSystemWatcher;
 class InstanceTask;
@@ -177,7 +181,10 @@ class InstanceList : public QAbstractListModel {
     void loadGroupList();
     void saveGroupList();
     QList<InstanceId> discoverInstances();
-    InstancePtr loadInstance(const InstanceId& id);
+    QList<std::shared_ptr<INISettingsObject>> loadInstanceSettings(const QList<InstanceId>& ids);
+    InstancePtr loadInstance(const InstanceId& id, std::shared_ptr<INISettingsObject> instanceSettings);
+    void loadHeaderCache();
+    void saveHeaderCache();
 
     void increaseGroupCount(const QString& group);
     void decreaseGroupCount(const QString& group);
@@ -198,6 +205,16 @@ class InstanceList : public QAbstractListModel {
     QMap<InstanceId, GroupId> m_instanceGroupIndex;
     QSet<InstanceId> instanceSet;
     bool m_groupsLoaded = false;
+
+    // the settings needed to list each instance, valid while its instance.cfg keeps the same size and modification time
+    struct HeaderCacheEntry {
+        qint64 size = -1;
+        qint64 mtime = 0;
+        INIFile header;
+    };
+    QHash<InstanceId, HeaderCacheEntry> m_headerCache;
+    bool m_headerCacheLoaded = false;
+    bool m_headerCacheDirty = false;
     bool m_instancesProbed = false;
 
     QStack<TrashHistoryItem> m_trashHistory;
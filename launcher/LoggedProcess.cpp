@@ -59,16 +59,24 @@ LoggedProcess::~LoggedProcess()
 
 QStringList LoggedProcess::reprocess(const QByteArray& data, QTextDecoder& decoder)
 {
+    // the decoder keeps incomplete multi-byte sequences around for the next chunk
     auto str = decoder.toUnicode(data);
 
-    if (!m_leftover_line.isEmpty()) {
-        str.prepend(m_leftover_line);
-        m_leftover_line = "";
+    // cut the chunk into lines directly, instead of copying all of it around to prepend the leftover and drop CRs first
+    QStringList lines;
+    int start = 0;
+    for (int end = str.indexOf(QChar::LineFeed); end != -1; end = str.indexOf(QChar::LineFeed, start)) {
+        auto line = str.mid(start, end - start);
+        if (!m_leftover_line.isEmpty()) {
+            line.prepend(m_leftover_line);
+            m_leftover_line.clear();
+        }
+        line.remove(QChar::CarriageReturn);
+        lines.append(line);
+        start = end + 1;
     }
 
-    auto lines = str.remove(QChar::CarriageReturn).split(QChar::LineFeed);
-
-    m_leftover_line = lines.takeLast();
+    m_leftover_line += str.mid(start);
     return lines;
 }
 
@@ -70,14 +70,21 @@ bool mergeZipFiles(QuaZip* into, QFileInfo from, QSet<QString>& contained, const
         }
         contained.insert(filename);
 
-        if (!fileInsideMod.open(QIODevice::ReadOnly)) {
+        // copy the entry as it is stored, so it doesn't need to be inflated and deflated again
+        QuaZipFileInfo64 info_in;
+        int method = 0;
+        int level = 0;
+        if (!modZip.getCurrentFileInfo(&info_in) || !fileInsideMod.open(QIODevice::ReadOnly, &method, &level, true)) {
             qCritical() << "Failed to open " << filename << " from " << from.fileName();
             return false;
         }
 
         QuaZipNewInfo info_out(fileInsideMod.getActualFileName());
+        info_out.dateTime = info_in.dateTime;
+        info_out.externalAttr = info_in.externalAttr;
+        info_out.uncompressedSize = info_in.uncompressedSize;
 
-        if (!zipOutFile.open(QIODevice::WriteOnly, info_out)) {
+        if (!zipOutFile.open(QIODevice::WriteOnly, info_out, nullptr, info_in.crc, method, level, true)) {
             qCritical() << "Failed to open " << filename << " in the jar";
             fileInsideMod.close();
             return false;
@@ -454,6 +461,65 @@ bool collectFileListRecursively(const QString& rootDir, const QString& subDir, Q
     return true;
 }
 
+// ours
+ArchiveIndex::ArchiveIndex(const QString& fileCompressed) : m_zip(fileCompressed)
+{
+    if (!m_zip.open(QuaZip::mdUnzip))
+        return;
+    m_open = true;
+
+    auto unz = m_zip.getUnzFile();
+    m_names.reserve(m_zip.getEntriesCount());
+    m_entries.reserve(m_zip.getEntriesCount());
+    for (bool more = m_zip.goToFirstFile(); more; more = m_zip.goToNextFile()) {
+        auto name = m_zip.getCurrentFileName();
+        unz64_file_pos pos;
+        if (unzGetFilePos64(unz, &pos) != UNZ_OK)
+            continue;
+
+        // directories don't always have an entry of their own, so derive them from the paths
+        for (auto slash = name.indexOf('/'); slash > 0; slash = name.indexOf('/', slash + 1))
+            m_dirs.insert(name.left(slash));
+
+        if (name.endsWith('/'))
+            continue;
+        m_names.append(name);
+        m_entries.insert(name, pos);
+    }
+}
+
+std::optional<QByteArray> ArchiveIndex::read(const QString& name)
+{
+    auto it = m_entries.constFind(name);
+    if (!m_open || it == m_entries.constEnd())
+        return {};
+
+    auto unz = m_zip.getUnzFile();
+    auto pos = *it;
+    unz_file_info64 info;
+    if (unzGoToFilePos64(unz, &pos) != UNZ_OK || unzGetCurrentFileInfo64(unz, &info, nullptr, 0, nullptr, 0, nullptr, 0) != UNZ_OK)
+        return {};
+    if (unzOpenCurrentFile(unz) != UNZ_OK) {
+        qWarning() << "Failed to open" << name << "in" << m_zip.getZipName();
+        return {};
+    }
+
+    QByteArray data;
+    // the size is only a hint, don't trust it blindly for the allocation
+    data.reserve(static_cast<int>(qMin<ZPOS64_T>(info.uncompressed_size, 16 * 1024 * 1024)));
+    char buffer[64 * 1024];
+    int read;
+    while ((read = unzReadCurrentFile(unz, buffer, sizeof(buffer))) > 0)
+        data.append(buffer, read);
+
+    // also verifies the CRC once everything was read
+    if (unzCloseCurrentFile(unz) != UNZ_OK || read < 0) {
+        qWarning() << "Failed to read" << name << "from" << m_zip.getZipName();
+        return {};
+    }
+    return data;
+}
+
 #if defined(LAUNCHER_APPLICATION)
 void ExportToZipTask::executeTask()
 {
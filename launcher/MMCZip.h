@@ -151,6 +151,36 @@ bool extractFile(QString fileCompressed, QString file, QString dir);
  */
 bool collectFileListRecursively(const QString& rootDir, const QString& subDir, QFileInfoList* files, FilterFunction excludeFilter);
 
+/**
+ * Name index of an archive, built from a single pass over its central directory.
+ *
+ * QuaZip::setCurrentFile walks the whole central directory on every call, which adds up when probing an archive for
+ * a bunch of candidate files (like the metadata files of every mod loader); here each lookup is a hash lookup instead.
+ */
+class ArchiveIndex {
+   public:
+    explicit ArchiveIndex(const QString& fileCompressed);
+    ArchiveIndex(const ArchiveIndex&) = delete;
+    ArchiveIndex& operator=(const ArchiveIndex&) = delete;
+
+    bool isOpen() const { return m_open; }
+
+    bool contains(const QString& name) const { return m_entries.contains(name); }
+    /** Whether anything is stored under the directory, given without the trailing slash (e.g. "assets") */
+    bool containsDir(const QString& dir) const { return m_dirs.contains(dir); }
+    QStringList entries() const { return m_names; }
+
+    /** Decompresses a single entry, std::nullopt if it doesn't exist or can't be read */
+    std::optional<QByteArray> read(const QString& name);
+
+   private:
+    QuaZip m_zip;
+    bool m_open = false;
+    QStringList m_names;
+    QHash<QString, unz64_file_pos> m_entries;
+    QSet<QString> m_dirs;
+};
+
 #if defined(LAUNCHER_APPLICATION)
 class ExportToZipTask : public Task {
     Q_OBJECT
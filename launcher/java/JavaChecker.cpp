@@ -40,16 +40,36 @@
 #include <QMap>
 #include <QProcess>
 
+#include "Application.h"
 #include "Commandline.h"
 #include "FileSystem.h"
+#include "java/JavaCheckerCache.h"
 #include "java/JavaUtils.h"
 
 JavaChecker::JavaChecker(QString path, QString args, int minMem, int maxMem, int permGen, int id, QObject* parent)
     : Task(parent), m_path(path), m_args(args), m_minMem(minMem), m_maxMem(maxMem), m_permGen(permGen), m_id(id)
 {}
 
+std::shared_ptr<JavaCheckerCache> JavaChecker::cache() const
+{
+    // only plain probes are shared, the others are about whether the JVM starts with the given arguments
+    bool plain = m_args.isEmpty() && m_minMem == 0 && m_maxMem == 0 && (m_permGen == 0 || m_permGen == 64);
+    return plain ? APPLICATION->javaCheckerCache() : nullptr;
+}
+
 void JavaChecker::executeTask()
 {
+    if (auto cache = this->cache()) {
+        Result result;
+        if (cache->find(m_path, result)) {
+            result.id = m_id;
+            qDebug() << "Using cached Java checker result for" << m_path;
+            emit checkFinished(result);
+            emitSucceeded();
+            return;
+        }
+    }
+
     QString checkerJar = JavaUtils::getJavaCheckPath();
 
     if (checkerJar.isEmpty()) {
@@ -180,6 +200,8 @@ void JavaChecker::finished(int exitcode, QProcess::ExitStatus status)
     result.javaVersion = java_version;
     result.javaVendor = java_vendor;
     qDebug() << "Java checker succeeded.";
+    if (auto cache = this->cache())
+        cache->insert(m_path, result);
     emit checkFinished(result);
     emitSucceeded();
 }
@@ -7,6 +7,8 @@
 #include "QObjectPtr.h"
 #include "tasks/Task.h"
 
+class JavaCheckerCache;
+
 class JavaChecker : public Task {
     Q_OBJECT
    public:
@@ -34,6 +36,9 @@ class JavaChecker : public Task {
    protected:
     virtual void executeTask() override;
 
+   private:
+    std::shared_ptr<JavaCheckerCache> cache() const;
+
    private:
     QProcessPtr process;
     QTimer killTimer;
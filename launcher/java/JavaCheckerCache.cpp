@@ -0,0 +1,161 @@
+// SPDX-License-Identifier: GPL-3.0-only
+/*
+ *  Prism Launcher - Minecraft Launcher
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, version 3.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "JavaCheckerCache.h"
+
+#include <QDataStream>
+#include <QDebug>
+#include <QFile>
+#include <QFileInfo>
+#include <QStandardPaths>
+
+#include "FileSystem.h"
+
+namespace {
+const quint32 s_cache_magic = 0x504a4343;  // "PJCC"
+// bump when the entries gain fields, old caches are then simply dropped
+const quint32 s_cache_version = 1;
+// the least an entry takes up in the cache: five strings, the stamp and the bitness
+const qint64 s_min_entry_size = 5 * 4 + 3 * 8 + 1;
+}  // namespace
+
+JavaCheckerCache::JavaCheckerCache(QString cache_file) : m_cache_file(cache_file) {}
+
+FileDigestCache::Stamp JavaCheckerCache::stampOf(const QString& path)
+{
+    // plain "java" is looked up in PATH, like the process would
+    auto binary = QFileInfo(path).isAbsolute() ? path : QStandardPaths::findExecutable(path);
+    if (binary.isEmpty())
+        return {};
+    return FileDigestCache::stampOf(binary);
+}
+
+bool JavaCheckerCache::find(const QString& path, JavaChecker::Result& result)
+{
+    auto stamp = stampOf(path);
+    if (!stamp.isValid())
+        return false;
+
+    QMutexLocker locker(&m_lock);
+    ensureLoaded();
+
+    auto it = m_entries.constFind(path);
+    if (it == m_entries.constEnd() || it->stamp != stamp)
+        return false;
+
+    result.path = path;
+    result.mojangPlatform = it->mojang_platform;
+    result.realPlatform = it->real_platform;
+    result.javaVersion = it->java_version;
+    result.javaVendor = it->java_vendor;
+    result.is_64bit = it->is_64bit;
+    result.validity = JavaChecker::Result::Validity::Valid;
+    return true;
+}
+
+void JavaCheckerCache::insert(const QString& path, const JavaChecker::Result& result)
+{
+    if (result.validity != JavaChecker::Result::Validity::Valid)
+        return;
+
+    Entry entry;
+    entry.stamp = stampOf(path);
+    if (!entry.stamp.isValid())
+        return;
+    entry.mojang_platform = result.mojangPlatform;
+    entry.real_platform = result.realPlatform;
+    entry.java_version = result.javaVersion.toString();
+    entry.java_vendor = result.javaVendor;
+    entry.is_64bit = result.is_64bit;
+
+    {
+        QMutexLocker locker(&m_lock);
+        ensureLoaded();
+        m_entries.insert(path, entry);
+    }
+    save();
+}
+
+void JavaCheckerCache::ensureLoaded()
+{
+    if (m_loaded)
+        return;
+    m_loaded = true;
+
+    if (m_cache_file.isEmpty())
+        return;
+
+    QFile cache(m_cache_file);
+    if (!cache.open(QIODevice::ReadOnly))
+        return;
+
+    QDataStream in(&cache);
+    in.setVersion(QDataStream::Qt_5_12);
+
+    quint32 magic, version, count;
+    in >> magic >> version >> count;
+    if (in.status() != QDataStream::Ok || magic != s_cache_magic || version != s_cache_version) {
+        qDebug() << "Ignoring outdated Java checker cache" << m_cache_file;
+        return;
+    }
+    // don't allocate for more entries than the rest of the file can hold, the count may be garbage
+    if (count > cache.bytesAvailable() / s_min_entry_size) {
+        qWarning() << "Java checker cache" << m_cache_file << "is corrupted, ignoring it";
+        return;
+    }
+
+    QHash<QString, Entry> entries;
+    entries.reserve(count);
+    for (quint32 i = 0; i < count && in.status() == QDataStream::Ok; i++) {
+        QString path;
+        Entry entry;
+        in >> path >> entry.stamp.size >> entry.stamp.mtime >> entry.stamp.inode >> entry.mojang_platform >> entry.real_platform >>
+            entry.java_version >> entry.java_vendor >> entry.is_64bit;
+        entries.insert(path, entry);
+    }
+
+    if (in.status() != QDataStream::Ok) {
+        qWarning() << "Java checker cache" << m_cache_file << "is corrupted, ignoring it";
+        return;
+    }
+
+    m_entries = entries;
+}
+
+void JavaCheckerCache::save()
+{
+    QByteArray data;
+    {
+        QMutexLocker locker(&m_lock);
+        if (m_cache_file.isEmpty())
+            return;
+
+        QDataStream out(&data, QIODevice::WriteOnly);
+        out.setVersion(QDataStream::Qt_5_12);
+        out << s_cache_magic << s_cache_version << quint32(m_entries.size());
+        for (auto it = m_entries.constBegin(); it != m_entries.constEnd(); ++it) {
+            out << it.key() << it->stamp.size << it->stamp.mtime << it->stamp.inode << it->mojang_platform << it->real_platform
+                << it->java_version << it->java_vendor << it->is_64bit;
+        }
+    }
+
+    try {
+        FS::write(m_cache_file, data);
+    } catch (const Exception& e) {
+        qWarning() << "Failed to write Java checker cache:" << e.what();
+    }
+}
@@ -0,0 +1,64 @@
+// SPDX-License-Identifier: GPL-3.0-only
+/*
+ *  Prism Launcher - Minecraft Launcher
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, version 3.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <QHash>
+#include <QMutex>
+#include <QString>
+
+#include "FileDigestCache.h"
+#include "java/JavaChecker.h"
+
+/**
+ * Launcher-wide cache of what probing a Java binary found out about it.
+ *
+ * Entries are keyed by the path of the binary and only valid while its size, modification time and inode don't change,
+ * so listing the Java installations doesn't start a JVM for each of them every time.
+ * Only plain probes are cached: checks with extra arguments or memory settings are about whether the JVM starts with them.
+ *
+ * All the methods are thread-safe.
+ */
+class JavaCheckerCache {
+   public:
+    // supply path to the cache file, or nothing for an in-memory only cache
+    explicit JavaCheckerCache(QString cache_file = QString());
+
+    /** Fills in the result of probing the binary, if it was probed before and didn't change since. */
+    bool find(const QString& path, JavaChecker::Result& result);
+    /** Records a valid probe result and writes the cache back. */
+    void insert(const QString& path, const JavaChecker::Result& result);
+
+   private:
+    struct Entry {
+        FileDigestCache::Stamp stamp;
+        QString mojang_platform;
+        QString real_platform;
+        QString java_version;
+        QString java_vendor;
+        bool is_64bit = false;
+    };
+
+    static FileDigestCache::Stamp stampOf(const QString& path);
+    void ensureLoaded();
+    void save();
+
+    QString m_cache_file;
+    QHash<QString, Entry> m_entries;
+    bool m_loaded = false;
+    QMutex m_lock;
+};
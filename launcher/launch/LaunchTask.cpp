@@ -131,17 +131,12 @@ void LaunchTask::onProgressReportingRequested()
 
 void LaunchTask::setCensorFilter(QMap<QString, QString> filter)
 {
-    m_censorFilter = filter;
+    m_censor = LogCensor(filter);
 }
 
 QString LaunchTask::censorPrivateInfo(QString in)
 {
-    auto iter = m_censorFilter.begin();
-    while (iter != m_censorFilter.end()) {
-        in.replace(iter.key(), iter.value());
-        iter++;
-    }
-    return in;
+    return m_censor.censor(in);
 }
 
 void LaunchTask::proceed()
@@ -216,12 +211,22 @@ shared_qobject_ptr<LogModel> LaunchTask::getLogModel()
 
 void LaunchTask::onLogLines(const QStringList& lines, MessageLevel::Enum defaultLevel)
 {
-    for (auto& line : lines) {
-        onLogLine(line, defaultLevel);
+    QVector<LogModel::Line> batch;
+    batch.reserve(lines.size());
+    for (auto line : lines) {
+        auto level = processLogLine(line, defaultLevel);
+        batch.append({ level, line });
     }
+    getLogModel()->append(batch);
 }
 
 void LaunchTask::onLogLine(QString line, MessageLevel::Enum level)
+{
+    level = processLogLine(line, level);
+    getLogModel()->append(level, line);
+}
+
+MessageLevel::Enum LaunchTask::processLogLine(QString& line, MessageLevel::Enum level)
 {
     // if the launcher part set a log level, use it
     auto innerLevel = MessageLevel::fromLine(line);
@@ -236,9 +241,7 @@ void LaunchTask::onLogLine(QString line, MessageLevel::Enum level)
 
     // censor private user info
     line = censorPrivateInfo(line);
-
-    auto& model = *getLogModel();
-    model.append(level, line);
+    return level;
 }
 
 void LaunchTask::emitSucceeded()
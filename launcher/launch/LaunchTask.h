@@ -41,6 +41,7 @@
 #include <QProcess>
 #include "BaseInstance.h"
 #include "LaunchStep.h"
+#include "LogCensor.h"
 #include "LogModel.h"
 #include "MessageLevel.h"
 
@@ -114,12 +115,14 @@ class LaunchTask : public Task {
 
    private: /*methods */
     void finalizeSteps(bool successful, const QString& error);
+    /** Finds out the level of the line and censors it, in place. */
+    MessageLevel::Enum processLogLine(QString& line, MessageLevel::Enum level);
 
    protected: /* data */
     MinecraftInstancePtr m_instance;
     shared_qobject_ptr<LogModel> m_logModel;
     QList<shared_qobject_ptr<LaunchStep>> m_steps;
-    QMap<QString, QString> m_censorFilter;
+    LogCensor m_censor;
     int currentStep = -1;
     State state = NotStarted;
     qint64 m_pid = -1;
@@ -0,0 +1,95 @@
+#include "LogCensor.h"
+
+#include <QQueue>
+
+LogCensor::LogCensor(const QMap<QString, QString>& filter)
+{
+    m_nodes.append(Node());
+    for (auto it = filter.constBegin(); it != filter.constEnd(); ++it) {
+        if (it.key().isEmpty())
+            continue;
+
+        int state = 0;
+        for (auto c : it.key()) {
+            auto next = m_nodes[state].next.value(c.unicode(), -1);
+            if (next == -1) {
+                next = m_nodes.size();
+                m_nodes[state].next.insert(c.unicode(), next);
+                m_nodes.append(Node());
+            }
+            state = next;
+        }
+        m_nodes[state].pattern = m_patterns.size();
+        m_patterns.append(it.key());
+        m_replacements.append(it.value());
+    }
+
+    // breadth first, so the fail links of the shorter prefixes are known when they are needed
+    QQueue<int> queue;
+    for (auto child : m_nodes[0].next)
+        queue.enqueue(child);
+    while (!queue.isEmpty()) {
+        auto state = queue.dequeue();
+        for (auto it = m_nodes[state].next.constBegin(); it != m_nodes[state].next.constEnd(); ++it) {
+            auto child = it.value();
+            auto fail = m_nodes[state].fail;
+            while (fail != 0 && !m_nodes[fail].next.contains(it.key()))
+                fail = m_nodes[fail].fail;
+            fail = m_nodes[fail].next.value(it.key(), 0);
+            m_nodes[child].fail = fail == child ? 0 : fail;
+
+            auto& node = m_nodes[child];
+            node.output = m_nodes[node.fail].pattern != -1 ? node.fail : m_nodes[node.fail].output;
+            queue.enqueue(child);
+        }
+    }
+}
+
+int LogCensor::step(int state, QChar c) const
+{
+    while (true) {
+        auto next = m_nodes[state].next.constFind(c.unicode());
+        if (next != m_nodes[state].next.constEnd())
+            return next.value();
+        if (state == 0)
+            return 0;
+        state = m_nodes[state].fail;
+    }
+}
+
+QString LogCensor::censor(const QString& in) const
+{
+    if (isEmpty())
+        return in;
+
+    // the longest pattern starting at each position that has a match, found in a single pass
+    QHash<int, int> matches;
+    int state = 0;
+    for (int i = 0; i < in.size(); i++) {
+        state = step(state, in[i]);
+        for (int node = m_nodes[state].pattern != -1 ? state : m_nodes[state].output; node != -1; node = m_nodes[node].output) {
+            auto pattern = m_nodes[node].pattern;
+            auto start = i + 1 - m_patterns[pattern].size();
+            auto current = matches.constFind(start);
+            if (current == matches.constEnd() || m_patterns[current.value()].size() < m_patterns[pattern].size())
+                matches.insert(start, pattern);
+        }
+    }
+    if (matches.isEmpty())
+        return in;
+
+    QString out;
+    out.reserve(in.size());
+    int i = 0;
+    while (i < in.size()) {
+        auto match = matches.constFind(i);
+        if (match == matches.constEnd()) {
+            out.append(in[i]);
+            i++;
+            continue;
+        }
+        out.append(m_replacements[match.value()]);
+        i += m_patterns[match.value()].size();
+    }
+    return out;
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <QHash>
+#include <QMap>
+#include <QString>
+#include <QVector>
+
+/**
+ * Replaces private values (session ids, tokens...) in log lines with placeholders.
+ *
+ * All the values are looked for in a single pass over the line (Aho-Corasick), instead of one QString::replace per value.
+ * When values overlap, the leftmost and then longest one wins.
+ */
+class LogCensor {
+   public:
+    LogCensor() = default;
+    explicit LogCensor(const QMap<QString, QString>& filter);
+
+    bool isEmpty() const { return m_replacements.isEmpty(); }
+
+    QString censor(const QString& in) const;
+
+   private:
+    struct Node {
+        QHash<ushort, int> next;
+        int fail = 0;
+        // pattern ending at this node, -1 if none
+        int pattern = -1;
+        // closest node down the fail chain that ends a pattern, -1 if none
+        int output = -1;
+    };
+
+    int step(int state, QChar c) const;
+
+    QVector<Node> m_nodes;
+    QVector<QString> m_patterns;
+    QVector<QString> m_replacements;
+};
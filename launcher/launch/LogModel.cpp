@@ -57,6 +57,50 @@ void LogModel::append(MessageLevel::Enum level, QString line)
     endInsertRows();
 }
 
+void LogModel::append(const QVector<Line>& lines)
+{
+    if (m_suspended || lines.isEmpty()) {
+        return;
+    }
+
+    int count = lines.size();
+    bool overflowed = false;
+    if (m_stopOnOverflow) {
+        // the last free line is taken by the overflow message
+        count = qMin(count, m_maxLines - m_numLines);
+        if (count == 0) {
+            // nothing more to do, the buffer is full
+            return;
+        }
+        overflowed = m_numLines + count == m_maxLines;
+    } else {
+        // lines that would be pushed out by the end of the batch anyway are never added
+        count = qMin(count, m_maxLines);
+        int overflow = m_numLines + count - m_maxLines;
+        if (overflow > 0) {
+            beginRemoveRows(QModelIndex(), 0, overflow - 1);
+            m_firstLine = (m_firstLine + overflow) % m_maxLines;
+            m_numLines -= overflow;
+            endRemoveRows();
+        }
+    }
+
+    auto first = m_stopOnOverflow ? lines.constBegin() : lines.constEnd() - count;
+    beginInsertRows(QModelIndex(), m_numLines, m_numLines + count - 1);
+    for (int i = 0; i < count; i++) {
+        auto& entry = m_content[(m_firstLine + m_numLines + i) % m_maxLines];
+        entry.level = first[i].level;
+        entry.line = first[i].text;
+    }
+    if (overflowed) {
+        auto& entry = m_content[(m_firstLine + m_numLines + count - 1) % m_maxLines];
+        entry.level = MessageLevel::Fatal;
+        entry.line = m_overflowMessage;
+    }
+    m_numLines += count;
+    endInsertRows();
+}
+
 void LogModel::suspend(bool suspend)
 {
     m_suspended = suspend;
@@ -12,7 +12,14 @@ class LogModel : public QAbstractListModel {
     int rowCount(const QModelIndex& parent = QModelIndex()) const;
     QVariant data(const QModelIndex& index, int role) const;
 
+    struct Line {
+        MessageLevel::Enum level;
+        QString text;
+    };
+
     void append(MessageLevel::Enum, QString line);
+    /** Appends all the lines at once, notifying views a single time instead of once per line. */
+    void append(const QVector<Line>& lines);
     void clear();
 
     void suspend(bool suspend);
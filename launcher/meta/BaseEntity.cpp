@@ -52,7 +52,7 @@ class ParsingValidator : public Net::Validator {
         m_data.clear();
         return true;
     }
-    bool validate(QNetworkReply&) override
+    bool validate(QNetworkReply*) override
     {
         auto fname = m_entity->localFilename();
         try {
@@ -34,6 +34,8 @@
  */
 
 #include <QCryptographicHash>
+#include <QDataStream>
+#include <QDateTime>
 #include <QDebug>
 #include <QDir>
 #include <QDirIterator>
@@ -41,7 +43,13 @@
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QJsonParseError>
-#include <QVariant>
+#include <QMutex>
+#include <QSet>
+#include <QtConcurrent>
+
+#include <atomic>
+#include <functional>
+#include <numeric>
 
 #include "AssetsUtils.h"
 #include "BuildConfig.h"
@@ -54,64 +62,70 @@
 #include "net/NetRequest.h"
 
 namespace {
-QSet<QString> collectPathsFromDir(QString dirPath)
-{
-    QFileInfo dirInfo(dirPath);
+const quint32 s_cache_magic = 0x50414931;  // "PAI1"
+// bump when the layout changes, old caches are then simply parsed again
+const quint32 s_cache_version = 2;
+// the least an object takes up in the cache: its sha1, size, name offset and name length
+const qint64 s_cached_object_size = 20 + 8 + 4 + 4;
 
-    if (!dirInfo.exists()) {
-        return {};
-    }
+const quint32 s_manifest_magic = 0x50415631;  // "PAV1"
+const quint32 s_manifest_version = 3;
 
-    QSet<QString> out;
+// holds the sha1 of the index a reconstructed assets folder is up to date with
+const QString s_stamp_file = ".index-sha1";
 
-    QDirIterator iter(dirPath, QDirIterator::Subdirectories);
-    while (iter.hasNext()) {
-        QString value = iter.next();
-        QFileInfo info(value);
-        if (info.isFile()) {
-            out.insert(value);
-            qDebug() << value;
-        }
+bool parseSha1(const QString& hex, std::array<char, 20>& sha1)
+{
+    if (hex.size() != 40)
+        return false;
+    auto nibble = [](QChar c) -> int {
+        auto u = c.unicode();
+        if (u >= '0' && u <= '9')
+            return u - '0';
+        if (u >= 'a' && u <= 'f')
+            return u - 'a' + 10;
+        if (u >= 'A' && u <= 'F')
+            return u - 'A' + 10;
+        return -1;
+    };
+    for (int i = 0; i < 20; i++) {
+        auto high = nibble(hex[2 * i]);
+        auto low = nibble(hex[2 * i + 1]);
+        if (high < 0 || low < 0)
+            return false;
+        sha1[i] = static_cast<char>(high << 4 | low);
     }
-    return out;
+    return true;
 }
-}  // namespace
-
-namespace AssetsUtils {
 
-/*
- * Returns true on success, with index populated
- * index is undefined otherwise
- */
-bool loadAssetsIndexJson(const QString& assetsId, const QString& path, AssetsIndex& index)
+QString verifiedManifestPath(const AssetsIndex& index)
 {
-    /*
-    {
-      "objects": {
-        "icons/icon_16x16.png": {
-          "hash": "bdf48ef6b5d0d23bbb02e17d04865216179f510a",
-          "size": 3665
-        },
-        ...
-        }
-      }
-    }
-    */
+    return FS::PathCombine("assets", "indexes", index.id + ".verified");
+}
 
-    QFile file(path);
+AssetsIndex::FolderStamps readVerifiedManifest(const AssetsIndex& index)
+{
+    QFile manifest(verifiedManifestPath(index));
+    if (!manifest.open(QIODevice::ReadOnly))
+        return {};
 
-    // Try to open the file and fail if we can't.
-    // TODO: We should probably report this error to the user.
-    if (!file.open(QIODevice::ReadOnly)) {
-        qCritical() << "Failed to read assets index file" << path;
-        return false;
-    }
-    index.id = assetsId;
+    QDataStream in(&manifest);
+    in.setVersion(QDataStream::Qt_5_12);
 
-    // Read the file and close it.
-    QByteArray jsonData = file.readAll();
-    file.close();
+    quint32 magic, version;
+    QByteArray sha1;
+    AssetsIndex::FolderStamps stamps;
+    in >> magic >> version >> sha1;
+    if (in.status() != QDataStream::Ok || magic != s_manifest_magic || version != s_manifest_version || sha1 != index.sha1)
+        return {};
+    in >> stamps;
+    if (in.status() != QDataStream::Ok)
+        return {};
+    return stamps;
+}
 
+bool parseAssetsIndex(const QByteArray& jsonData, AssetsIndex& index)
+{
     QJsonParseError parseError;
     QJsonDocument jsonDoc = QJsonDocument::fromJson(jsonData, &parseError);
 
@@ -129,44 +143,201 @@ bool loadAssetsIndexJson(const QString& assetsId, const QString& path, AssetsInd
     }
 
     QJsonObject root = jsonDoc.object();
+    index.isVirtual = root.value("virtual").toBool(false);
+    index.mapToResources = root.value("map_to_resources").toBool(false);
 
-    QJsonValue isVirtual = root.value("virtual");
-    if (!isVirtual.isUndefined()) {
-        index.isVirtual = isVirtual.toBool(false);
-    }
+    // straight into the flat array, the objects are already sorted by name
+    QJsonObject objects = root.value("objects").toObject();
+    index.objects.clear();
+    index.objects.reserve(objects.size());
+    index.names.clear();
+    for (auto iter = objects.constBegin(); iter != objects.constEnd(); ++iter) {
+        QJsonObject nested = iter.value().toObject();
 
-    QJsonValue mapToResources = root.value("map_to_resources");
-    if (!mapToResources.isUndefined()) {
-        index.mapToResources = mapToResources.toBool(false);
+        AssetObject object;
+        if (!parseSha1(nested.value("hash").toString(), object.sha1)) {
+            qCritical() << "Invalid assets index JSON: bad hash for" << iter.key();
+            return false;
+        }
+        object.size = static_cast<qint64>(nested.value("size").toDouble());
+        object.name_offset = index.names.size();
+        object.name_length = iter.key().size();
+        index.names += iter.key();
+        index.objects.append(object);
     }
+    index.names.squeeze();
+    return true;
+}
 
-    QJsonValue objects = root.value("objects");
-    QVariantMap map = objects.toVariant().toMap();
+// which index file the cache was made from: its size and modification time to tell without reading it, its sha1 for
+// when it was only touched
+struct CacheHeader {
+    qint64 size = -1;
+    qint64 mtime = -1;
+    QByteArray sha1;
+};
 
-    for (QVariantMap::const_iterator iter = map.begin(); iter != map.end(); ++iter) {
-        // qDebug() << iter.key();
+bool readCacheHeader(QDataStream& in, CacheHeader& header)
+{
+    quint32 magic, version;
+    in >> magic >> version;
+    if (in.status() != QDataStream::Ok || magic != s_cache_magic || version != s_cache_version)
+        return false;
+    in >> header.size >> header.mtime >> header.sha1;
+    return in.status() == QDataStream::Ok;
+}
+
+bool readCachedObjects(QDataStream& in, AssetsIndex& index)
+{
+    quint32 count;
+    in >> index.isVirtual >> index.mapToResources >> index.names >> count;
+    // don't allocate for more objects than the rest of the file can hold, the count may be garbage
+    if (in.status() != QDataStream::Ok || count > in.device()->bytesAvailable() / s_cached_object_size)
+        return false;
+    index.objects.resize(count);
+    for (auto& object : index.objects) {
+        in.readRawData(object.sha1.data(), object.sha1.size());
+        in >> object.size >> object.name_offset >> object.name_length;
+        if (in.status() != QDataStream::Ok || quint64(object.name_offset) + object.name_length > quint64(index.names.size()))
+            return false;
+    }
+    return in.status() == QDataStream::Ok;
+}
 
-        QVariant variant = iter.value();
-        QVariantMap nested_objects = variant.toMap();
+void writeCachedIndex(const QString& cachePath, const CacheHeader& header, const AssetsIndex& index)
+{
+    QByteArray data;
+    QDataStream out(&data, QIODevice::WriteOnly);
+    out.setVersion(QDataStream::Qt_5_12);
+    out << s_cache_magic << s_cache_version << header.size << header.mtime << header.sha1;
+    out << index.isVirtual << index.mapToResources << index.names << quint32(index.objects.size());
+    for (auto& object : index.objects) {
+        out.writeRawData(object.sha1.data(), object.sha1.size());
+        out << object.size << object.name_offset << object.name_length;
+    }
 
-        AssetObject object;
+    try {
+        FS::write(cachePath, data);
+    } catch (const Exception& e) {
+        qWarning() << "Failed to write assets index cache:" << e.what();
+    }
+}
 
-        for (QVariantMap::const_iterator nested_iter = nested_objects.begin(); nested_iter != nested_objects.end(); ++nested_iter) {
-            // qDebug() << nested_iter.key() << nested_iter.value().toString();
-            QString key = nested_iter.key();
-            QVariant value = nested_iter.value();
+AssetsIndex::Ptr loadIndexFile(const QString& assetsId, const QFileInfo& info)
+{
+    /*
+    {
+      "objects": {
+        "icons/icon_16x16.png": {
+          "hash": "bdf48ef6b5d0d23bbb02e17d04865216179f510a",
+          "size": 3665
+        },
+        ...
+        }
+      }
+    }
+    */
 
-            if (key == "hash") {
-                object.hash = value.toString();
-            } else if (key == "size") {
-                object.size = value.toDouble();
-            }
+    auto index = std::make_shared<AssetsIndex>();
+    index->id = assetsId;
+    CacheHeader stamp{ info.size(), info.lastModified().toMSecsSinceEpoch(), {} };
+
+    QByteArray jsonData;
+    bool jsonRead = false;
+    auto readJson = [&] {
+        if (jsonRead)
+            return true;
+        QFile file(info.filePath());
+        if (!file.open(QIODevice::ReadOnly)) {
+            qCritical() << "Failed to read assets index file" << info.filePath();
+            return false;
         }
+        jsonData = file.readAll();
+        jsonRead = true;
+        index->sha1 = QCryptographicHash::hash(jsonData, QCryptographicHash::Sha1);
+        return true;
+    };
+
+    auto cachePath = FS::PathCombine(info.path(), info.completeBaseName() + ".bin");
+    QFile cache(cachePath);
+    QDataStream in(&cache);
+    in.setVersion(QDataStream::Qt_5_12);
+    CacheHeader header;
+    bool cached = cache.open(QIODevice::ReadOnly) && readCacheHeader(in, header);
+    bool restamp = false;
+    if (cached && header.size == stamp.size && header.mtime == stamp.mtime) {
+        index->sha1 = header.sha1;
+    } else {
+        // replaced, or only touched: the contents tell which
+        if (!readJson())
+            return nullptr;
+        cached = cached && header.sha1 == index->sha1;
+        restamp = cached;
+    }
 
-        index.objects.insert(iter.key(), object);
+    if (cached && !readCachedObjects(in, *index)) {
+        qWarning() << "Assets index cache" << cachePath << "is corrupted, ignoring it";
+        cached = false;
     }
+    cache.close();
 
-    return true;
+    if (!cached) {
+        if (!readJson() || !parseAssetsIndex(jsonData, *index))
+            return nullptr;
+    }
+    if (!cached || restamp) {
+        stamp.sha1 = index->sha1;
+        writeCachedIndex(cachePath, stamp, *index);
+    }
+    return index;
+}
+}  // namespace
+
+namespace AssetsUtils {
+
+AssetsIndex::Ptr loadAssetsIndex(const QString& assetsId, const QString& path)
+{
+    struct Loaded {
+        QString path;
+        qint64 size;
+        qint64 mtime;
+        AssetsIndex::Ptr index;
+    };
+    // an instance only ever uses one index, keep the last few around for the ones launched next
+    static const int s_max_loaded = 4;
+    static QMutex s_lock;
+    static QList<Loaded> s_loaded;
+
+    QFileInfo info(path);
+    if (!info.isFile()) {
+        qCritical() << "Failed to read assets index file" << path;
+        return nullptr;
+    }
+    auto size = info.size();
+    auto mtime = info.lastModified().toMSecsSinceEpoch();
+    auto key = info.absoluteFilePath();
+
+    QMutexLocker locker(&s_lock);
+    for (int i = 0; i < s_loaded.size(); i++) {
+        auto& loaded = s_loaded[i];
+        if (loaded.path != key)
+            continue;
+        if (loaded.size == size && loaded.mtime == mtime && loaded.index->id == assetsId) {
+            s_loaded.move(i, 0);
+            return s_loaded.first().index;
+        }
+        s_loaded.removeAt(i);
+        break;
+    }
+
+    auto index = loadIndexFile(assetsId, info);
+    if (!index)
+        return nullptr;
+
+    s_loaded.prepend({ key, size, mtime, index });
+    while (s_loaded.size() > s_max_loaded)
+        s_loaded.removeLast();
+    return index;
 }
 
 // FIXME: ugly code duplication
@@ -186,16 +357,15 @@ QDir getAssetsDir(const QString& assetsId, const QString& resourcesFolder)
         return virtualRoot;
     }
 
-    AssetsIndex index;
-    if (!AssetsUtils::loadAssetsIndexJson(assetsId, indexPath, index)) {
+    auto index = AssetsUtils::loadAssetsIndex(assetsId, indexPath);
+    if (!index) {
         qCritical() << "Failed to load asset index file" << indexPath << "; can't determine assets path!";
         return virtualRoot;
     }
 
-    QString targetPath;
-    if (index.isVirtual) {
+    if (index->isVirtual) {
         return virtualRoot;
-    } else if (index.mapToResources) {
+    } else if (index->mapToResources) {
         return QDir(resourcesFolder);
     }
     return virtualRoot;
@@ -220,102 +390,233 @@ bool reconstructAssets(QString assetsId, QString resourcesFolder)
 
     qDebug() << "reconstructAssets" << assetsDir.path() << indexDir.path() << objectDir.path() << virtualDir.path() << virtualRoot.path();
 
-    AssetsIndex index;
-    if (!AssetsUtils::loadAssetsIndexJson(assetsId, indexPath, index)) {
+    auto index = AssetsUtils::loadAssetsIndex(assetsId, indexPath);
+    if (!index) {
         qCritical() << "Failed to load asset index file" << indexPath << "; can't reconstruct assets!";
         return false;
     }
 
     QString targetPath;
     bool removeLeftovers = false;
-    if (index.isVirtual) {
+    if (index->isVirtual) {
         targetPath = virtualRoot.path();
         removeLeftovers = true;
         qDebug() << "Reconstructing virtual assets folder at" << targetPath;
-    } else if (index.mapToResources) {
+    } else if (index->mapToResources) {
         targetPath = resourcesFolder;
         qDebug() << "Reconstructing resources folder at" << targetPath;
     }
 
-    if (!targetPath.isNull()) {
-        auto presentFiles = collectPathsFromDir(targetPath);
-        for (QString map : index.objects.keys()) {
-            AssetObject asset_object = index.objects.value(map);
-            QString target_path = FS::PathCombine(targetPath, map);
-            QFile target(target_path);
+    if (targetPath.isNull())
+        return true;
 
-            QString tlk = asset_object.hash.left(2);
+    // the resources folder belongs to the instance: files the user changed stay as they are, files they deleted come
+    // back, and nothing in it may be the object itself or editing it would change the object for every instance
+    bool userFolder = !index->isVirtual;
 
-            QString original_path = FS::PathCombine(objectDir.path(), tlk, asset_object.hash);
-            QFile original(original_path);
-            if (!original.exists())
-                continue;
+    // the virtual folder was already reconstructed from this exact index
+    auto stampPath = FS::PathCombine(targetPath, s_stamp_file);
+    auto stamp = index->sha1.toHex();
+    try {
+        if (!userFolder && QFileInfo(stampPath).isFile() && FS::read(stampPath) == stamp) {
+            qDebug() << "Assets at" << targetPath << "are up to date";
+            return true;
+        }
+    } catch (const Exception& e) {
+        qWarning() << "Failed to read" << stampPath << ":" << e.what();
+    }
 
-            presentFiles.remove(target_path);
+    // create the folders upfront, so the objects can be put in place concurrently
+    QSet<QString> targetDirs;
+    for (auto& asset_object : index->objects)
+        targetDirs.insert(QFileInfo(FS::PathCombine(targetPath, index->name(asset_object))).path());
+    for (auto& dir : targetDirs)
+        FS::ensureFolderPathExists(dir);
+
+    auto bestMode = FS::bestShareMode(objectDir.path(), targetPath);
+    if (userFolder && bestMode == FS::ShareMode::HardLink)
+        bestMode = FS::ShareMode::Copy;
+    std::atomic<FS::ShareMode> shareMode(bestMode);
+    std::atomic<int> shared(0);
+    std::atomic<int> missing(0);
+    std::atomic<int> failed(0);
+    std::function<void(const AssetObject&)> reconstruct = [&](const AssetObject& asset_object) {
+        QString target_path = FS::PathCombine(targetPath, index->name(asset_object));
+        QFileInfo target(target_path);
+        if (userFolder ? target.exists() : target.isFile() && target.size() == asset_object.size)
+            return;
+
+        QString original_path = FS::PathCombine(objectDir.path(), asset_object.getRelPath());
+        if (!QFileInfo(original_path).isFile()) {
+            missing++;
+            return;
+        }
 
-            if (!target.exists()) {
-                QFileInfo info(target_path);
-                QDir target_dir = info.dir();
+        auto mode = shareMode.load();
+        if (FS::shareFile(original_path, target_path, mode, !userFolder))
+            shared++;
+        else
+            failed++;
+        // the first file to find out links don't work here spares the others from trying
+        if (mode != shareMode.load())
+            shareMode.store(mode);
+    };
+    QtConcurrent::blockingMap(index->objects.constBegin(), index->objects.constEnd(), reconstruct);
+
+    int removed = 0;
+    if (removeLeftovers) {
+        QSet<QString> names;
+        names.reserve(index->objects.size());
+        for (auto& asset_object : index->objects)
+            names.insert(index->name(asset_object));
+
+        QDir target(targetPath);
+        QDirIterator iter(targetPath, QDir::Files | QDir::Hidden, QDirIterator::Subdirectories);
+        while (iter.hasNext()) {
+            auto path = iter.next();
+            auto relative = target.relativeFilePath(path);
+            if (relative != s_stamp_file && !names.contains(relative) && FS::deletePath(path))
+                removed++;
+        }
+    }
 
-                qDebug() << target_dir.path();
-                FS::ensureFolderPathExists(target_dir.path());
+    qDebug() << "Reconstructed" << shared.load() << "assets at" << targetPath << "and removed" << removed << "leftovers," << missing.load()
+             << "objects are missing," << failed.load() << "failed";
 
-                bool couldCopy = original.copy(target_path);
-                qDebug() << " Copying" << original_path << "to" << target_path << QString::number(couldCopy);
-            }
-        }
+    // TODO: Write last used time to virtualRoot/.lastused
+    if (missing > 0 || failed > 0 || userFolder)
+        return failed == 0;
 
-        // TODO: Write last used time to virtualRoot/.lastused
-        if (removeLeftovers) {
-            for (auto& file : presentFiles) {
-                qDebug() << "Would remove" << file;
-            }
-        }
+    try {
+        FS::write(stampPath, stamp);
+    } catch (const Exception& e) {
+        qWarning() << "Failed to write" << stampPath << ":" << e.what();
     }
     return true;
 }
 
 }  // namespace AssetsUtils
 
-Net::NetRequest::Ptr AssetObject::getDownloadAction()
+Net::NetRequest::Ptr AssetObject::getDownloadAction() const
+{
+    if (isPresent())
+        return nullptr;
+    return makeDownloadAction();
+}
+
+Net::NetRequest::Ptr AssetObject::makeDownloadAction() const
+{
+    auto objectDL = Net::ApiDownload::makeFile(getUrl(), getLocalPath());
+    objectDL->addValidator(new Net::ChecksumValidator(QCryptographicHash::Sha1, QByteArray(sha1.data(), sha1.size())));
+    objectDL->setProgress(objectDL->getProgress(), size);
+    return objectDL;
+}
+
+bool AssetObject::isPresent() const
 {
     QFileInfo objectFile(getLocalPath());
-    if ((!objectFile.isFile()) || (objectFile.size() != size)) {
-        auto objectDL = Net::ApiDownload::makeFile(getUrl(), objectFile.filePath());
-        if (hash.size()) {
-            objectDL->addValidator(new Net::ChecksumValidator(QCryptographicHash::Sha1, hash));
-        }
-        objectDL->setProgress(objectDL->getProgress(), size);
-        return objectDL;
-    }
-    return nullptr;
+    return objectFile.isFile() && objectFile.size() == size;
 }
 
-QString AssetObject::getLocalPath()
+QString AssetObject::hash() const
+{
+    return QByteArray::fromRawData(sha1.data(), sha1.size()).toHex();
+}
+
+QString AssetObject::getLocalPath() const
 {
     return "assets/objects/" + getRelPath();
 }
 
-QUrl AssetObject::getUrl()
+QUrl AssetObject::getUrl() const
 {
     return BuildConfig.RESOURCE_BASE + getRelPath();
 }
 
-QString AssetObject::getRelPath()
+QString AssetObject::getRelPath() const
 {
-    return hash.left(2) + "/" + hash;
+    auto hex = hash();
+    return hex.left(2) + "/" + hex;
 }
 
-NetJob::Ptr AssetsIndex::getDownloadJob()
+NetJob::Ptr AssetsIndex::getDownloadJob() const
 {
+    return getDownloadJob(missingObjects());
+}
+
+NetJob::Ptr AssetsIndex::getDownloadJob(const QVector<int>& missing) const
+{
+    if (missing.isEmpty())
+        return nullptr;
+
     auto job = makeShared<NetJob>(QObject::tr("Assets for %1").arg(id), APPLICATION->network());
-    for (auto& object : objects.values()) {
-        auto dl = object.getDownloadAction();
-        if (dl) {
-            job->addNetAction(dl);
+    // only ever needed to launch the game
+    job->setPriority(Net::Priority::Blocking);
+    for (auto i : missing)
+        job->addNetAction(objects.at(i).makeDownloadAction());
+    return job;
+}
+
+AssetsIndex::FolderStamps AssetsIndex::objectFolderStamps() const
+{
+    std::array<bool, 256> seen{};
+    FolderStamps stamps;
+    for (auto& object : objects) {
+        auto prefix = static_cast<quint8>(object.sha1[0]);
+        if (seen[prefix])
+            continue;
+        seen[prefix] = true;
+
+        auto dir = QString("%1").arg(prefix, 2, 16, QChar('0'));
+        QFileInfo info(FS::PathCombine("assets", "objects", dir));
+        if (!info.exists()) {
+            stamps.insert(dir, { -1 });
+            continue;
         }
+        // only the names, these folders are shared by every index ever downloaded and statting all of them would cost
+        // as much as checking the objects
+        auto filter = QDir::AllEntries | QDir::NoDotAndDotDot | QDir::Hidden | QDir::System;
+        auto entries = QDir(info.filePath()).entryList(filter, QDir::Unsorted);
+        stamps.insert(dir, { info.lastModified().toMSecsSinceEpoch(), entries.size() });
+    }
+    return stamps;
+}
+
+QVector<int> AssetsIndex::missingObjects() const
+{
+    // taken before looking at the objects, anything changing meanwhile has to be checked again next time
+    auto stamps = objectFolderStamps();
+    auto manifest = readVerifiedManifest(*this);
+    if (!manifest.isEmpty() && manifest == stamps)
+        return {};
+
+    QVector<int> positions(objects.size());
+    std::iota(positions.begin(), positions.end(), 0);
+    QVector<char> present(objects.size());
+    std::function<void(int)> check = [this, &present](int i) { present[i] = objects.at(i).isPresent(); };
+    QtConcurrent::blockingMap(positions, check);
+
+    QVector<int> missing;
+    for (int i = 0; i < objects.size(); i++) {
+        if (!present[i])
+            missing.append(i);
+    }
+
+    if (missing.isEmpty())
+        markVerified(stamps);
+    return missing;
+}
+
+void AssetsIndex::markVerified(const FolderStamps& stamps) const
+{
+    QByteArray data;
+    QDataStream out(&data, QIODevice::WriteOnly);
+    out.setVersion(QDataStream::Qt_5_12);
+    out << s_manifest_magic << s_manifest_version << sha1 << stamps;
+
+    try {
+        FS::write(verifiedManifestPath(*this), data);
+    } catch (const Exception& e) {
+        qWarning() << "Failed to write verified assets manifest:" << e.what();
     }
-    if (job->size())
-        return job;
-    return nullptr;
 }
@@ -15,33 +15,78 @@
 
 #pragma once
 
+#include <QList>
 #include <QMap>
 #include <QString>
+#include <array>
+#include <memory>
 #include "net/NetJob.h"
 #include "net/NetRequest.h"
 
 struct AssetObject {
-    QString getRelPath();
-    QUrl getUrl();
-    QString getLocalPath();
-    Net::NetRequest::Ptr getDownloadAction();
+    QString getRelPath() const;
+    QUrl getUrl() const;
+    QString getLocalPath() const;
+    /** A download of the object, or nullptr if it is already there. */
+    Net::NetRequest::Ptr getDownloadAction() const;
+    Net::NetRequest::Ptr makeDownloadAction() const;
+    bool isPresent() const;
 
-    QString hash;
-    qint64 size;
+    /** The sha1 of the object, in hex. */
+    QString hash() const;
+
+    std::array<char, 20> sha1;
+    qint64 size = 0;
+    // where the name of the object is in AssetsIndex::names
+    quint32 name_offset = 0;
+    quint32 name_length = 0;
 };
 
 struct AssetsIndex {
-    NetJob::Ptr getDownloadJob();
+    using Ptr = std::shared_ptr<const AssetsIndex>;
+
+    NetJob::Ptr getDownloadJob() const;
+    /** Downloads the given objects, as returned by missingObjects(). */
+    NetJob::Ptr getDownloadJob(const QVector<int>& missing) const;
+
+    // by object folder: its modification time, and how many entries it has
+    using FolderStamps = QMap<QString, QList<qint64>>;
+
+    /**
+     * The positions of the objects that still have to be downloaded.
+     * Checking every object takes a while, run it in the background. It is skipped entirely when nothing changed in the
+     * object folders since the objects were last known to be all there.
+     */
+    QVector<int> missingObjects() const;
+    /** Stamps the object folders this index uses. Lists all of them, so keep it off the GUI thread as well. */
+    FolderStamps objectFolderStamps() const;
+    /** Records that all the objects are there, as of when the stamps were taken. */
+    void markVerified(const FolderStamps& stamps) const;
+
+    /** The path of the object in virtual asset folders, like "minecraft/sounds/ambient/cave/cave1.ogg". */
+    QString name(const AssetObject& object) const { return QString::fromRawData(names.constData() + object.name_offset, object.name_length); }
 
     QString id;
-    QMap<QString, AssetObject> objects;
+    // sha1 of the index file it was loaded from
+    QByteArray sha1;
+    // sorted by name
+    QVector<AssetObject> objects;
+    // the names of all the objects, back to back
+    QString names;
     bool isVirtual = false;
     bool mapToResources = false;
 };
 
 /// FIXME: this is absolutely horrendous. REDO!!!!
 namespace AssetsUtils {
-bool loadAssetsIndexJson(const QString& id, const QString& file, AssetsIndex& index);
+/**
+ * Loads an assets index file, parsing it at most once per process.
+ * The parsed index is also cached next to the file, and reused for as long as the file has the same size and
+ * modification time, or failing that, the same sha1.
+ *
+ * Returns nullptr if the index can't be read.
+ */
+AssetsIndex::Ptr loadAssetsIndex(const QString& id, const QString& file);
 
 QDir getAssetsDir(const QString& assetsId, const QString& resourcesFolder);
 
@@ -84,6 +84,7 @@
 
 #include "AssetsUtils.h"
 #include "MinecraftLoadAndCheck.h"
+#include "MinecraftLogLevel.h"
 #include "PackProfile.h"
 #include "minecraft/gameoptions/GameOptions.h"
 #include "minecraft/update/FoldersTask.h"
@@ -120,13 +121,12 @@ class OrSetting : public Setting {
 
 MinecraftInstance::MinecraftInstance(SettingsObjectPtr globalSettings, SettingsObjectPtr settings, const QString& rootDir)
     : BaseInstance(globalSettings, settings, rootDir)
-{
-    m_components.reset(new PackProfile(this));
-}
+{}
 
 void MinecraftInstance::saveNow()
 {
-    m_components->saveNow();
+    if (m_components)
+        m_components->saveNow();
 }
 
 void MinecraftInstance::loadSpecificSettings()
@@ -217,7 +217,8 @@ void MinecraftInstance::loadSpecificSettings()
 void MinecraftInstance::updateRuntimeContext()
 {
     m_runtimeContext.updateFromInstanceSettings(m_settings);
-    m_components->invalidateLaunchProfile();
+    if (m_components)
+        m_components->invalidateLaunchProfile();
 }
 
 QString MinecraftInstance::typeName() const
@@ -227,6 +228,9 @@ QString MinecraftInstance::typeName() const
 
 std::shared_ptr<PackProfile> MinecraftInstance::getPackProfile() const
 {
+    // most instances are only ever listed, so the profile is only created once something needs it
+    if (!m_components)
+        m_components.reset(new PackProfile(const_cast<MinecraftInstance*>(this)));
     return m_components;
 }
 
@@ -402,21 +406,21 @@ QDir MinecraftInstance::versionsPath() const
 QStringList MinecraftInstance::getClassPath()
 {
     QStringList jars, nativeJars;
-    auto profile = m_components->getProfile();
+    auto profile = getPackProfile()->getProfile();
     profile->getLibraryFiles(runtimeContext(), jars, nativeJars, getLocalLibraryPath(), binRoot());
     return jars;
 }
 
 QString MinecraftInstance::getMainClass() const
 {
-    auto profile = m_components->getProfile();
+    auto profile = getPackProfile()->getProfile();
     return profile->getMainClass();
 }
 
 QStringList MinecraftInstance::getNativeJars()
 {
     QStringList jars, nativeJars;
-    auto profile = m_components->getProfile();
+    auto profile = getPackProfile()->getProfile();
     profile->getLibraryFiles(runtimeContext(), jars, nativeJars, getLocalLibraryPath(), binRoot());
     return nativeJars;
 }
@@ -431,11 +435,11 @@ QStringList MinecraftInstance::extraArguments()
     if (!jarMods.isEmpty()) {
         list.append({ "-Dfml.ignoreInvalidMinecraftCertificates=true", "-Dfml.ignorePatchDiscrepancies=true" });
     }
-    auto addn = m_components->getProfile()->getAddnJvmArguments();
+    auto addn = getPackProfile()->getProfile()->getAddnJvmArguments();
     if (!addn.isEmpty()) {
         list.append(addn);
     }
-    auto agents = m_components->getProfile()->getAgents();
+    auto agents = getPackProfile()->getProfile()->getAgents();
     for (auto agent : agents) {
         QStringList jar, temp1, temp2, temp3;
         agent->library()->getApplicableFiles(runtimeContext(), jar, temp1, temp2, temp3, getLocalLibraryPath());
@@ -656,7 +660,7 @@ static QString replaceTokensIn(QString text, QMap<QString, QString> with)
 
 QStringList MinecraftInstance::processMinecraftArgs(AuthSessionPtr session, MinecraftTarget::Ptr targetToJoin) const
 {
-    auto profile = m_components->getProfile();
+    auto profile = getPackProfile()->getProfile();
     QString args_pattern = profile->getMinecraftArguments();
     for (auto tweaker : profile->getTweakers()) {
         args_pattern += " --tweakClass " + tweaker;
@@ -719,9 +723,7 @@ QString MinecraftInstance::createLaunchScript(AuthSessionPtr session, MinecraftT
 {
     QString launchScript;
 
-    if (!m_components)
-        return QString();
-    auto profile = m_components->getProfile();
+    auto profile = getPackProfile()->getProfile();
     if (!profile)
         return QString();
 
@@ -799,7 +801,7 @@ QStringList MinecraftInstance::verboseDescription(AuthSessionPtr session, Minecr
     out << "Main Class:" << "  " + getMainClass() << "";
     out << "Native path:" << "  " + getNativePath() << "";
 
-    auto profile = m_components->getProfile();
+    auto profile = getPackProfile()->getProfile();
 
     // traits
     auto alltraits = traits();
@@ -938,44 +940,7 @@ QMap<QString, QString> MinecraftInstance::createCensorFilterFromSession(AuthSess
 
 MessageLevel::Enum MinecraftInstance::guessLevel(const QString& line, MessageLevel::Enum level)
 {
-    QRegularExpression re("\\[(?<timestamp>[0-9:]+)\\] \\[[^/]+/(?<level>[^\\]]+)\\]");
-    auto match = re.match(line);
-    if (match.hasMatch()) {
-        // New style logs from log4j
-        QString timestamp = match.captured("timestamp");
-        QString levelStr = match.captured("level");
-        if (levelStr == "INFO")
-            level = MessageLevel::Message;
-        if (levelStr == "WARN")
-            level = MessageLevel::Warning;
-        if (levelStr == "ERROR")
-            level = MessageLevel::Error;
-        if (levelStr == "FATAL")
-            level = MessageLevel::Fatal;
-        if (levelStr == "TRACE" || levelStr == "DEBUG")
-            level = MessageLevel::Debug;
-    } else {
-        // Old style forge logs
-        if (line.contains("[INFO]") || line.contains("[CONFIG]") || line.contains("[FINE]") || line.contains("[FINER]") ||
-            line.contains("[FINEST]"))
-            level = MessageLevel::Message;
-        if (line.contains("[SEVERE]") || line.contains("[STDERR]"))
-            level = MessageLevel::Error;
-        if (line.contains("[WARNING]"))
-            level = MessageLevel::Warning;
-        if (line.contains("[DEBUG]"))
-            level = MessageLevel::Debug;
-    }
-    if (line.contains("overwriting existing"))
-        return MessageLevel::Fatal;
-    // NOTE: this diverges from the real regexp. no unicode, the first section is + instead of *
-    static const QString javaSymbol = "([a-zA-Z_$][a-zA-Z\\d_$]*\\.)+[a-zA-Z_$][a-zA-Z\\d_$]*";
-    if (line.contains("Exception in thread") || line.contains(QRegularExpression("\\s+at " + javaSymbol)) ||
-        line.contains(QRegularExpression("Caused by: " + javaSymbol)) ||
-        line.contains(QRegularExpression("([a-zA-Z_$][a-zA-Z\\d_$]*\\.)+[a-zA-Z_$]?[a-zA-Z\\d_$]*(Exception|Error|Throwable)")) ||
-        line.contains(QRegularExpression("... \\d+ more$")))
-        return MessageLevel::Error;
-    return level;
+    return MinecraftLogLevel::guess(line, level);
 }
 
 IPathMatcher::Ptr MinecraftInstance::getLogFileMatcher()
@@ -1000,11 +965,11 @@ QString MinecraftInstance::getStatusbarDescription()
         traits.append(tr("broken"));
     }
 
-    QString mcVersion = m_components->getComponentVersion("net.minecraft");
+    QString mcVersion = getPackProfile()->getComponentVersion("net.minecraft");
     if (mcVersion.isEmpty()) {
         // Load component info if needed
-        m_components->reload(Net::Mode::Offline);
-        mcVersion = m_components->getComponentVersion("net.minecraft");
+        getPackProfile()->reload(Net::Mode::Offline);
+        mcVersion = getPackProfile()->getComponentVersion("net.minecraft");
     }
 
     QString description;
@@ -1242,7 +1207,7 @@ std::shared_ptr<GameOptions> MinecraftInstance::gameOptionsModel()
 
 QList<Mod*> MinecraftInstance::getJarMods() const
 {
-    auto profile = m_components->getProfile();
+    auto profile = getPackProfile()->getProfile();
     QList<Mod*> mods;
     for (auto jarmod : profile->getJarMods()) {
         QStringList jar, temp1, temp2, temp3;
@@ -0,0 +1,182 @@
+#include "MinecraftLogLevel.h"
+
+#include <QLatin1String>
+
+namespace {
+
+// NOTE: these match what \d, \s and java identifiers were in the original patterns: ascii only
+bool isDigit(QChar c)
+{
+    return c.unicode() >= '0' && c.unicode() <= '9';
+}
+
+bool isSpace(QChar c)
+{
+    return c.unicode() == ' ' || (c.unicode() >= '\t' && c.unicode() <= '\r');
+}
+
+bool isIdentifierStart(QChar c)
+{
+    auto u = c.unicode();
+    return (u >= 'a' && u <= 'z') || (u >= 'A' && u <= 'Z') || u == '_' || u == '$';
+}
+
+bool isIdentifierPart(QChar c)
+{
+    return isIdentifierStart(c) || isDigit(c);
+}
+
+qsizetype indexOf(QStringView haystack, QLatin1String needle, qsizetype from = 0)
+{
+    const QChar first = needle.at(0);
+    for (auto i = from; i + needle.size() <= haystack.size(); i++) {
+        if (haystack[i] == first && haystack.mid(i, needle.size()) == needle)
+            return i;
+    }
+    return -1;
+}
+
+bool contains(QStringView haystack, QLatin1String needle)
+{
+    return indexOf(haystack, needle) != -1;
+}
+
+// "[<timestamp>] [<thread>/<level>]", as printed by log4j
+bool findLog4jLevel(QStringView line, QStringView& level)
+{
+    const auto size = line.size();
+    for (qsizetype start = 0; start < size; start++) {
+        if (line[start] != u'[')
+            continue;
+
+        auto i = start + 1;
+        while (i < size && (isDigit(line[i]) || line[i] == u':'))
+            i++;
+        if (i == start + 1 || !line.mid(i).startsWith(QLatin1String("] [")))
+            continue;
+
+        // the thread name runs up to the first slash, and the level up to the next closing bracket
+        i += 3;
+        const auto thread_start = i;
+        while (i < size && line[i] != u'/')
+            i++;
+        if (i == size || i == thread_start)
+            continue;
+
+        const auto level_start = ++i;
+        while (i < size && line[i] != u']')
+            i++;
+        if (i == size || i == level_start)
+            continue;
+
+        level = line.mid(level_start, i - level_start);
+        return true;
+    }
+    return false;
+}
+
+// "<prefix>pkg.Name", a qualified java name right after the prefix
+bool containsQualifiedNameAfter(QStringView line, QLatin1String prefix, bool space_before)
+{
+    const auto size = line.size();
+    for (auto i = indexOf(line, prefix); i != -1; i = indexOf(line, prefix, i + 1)) {
+        if (space_before && (i == 0 || !isSpace(line[i - 1])))
+            continue;
+
+        auto j = i + prefix.size();
+        if (j >= size || !isIdentifierStart(line[j]))
+            continue;
+        while (j < size && isIdentifierPart(line[j]))
+            j++;
+        if (j + 1 < size && line[j] == u'.' && isIdentifierStart(line[j + 1]))
+            return true;
+    }
+    return false;
+}
+
+// "pkg.SomethingException" and the like, anywhere in the line
+bool containsThrowableName(QStringView line)
+{
+    for (auto suffix : { QLatin1String("Exception"), QLatin1String("Error"), QLatin1String("Throwable") }) {
+        for (auto i = indexOf(line, suffix); i != -1; i = indexOf(line, suffix, i + 1)) {
+            // the rest of the class name, then the dot of the package
+            auto dot = i;
+            while (dot > 0 && isIdentifierPart(line[dot - 1]))
+                dot--;
+            if (dot == 0 || line[dot - 1] != u'.')
+                continue;
+            dot--;
+
+            // the package has to be an identifier, not just a number
+            for (auto j = dot; j > 0 && isIdentifierPart(line[j - 1]); j--) {
+                if (isIdentifierStart(line[j - 1]))
+                    return true;
+            }
+        }
+    }
+    return false;
+}
+
+// "... 12 more", the end of a stack trace
+bool endsWithOmittedFrames(QStringView line)
+{
+    // like $, also accept a final line break
+    if (line.endsWith(u'\n'))
+        line.chop(1);
+    if (!line.endsWith(QLatin1String(" more")))
+        return false;
+
+    const auto digits_end = line.size() - 5;
+    auto i = digits_end;
+    while (i > 0 && isDigit(line[i - 1]))
+        i--;
+    if (i == digits_end || i < 4 || line[i - 1] != u' ')
+        return false;
+    for (auto j = i - 4; j < i - 1; j++) {
+        if (line[j] == u'\n')
+            return false;
+    }
+    return true;
+}
+
+}  // namespace
+
+MessageLevel::Enum MinecraftLogLevel::guess(QStringView line, MessageLevel::Enum level)
+{
+    QStringView levelStr;
+    if (findLog4jLevel(line, levelStr)) {
+        // New style logs from log4j
+        if (levelStr == QLatin1String("INFO"))
+            level = MessageLevel::Message;
+        else if (levelStr == QLatin1String("WARN"))
+            level = MessageLevel::Warning;
+        else if (levelStr == QLatin1String("ERROR"))
+            level = MessageLevel::Error;
+        else if (levelStr == QLatin1String("FATAL"))
+            level = MessageLevel::Fatal;
+        else if (levelStr == QLatin1String("TRACE") || levelStr == QLatin1String("DEBUG"))
+            level = MessageLevel::Debug;
+    } else if (contains(line, QLatin1String("["))) {
+        // Old style forge logs, the later checks take precedence
+        if (contains(line, QLatin1String("[DEBUG]")))
+            level = MessageLevel::Debug;
+        else if (contains(line, QLatin1String("[WARNING]")))
+            level = MessageLevel::Warning;
+        else if (contains(line, QLatin1String("[SEVERE]")) || contains(line, QLatin1String("[STDERR]")))
+            level = MessageLevel::Error;
+        else if (contains(line, QLatin1String("[INFO]")) || contains(line, QLatin1String("[CONFIG]")) ||
+                 contains(line, QLatin1String("[FINE]")) || contains(line, QLatin1String("[FINER]")) ||
+                 contains(line, QLatin1String("[FINEST]")))
+            level = MessageLevel::Message;
+    }
+
+    if (contains(line, QLatin1String("overwriting existing")))
+        return MessageLevel::Fatal;
+
+    // NOTE: like the patterns this replaces, java names are ascii only here
+    if (contains(line, QLatin1String("Exception in thread")) || containsQualifiedNameAfter(line, QLatin1String("at "), true) ||
+        containsQualifiedNameAfter(line, QLatin1String("Caused by: "), false) || containsThrowableName(line) ||
+        endsWithOmittedFrames(line))
+        return MessageLevel::Error;
+    return level;
+}
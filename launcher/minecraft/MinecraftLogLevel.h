@@ -0,0 +1,17 @@
+#pragma once
+
+#include <QStringView>
+
+#include "MessageLevel.h"
+
+namespace MinecraftLogLevel {
+
+/**
+ * Guesses the level of a line logged by the game, falling back to `level` when nothing in the line says otherwise.
+ *
+ * This is called for every line the game outputs, so it is a hand written scanner equivalent to the log4j header,
+ * old forge tag and stack trace patterns it recognizes, instead of running regular expressions over each line.
+ */
+MessageLevel::Enum guess(QStringView line, MessageLevel::Enum level);
+
+}  // namespace MinecraftLogLevel
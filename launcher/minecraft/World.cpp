@@ -198,7 +198,7 @@ bool putLevelDatDataToFS(const QFileInfo& file, QByteArray& data)
     return f.commit();
 }
 
-int64_t calculateWorldSize(const QFileInfo& file)
+int64_t World::calculateSize(const QFileInfo& file)
 {
     if (file.isFile() && file.suffix() == "zip") {
         return file.size();
@@ -223,8 +223,9 @@ void World::repath(const QFileInfo& file)
 {
     m_containerFile = file;
     m_folderName = file.fileName();
-    m_size = calculateWorldSize(file);
+    m_size = -1;
     if (file.isFile() && file.suffix() == "zip") {
+        m_size = file.size();
         m_iconFile = QString();
         readFromZip(file);
     } else if (file.isDir()) {
@@ -472,7 +473,6 @@ void World::loadFromLevelDat(QByteArray data)
     if (randomSeed) {
         qDebug() << "Seed:" << *randomSeed;
     }
-    qDebug() << "Size:" << m_size;
     qDebug() << "GameType:" << m_gameType.toLogString();
 }
 
@@ -31,11 +31,16 @@ struct GameType {
 
 class World {
    public:
+    World() = default;
     World(const QFileInfo& file);
     QString folderName() const { return m_folderName; }
     QString name() const { return m_actualName; }
     QString iconFile() const { return m_iconFile; }
+    // size on disk, or -1 if it wasn't calculated yet
     int64_t bytes() const { return m_size; }
+    void setBytes(int64_t size) { m_size = size; }
+    // walks the whole world, so only do this when the size is actually needed, and not on the GUI thread
+    static int64_t calculateSize(const QFileInfo& file);
     QDateTime lastPlayed() const { return m_lastPlayed; }
     GameType gameType() const { return m_gameType; }
     int64_t seed() const { return m_randomSeed; }
@@ -85,7 +90,7 @@ class World {
     QString m_iconFile;
     QDateTime levelDatTime;
     QDateTime m_lastPlayed;
-    int64_t m_size;
+    int64_t m_size = -1;
     int64_t m_randomSeed = 0;
     GameType m_gameType;
     bool is_valid = false;
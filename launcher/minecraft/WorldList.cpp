@@ -40,9 +40,12 @@
 #include <QFileSystemWatcher>
 #include <QMimeData>
 #include <QString>
+#include <QThreadPool>
 #include <QUrl>
 #include <QUuid>
 #include <Qt>
+#include <QtConcurrentMap>
+#include <QtConcurrentRun>
 #include "Application.h"
 
 WorldList::WorldList(const QString& dir, BaseInstance* instance) : QAbstractListModel(), m_instance(instance), m_dir(dir)
@@ -53,6 +56,8 @@ WorldList::WorldList(const QString& dir, BaseInstance* instance) : QAbstractList
     m_watcher = new QFileSystemWatcher(this);
     is_watching = false;
     connect(m_watcher, &QFileSystemWatcher::directoryChanged, this, &WorldList::directoryChanged);
+    connect(&m_scanWatcher, &QFutureWatcherBase::resultsReadyAt, this, &WorldList::scanResultsReady);
+    connect(&m_scanWatcher, &QFutureWatcherBase::finished, this, &WorldList::scanFinished);
 }
 
 void WorldList::startWatching()
@@ -87,23 +92,121 @@ bool WorldList::update()
     if (!isValid())
         return false;
 
-    QList<World> newWorlds;
+    if (m_scanning) {
+        m_rescanPending = true;
+        return true;
+    }
+
+    QList<QFileInfo> entries;
     m_dir.refresh();
-    auto folderContents = m_dir.entryInfoList();
-    // if there are any untracked files...
-    for (QFileInfo entry : folderContents) {
-        if (!entry.isDir())
+    for (QFileInfo entry : m_dir.entryInfoList()) {
+        if (entry.isDir())
+            entries.append(entry);
+    }
+
+    // parsing level.dat of every world can take a while, so only do it for the worlds that changed, and not on the GUI thread
+    std::function<ScannedWorld(const QFileInfo&)> scan = [cache = m_scanCache](const QFileInfo& entry) {
+        ScannedWorld scanned;
+        scanned.folder_time = entry.lastModified().toMSecsSinceEpoch();
+        scanned.level_dat_time = QFileInfo(FS::PathCombine(entry.absoluteFilePath(), "level.dat")).lastModified().toMSecsSinceEpoch();
+
+        auto cached = cache.constFind(entry.fileName());
+        if (cached != cache.constEnd() && cached->folder_time == scanned.folder_time && cached->level_dat_time == scanned.level_dat_time) {
+            return *cached;
+        }
+        scanned.world = World(entry);
+        return scanned;
+    };
+
+    m_scanning = true;
+    m_progressive = worlds.isEmpty();
+    m_scanWatcher.setFuture(QtConcurrent::mapped(entries, scan));
+    return true;
+}
+
+void WorldList::waitForUpdate()
+{
+    while (m_scanning) {
+        m_scanWatcher.waitForFinished();
+        scanFinished();
+    }
+}
+
+void WorldList::scanResultsReady(int begin, int end)
+{
+    if (!m_scanning || !m_progressive)
+        return;
+
+    for (int i = begin; i < end; i++) {
+        auto scanned = m_scanWatcher.resultAt(i);
+        if (!scanned.world.isValid())
             continue;
+        beginInsertRows(QModelIndex(), worlds.size(), worlds.size());
+        worlds.append(scanned.world);
+        endInsertRows();
+    }
+}
 
-        World w(entry);
-        if (w.isValid()) {
-            newWorlds.append(w);
+void WorldList::scanFinished()
+{
+    if (!m_scanning)
+        return;
+    m_scanning = false;
+
+    QHash<QString, ScannedWorld> cache;
+    QList<World> newWorlds;
+    for (auto& scanned : m_scanWatcher.future().results()) {
+        cache.insert(scanned.world.folderName(), scanned);
+        if (scanned.world.isValid())
+            newWorlds.append(scanned.world);
+    }
+    m_scanCache.swap(cache);
+
+    // the rows are already there, unless some results were never reported on the way
+    if (!m_progressive || worlds.size() != newWorlds.size()) {
+        beginResetModel();
+        worlds.swap(newWorlds);
+        endResetModel();
+    }
+
+    if (m_rescanPending) {
+        m_rescanPending = false;
+        update();
+    }
+}
+
+void WorldList::requestSize(int row)
+{
+    auto& world = worlds[row];
+    auto folderName = world.folderName();
+    if (world.bytes() >= 0 || m_pendingSizes.contains(folderName))
+        return;
+    m_pendingSizes.insert(folderName);
+
+    auto watcher = new QFutureWatcher<int64_t>(this);
+    connect(watcher, &QFutureWatcherBase::finished, this, [this, watcher, folderName] {
+        sizeCalculated(folderName, watcher->result());
+        watcher->deleteLater();
+    });
+    watcher->setFuture(
+        QtConcurrent::run(QThreadPool::globalInstance(), [file = world.container()] { return World::calculateSize(file); }));
+}
+
+void WorldList::sizeCalculated(const QString& folderName, int64_t size)
+{
+    m_pendingSizes.remove(folderName);
+
+    auto cached = m_scanCache.find(folderName);
+    if (cached != m_scanCache.end())
+        cached->world.setBytes(size);
+
+    for (int row = 0; row < worlds.size(); row++) {
+        if (worlds[row].folderName() == folderName) {
+            worlds[row].setBytes(size);
+            emit dataChanged(index(row, SizeColumn), index(row, SizeColumn));
+            break;
         }
     }
-    beginResetModel();
-    worlds.swap(newWorlds);
-    endResetModel();
-    return true;
 }
 
 void WorldList::directoryChanged(QString path)
@@ -193,6 +296,11 @@ QVariant WorldList::data(const QModelIndex& index, int role) const
                     return world.lastPlayed();
 
                 case SizeColumn:
+                    // only the sizes that are actually shown get calculated
+                    if (world.bytes() < 0) {
+                        const_cast<WorldList*>(this)->requestSize(row);
+                        return tr("Calculating...");
+                    }
                     return locale.formattedDataSize(world.bytes());
 
                 case InfoColumn:
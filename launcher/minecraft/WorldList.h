@@ -17,8 +17,11 @@
 
 #include <QAbstractListModel>
 #include <QDir>
+#include <QFutureWatcher>
+#include <QHash>
 #include <QList>
 #include <QMimeData>
+#include <QSet>
 #include <QString>
 #include "BaseInstance.h"
 #include "minecraft/World.h"
@@ -44,9 +47,12 @@ class WorldList : public QAbstractListModel {
     bool empty() const { return size() == 0; }
     World& operator[](size_t index) { return worlds[index]; }
 
-    /// Reloads the mod list and returns true if the list changed.
+    /// Rescans the worlds folder in the background and returns false if it can't be read.
     virtual bool update();
 
+    /// Blocks until the running scan, if any, is done and its worlds are in the list.
+    void waitForUpdate();
+
     /// Install a world from location
     void installWorld(QFileInfo filename);
 
@@ -86,14 +92,36 @@ class WorldList : public QAbstractListModel {
 
    private slots:
     void directoryChanged(QString path);
+    void scanResultsReady(int begin, int end);
+    void scanFinished();
 
    signals:
     void changed();
 
+   private:
+    struct ScannedWorld {
+        World world;
+        // the folder changes when files are added or removed at its top level, level.dat whenever the game saves the world
+        qint64 folder_time = 0;
+        qint64 level_dat_time = 0;
+    };
+
+    void requestSize(int row);
+    void sizeCalculated(const QString& folderName, int64_t size);
+
    protected:
     BaseInstance* m_instance;
     QFileSystemWatcher* m_watcher;
     bool is_watching;
     QDir m_dir;
     QList<World> worlds;
+
+    QFutureWatcher<ScannedWorld> m_scanWatcher;
+    bool m_scanning = false;
+    bool m_rescanPending = false;
+    // rows show up as they are scanned when the list starts out empty, otherwise it's swapped once the scan is done
+    bool m_progressive = false;
+    // by folder name, to only read level.dat again for the worlds that changed
+    QHash<QString, ScannedWorld> m_scanCache;
+    QSet<QString> m_pendingSizes;
 };
@@ -20,8 +20,15 @@
 #include <quazip/quazip.h>
 #include <quazip/quazipdir.h>
 #include <QDir>
+#include <QDirIterator>
+#include <QSysInfo>
+#include <QUuid>
+#include <QtConcurrentMap>
+#include <functional>
+#include "Application.h"
 #include "FileSystem.h"
 #include "MMCZip.h"
+#include "net/HttpMetaCache.h"
 
 #ifdef major
 #undef major
@@ -67,6 +74,43 @@ static bool unzipNatives(QString source, QString targetFolder, bool applyJnilibH
     return true;
 }
 
+/**
+ * Makes sure the contents of the jar are in the natives cache, returning the folder they are in.
+ *
+ * Entries are named after the hash of the jar and everything else that changes what gets extracted, so they never need
+ * to be invalidated. They are extracted to a temporary folder and renamed into place, so a folder that exists is complete.
+ */
+static QString extractToCache(const QString& source, const QString& cacheRoot, FileDigestCache& digests, bool applyJnilibHack)
+{
+    auto hash = digests.digest(source, QCryptographicHash::Sha1);
+    if (hash.isEmpty()) {
+        return {};
+    }
+
+    auto key = QString("%1-%2-%3").arg(QString::fromLatin1(hash), QSysInfo::kernelType(), QSysInfo::currentCpuArchitecture());
+    if (applyJnilibHack) {
+        key += "-jnilib";
+    }
+    auto entry = FS::PathCombine(cacheRoot, key);
+    if (QFileInfo(entry).isDir()) {
+        return entry;
+    }
+
+    auto staging = entry + ".part-" + QUuid::createUuid().toString(QUuid::WithoutBraces);
+    if (!FS::ensureFolderPathExists(staging) || !unzipNatives(source, staging, applyJnilibHack)) {
+        FS::deletePath(staging);
+        return {};
+    }
+    if (!QDir().rename(staging, entry)) {
+        // somebody else (another launch) got there first, theirs is just as good
+        FS::deletePath(staging);
+        if (!QFileInfo(entry).isDir()) {
+            return {};
+        }
+    }
+    return entry;
+}
+
 void ExtractNatives::executeTask()
 {
     auto instance = m_parent->instance();
@@ -75,17 +119,50 @@ void ExtractNatives::executeTask()
         emitSucceeded();
         return;
     }
-    auto settings = instance->settings();
 
-    auto outputPath = instance->getNativePath();
-    FS::ensureFolderPathExists(outputPath);
+    m_output_path = instance->getNativePath();
+    FS::ensureFolderPathExists(m_output_path);
     auto javaVersion = instance->getJavaVersion();
     bool jniHackEnabled = javaVersion.major() >= 8;
-    for (const auto& source : toExtract) {
-        if (!unzipNatives(source, outputPath, jniHackEnabled)) {
+
+    auto cacheRoot = APPLICATION->metacache()->getBasePath("natives");
+    FS::ensureFolderPathExists(cacheRoot);
+    m_digests = std::make_shared<FileDigestCache>(FS::PathCombine(cacheRoot, "digests.bin"));
+    m_digests->load();
+
+    // only the jars that aren't in the cache yet get extracted, and those in parallel
+    // NOTE: std::function, Qt 5 can't deduce the result type of a lambda here
+    std::function<Result(const QString&)> extract = [cacheRoot, digests = m_digests, jniHackEnabled](const QString& source) {
+        return Result{ source, extractToCache(source, cacheRoot, *digests, jniHackEnabled) };
+    };
+    m_future = QtConcurrent::mapped(toExtract, extract);
+    connect(&m_watcher, &QFutureWatcher<Result>::finished, this, &ExtractNatives::finish);
+    m_watcher.setFuture(m_future);
+}
+
+void ExtractNatives::finish()
+{
+    m_digests->save();
+
+    auto results = m_future.results();
+    // the natives are never written to, so they can share their data with the cache
+    auto mode = FS::bestShareMode(APPLICATION->metacache()->getBasePath("natives"), m_output_path);
+    // in order, so files present in several jars end up like they did when extracting them one after another
+    for (const auto& result : results) {
+        bool ok = !result.extracted.isEmpty();
+        QDir entry(result.extracted);
+        QDirIterator it(result.extracted, QDir::Files | QDir::Hidden, QDirIterator::Subdirectories);
+        while (ok && it.hasNext()) {
+            auto path = it.next();
+            auto target = FS::PathCombine(m_output_path, entry.relativeFilePath(path));
+            ok = FS::ensureFilePathExists(target) && FS::shareFile(path, target, mode);
+        }
+
+        if (!ok) {
             const char* reason = QT_TR_NOOP("Couldn't extract native jar '%1' to destination '%2'");
-            emit logLine(QString(reason).arg(source, outputPath), MessageLevel::Fatal);
-            emitFailed(tr(reason).arg(source, outputPath));
+            emit logLine(QString(reason).arg(result.source, m_output_path), MessageLevel::Fatal);
+            emitFailed(tr(reason).arg(result.source, m_output_path));
+            return;
         }
     }
     emitSucceeded();
@@ -17,6 +17,12 @@
 
 #include <launch/LaunchStep.h>
 
+#include <QFuture>
+#include <QFutureWatcher>
+#include <memory>
+
+#include "FileDigestCache.h"
+
 // FIXME: temporary wrapper for existing task.
 class ExtractNatives : public LaunchStep {
     Q_OBJECT
@@ -27,4 +33,19 @@ class ExtractNatives : public LaunchStep {
     void executeTask() override;
     bool canAbort() const override { return false; }
     void finalize() override;
+
+    struct Result {
+        QString source;
+        // folder of the natives cache holding the extracted jar, empty when extracting it failed
+        QString extracted;
+    };
+
+   private:
+    void finish();
+
+   private:
+    QString m_output_path;
+    std::shared_ptr<FileDigestCache> m_digests;
+    QFuture<Result> m_future;
+    QFutureWatcher<Result> m_watcher;
 };
@@ -34,59 +34,119 @@
  */
 
 #include "ModMinecraftJar.h"
+#include <QCryptographicHash>
+#include <QDateTime>
 #include "FileSystem.h"
 #include "MMCZip.h"
 #include "launch/LaunchTask.h"
 #include "minecraft/MinecraftInstance.h"
 #include "minecraft/PackProfile.h"
 
+/**
+ * Describes everything the modded jar is built from: the vanilla jar and the enabled jar mods, in order.
+ * If none of them changed (path, size and modification time), the jar built last time can be launched again.
+ */
+static QByteArray jarFingerprint(const QString& sourceJarPath, const QList<Mod*>& jarMods)
+{
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    auto addFile = [&hash](const QFileInfo& file) {
+        hash.addData(file.absoluteFilePath().toUtf8());
+        hash.addData(QByteArray::number(file.size()));
+        hash.addData(QByteArray::number(file.lastModified().toMSecsSinceEpoch()));
+        hash.addData(QByteArray("\n"));
+    };
+
+    addFile(QFileInfo(sourceJarPath));
+    for (auto mod : jarMods) {
+        if (!mod->enabled())
+            continue;
+        addFile(mod->fileinfo());
+        // jar mods can be folders, which don't change their modification time along with their contents
+        if (mod->type() == ResourceType::FOLDER)
+            hash.addData(QByteArray::number(QDateTime::currentMSecsSinceEpoch()));
+    }
+    return hash.result().toHex();
+}
+
 void ModMinecraftJar::executeTask()
 {
     auto m_inst = m_parent->instance();
 
-    if (!m_inst->getJarMods().size()) {
+    auto jarMods = m_inst->getJarMods();
+    if (!jarMods.size()) {
+        // nuke obsolete modded jar if needed
+        if (!removeJar()) {
+            qWarning() << "Couldn't remove the modded minecraft.jar left over from launches with jar mods";
+        }
         emitSucceeded();
         return;
     }
-    // nuke obsolete stripped jar(s) if needed
+
     if (!FS::ensureFolderPathExists(m_inst->binRoot())) {
+        qDeleteAll(jarMods);
         emitFailed(tr("Couldn't create the bin folder for Minecraft.jar"));
+        return;
     }
 
     auto finalJarPath = QDir(m_inst->binRoot()).absoluteFilePath("minecraft.jar");
-    if (!removeJar()) {
-        emitFailed(tr("Couldn't remove stale jar file: %1").arg(finalJarPath));
-    }
+    auto fingerprintPath = finalJarPath + ".fingerprint";
 
-    // create temporary modded jar, if needed
     auto components = m_inst->getPackProfile();
     auto profile = components->getProfile();
-    auto jarMods = m_inst->getJarMods();
-    if (jarMods.size()) {
-        auto mainJar = profile->getMainJar();
-        QStringList jars, temp1, temp2, temp3, temp4;
-        mainJar->getApplicableFiles(m_inst->runtimeContext(), jars, temp1, temp2, temp3, m_inst->getLocalLibraryPath());
-        auto sourceJarPath = jars[0];
-        if (!MMCZip::createModdedJar(sourceJarPath, finalJarPath, jarMods)) {
-            emitFailed(tr("Failed to create the custom Minecraft jar file."));
-            return;
+    auto mainJar = profile->getMainJar();
+    QStringList jars, temp1, temp2, temp3, temp4;
+    mainJar->getApplicableFiles(m_inst->runtimeContext(), jars, temp1, temp2, temp3, m_inst->getLocalLibraryPath());
+    auto sourceJarPath = jars[0];
+
+    auto fingerprint = jarFingerprint(sourceJarPath, jarMods);
+    if (QFileInfo(finalJarPath).isFile() && QFileInfo(fingerprintPath).isFile()) {
+        try {
+            if (FS::read(fingerprintPath) == fingerprint) {
+                qDebug() << "Reusing the modded minecraft.jar, the jar mods didn't change since it was built";
+                qDeleteAll(jarMods);
+                emitSucceeded();
+                return;
+            }
+        } catch (const Exception& e) {
+            qWarning() << "Couldn't read the fingerprint of the modded minecraft.jar:" << e.what();
         }
     }
+
+    if (!removeJar()) {
+        qDeleteAll(jarMods);
+        emitFailed(tr("Couldn't remove stale jar file: %1").arg(finalJarPath));
+        return;
+    }
+
+    bool built = MMCZip::createModdedJar(sourceJarPath, finalJarPath, jarMods);
+    qDeleteAll(jarMods);
+    if (!built) {
+        emitFailed(tr("Failed to create the custom Minecraft jar file."));
+        return;
+    }
+
+    try {
+        FS::write(fingerprintPath, fingerprint);
+    } catch (const Exception& e) {
+        // not fatal, the jar just gets built again next time
+        qWarning() << "Couldn't save the fingerprint of the modded minecraft.jar:" << e.what();
+    }
     emitSucceeded();
 }
 
 void ModMinecraftJar::finalize()
 {
-    removeJar();
+    // the modded jar is kept around, so the next launch can reuse it if the jar mods didn't change
 }
 
 bool ModMinecraftJar::removeJar()
 {
     auto m_inst = m_parent->instance();
     auto finalJarPath = QDir(m_inst->binRoot()).absoluteFilePath("minecraft.jar");
-    QFile finalJar(finalJarPath);
-    if (finalJar.exists()) {
-        if (!finalJar.remove()) {
+    // drop the fingerprint first, a jar without one is never reused
+    for (auto path : { finalJarPath + ".fingerprint", finalJarPath }) {
+        QFile file(path);
+        if (file.exists() && !file.remove()) {
             return false;
         }
     }
@@ -19,6 +19,8 @@
 #include "minecraft/MinecraftInstance.h"
 #include "minecraft/PackProfile.h"
 
+#include <QtConcurrent>
+
 void ReconstructAssets::executeTask()
 {
     auto instance = m_parent->instance();
@@ -26,7 +28,15 @@ void ReconstructAssets::executeTask()
     auto profile = components->getProfile();
     auto assets = profile->getMinecraftAssets();
 
-    if (!AssetsUtils::reconstructAssets(assets->id, instance->resourcesDir())) {
+    // links or copies thousands of files for old versions, keep it off the GUI thread
+    m_future = QtConcurrent::run(QThreadPool::globalInstance(), AssetsUtils::reconstructAssets, assets->id, instance->resourcesDir());
+    connect(&m_watcher, &QFutureWatcher<bool>::finished, this, &ReconstructAssets::finish);
+    m_watcher.setFuture(m_future);
+}
+
+void ReconstructAssets::finish()
+{
+    if (!m_future.result()) {
         emit logLine("Failed to reconstruct Minecraft assets.", MessageLevel::Error);
     }
 
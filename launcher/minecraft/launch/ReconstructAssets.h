@@ -16,6 +16,9 @@
 #pragma once
 
 #include <launch/LaunchStep.h>
+
+#include <QFuture>
+#include <QFutureWatcher>
 #include <memory>
 
 class ReconstructAssets : public LaunchStep {
@@ -26,4 +29,11 @@ class ReconstructAssets : public LaunchStep {
 
     void executeTask() override;
     bool canAbort() const override { return false; }
+
+   private:
+    void finish();
+
+   private:
+    QFuture<bool> m_future;
+    QFutureWatcher<bool> m_watcher;
 };
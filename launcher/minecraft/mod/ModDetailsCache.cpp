@@ -0,0 +1,187 @@
+// SPDX-License-Identifier: GPL-3.0-only
+/*
+ *  Prism Launcher - Minecraft Launcher
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, version 3.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "ModDetailsCache.h"
+
+#include <QBuffer>
+#include <QDataStream>
+#include <QDateTime>
+#include <QDebug>
+#include <QFile>
+
+#include "FileSystem.h"
+
+namespace {
+const quint32 s_cache_magic = 0x504d4443;  // "PMDC"
+// bump when ModDetails gains fields, old caches are then simply dropped
+const quint32 s_cache_version = 1;
+// the least an entry takes up in the cache: its path, stamp, nine fields of the details, the licenses and the icon
+const qint64 s_min_entry_size = 4 + 2 * 8 + 9 * 4 + 4 + 4;
+
+void writeDetails(QDataStream& out, const ModDetails& details)
+{
+    out << details.mod_id << details.name << details.version << details.mcversion << details.homeurl << details.description
+        << details.authors << details.issue_tracker << details.icon_file;
+    out << quint32(details.licenses.size());
+    for (auto& license : details.licenses)
+        out << license.name << license.id << license.url << license.description;
+}
+
+void readDetails(QDataStream& in, ModDetails& details)
+{
+    in >> details.mod_id >> details.name >> details.version >> details.mcversion >> details.homeurl >> details.description >>
+        details.authors >> details.issue_tracker >> details.icon_file;
+    quint32 license_count = 0;
+    in >> license_count;
+    for (quint32 i = 0; i < license_count && in.status() == QDataStream::Ok; i++) {
+        ModLicense license;
+        in >> license.name >> license.id >> license.url >> license.description;
+        details.licenses.append(license);
+    }
+}
+}  // namespace
+
+ModDetailsCache::ModDetailsCache(QString cache_file) : m_cache_file(cache_file) {}
+
+bool ModDetailsCache::find(const QFileInfo& file, ModDetails& details, QImage& icon)
+{
+    QMutexLocker locker(&m_lock);
+    ensureLoaded();
+
+    auto it = m_entries.find(file.absoluteFilePath());
+    if (it == m_entries.end())
+        return false;
+
+    if (it->size != file.size() || it->mtime != file.lastModified().toUTC().toMSecsSinceEpoch()) {
+        m_entries.erase(it);
+        m_dirty = true;
+        return false;
+    }
+
+    it->used = true;
+    details = it->details;
+    if (!it->icon_png.isEmpty())
+        icon.loadFromData(it->icon_png, "PNG");
+    return true;
+}
+
+void ModDetailsCache::insert(const QFileInfo& file, const ModDetails& details, const QImage& icon)
+{
+    Entry entry;
+    entry.size = file.size();
+    entry.mtime = file.lastModified().toUTC().toMSecsSinceEpoch();
+    entry.details = details;
+    entry.used = true;
+    if (!icon.isNull()) {
+        QBuffer buffer(&entry.icon_png);
+        buffer.open(QIODevice::WriteOnly);
+        icon.save(&buffer, "PNG");
+    }
+
+    QMutexLocker locker(&m_lock);
+    ensureLoaded();
+    m_entries.insert(file.absoluteFilePath(), entry);
+    m_dirty = true;
+}
+
+void ModDetailsCache::ensureLoaded()
+{
+    if (m_loaded)
+        return;
+    m_loaded = true;
+
+    if (m_cache_file.isEmpty())
+        return;
+
+    QFile cache(m_cache_file);
+    if (!cache.open(QIODevice::ReadOnly))
+        return;
+
+    QDataStream in(&cache);
+    in.setVersion(QDataStream::Qt_5_12);
+
+    quint32 magic, version, count;
+    in >> magic >> version >> count;
+    if (in.status() != QDataStream::Ok || magic != s_cache_magic || version != s_cache_version) {
+        qDebug() << "Ignoring outdated mod details cache" << m_cache_file;
+        return;
+    }
+    // don't allocate for more entries than the rest of the file can hold, the count may be garbage
+    if (count > cache.bytesAvailable() / s_min_entry_size) {
+        qWarning() << "Mod details cache" << m_cache_file << "is corrupted, ignoring it";
+        return;
+    }
+
+    QHash<QString, Entry> entries;
+    entries.reserve(count);
+    for (quint32 i = 0; i < count && in.status() == QDataStream::Ok; i++) {
+        QString path;
+        Entry entry;
+        in >> path >> entry.size >> entry.mtime;
+        readDetails(in, entry.details);
+        in >> entry.icon_png;
+        entries.insert(path, entry);
+    }
+
+    if (in.status() != QDataStream::Ok) {
+        qWarning() << "Mod details cache" << m_cache_file << "is corrupted, ignoring it";
+        return;
+    }
+
+    m_entries = entries;
+}
+
+void ModDetailsCache::save()
+{
+    QByteArray data;
+    {
+        QMutexLocker locker(&m_lock);
+        if (m_cache_file.isEmpty() || !m_loaded)
+            return;
+
+        // forget about mods that are gone. Unchanged mods aren't parsed again when the folder is updated, so only
+        // the ones that weren't looked up since the last save are checked.
+        for (auto it = m_entries.begin(); it != m_entries.end();) {
+            if (!it->used && !QFileInfo(it.key()).isFile()) {
+                it = m_entries.erase(it);
+                m_dirty = true;
+            } else {
+                it->used = false;
+                ++it;
+            }
+        }
+
+        if (!m_dirty)
+            return;
+
+        QDataStream out(&data, QIODevice::WriteOnly);
+        out.setVersion(QDataStream::Qt_5_12);
+        out << s_cache_magic << s_cache_version << quint32(m_entries.size());
+        for (auto it = m_entries.constBegin(); it != m_entries.constEnd(); ++it) {
+            out << it.key() << it->size << it->mtime;
+            writeDetails(out, it->details);
+            out << it->icon_png;
+        }
+        m_dirty = false;
+    }
+
+    try {
+        FS::write(m_cache_file, data);
+    } catch (const Exception& e) {
+        qWarning() << "Failed to write mod details cache:" << e.what();
+    }
+}
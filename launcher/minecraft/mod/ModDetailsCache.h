@@ -0,0 +1,69 @@
+// SPDX-License-Identifier: GPL-3.0-only
+/*
+ *  Prism Launcher - Minecraft Launcher
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, version 3.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <QFileInfo>
+#include <QHash>
+#include <QImage>
+#include <QMutex>
+#include <QString>
+
+#include <memory>
+
+#include "minecraft/mod/ModDetails.h"
+
+/**
+ * Persistent cache of the details parsed out of the mods in a folder, and their icon thumbnails.
+ *
+ * Entries are keyed by the path of the mod and only valid while its size and modification time don't change,
+ * so unchanged mods can be listed without opening their jars at all. Folder mods aren't cached, as changing the
+ * files inside a folder doesn't change the folder itself.
+ *
+ * All the methods are thread-safe, since parse tasks run in the background.
+ */
+class ModDetailsCache {
+   public:
+    using Ptr = std::shared_ptr<ModDetailsCache>;
+
+    // supply path to the cache file, or nothing for an in-memory only cache
+    explicit ModDetailsCache(QString cache_file = QString());
+
+    /** Fills in the details (and icon, if any) of the mod, if they are cached and still up to date. */
+    bool find(const QFileInfo& file, ModDetails& details, QImage& icon);
+    void insert(const QFileInfo& file, const ModDetails& details, const QImage& icon);
+
+    /** Writes the cache back, dropping the entries of mods that are gone. */
+    void save();
+
+   private:
+    struct Entry {
+        qint64 size = -1;
+        qint64 mtime = 0;
+        ModDetails details;
+        QByteArray icon_png;
+        bool used = false;
+    };
+
+    void ensureLoaded();
+
+    QString m_cache_file;
+    QHash<QString, Entry> m_entries;
+    bool m_loaded = false;
+    bool m_dirty = false;
+    QMutex m_lock;
+};
@@ -76,6 +76,16 @@ ModFolderModel::ModFolderModel(const QString& dir, BaseInstance* instance, bool
                               QHeaderView::Interactive, QHeaderView::Interactive, QHeaderView::Interactive };
     m_columnsHideable = { false, true, false, true, true, true, true, true, true, true, true };
     m_columnsHiddenByDefault = { false, false, false, false, false, false, false, true, true, true, true };
+
+    // keep the parsed details of unchanged mods around, so listing them doesn't have to open every jar again
+    QString cache_file;
+    if (instance)
+        cache_file = FS::PathCombine(instance->instanceRoot(), ".cache", QString("%1.details").arg(m_dir.dirName()));
+    m_details_cache = std::make_shared<ModDetailsCache>(cache_file);
+    connect(this, &ResourceFolderModel::parseFinished, this, [this] {
+        if (!hasPendingParseTasks())
+            m_details_cache->save();
+    });
 }
 
 QVariant ModFolderModel::data(const QModelIndex& index, int role) const
@@ -245,7 +255,7 @@ Task* ModFolderModel::createUpdateTask()
 
 Task* ModFolderModel::createParseTask(Resource& resource)
 {
-    return new LocalModParseTask(m_next_resolution_ticket, resource.type(), resource.fileinfo());
+    return new LocalModParseTask(m_next_resolution_ticket, resource.type(), resource.fileinfo(), m_details_cache);
 }
 
 bool ModFolderModel::uninstallMod(const QString& filename, bool preserve_metadata)
@@ -378,8 +388,11 @@ void ModFolderModel::onParseSucceeded(int ticket, QString mod_id)
     auto resource = find(mod_id);
 
     auto result = cast_task->result();
-    if (result && resource)
+    if (result && resource) {
         resource->finishResolvingWithDetails(std::move(result->details));
+        if (!result->icon.isNull())
+            resource->setIcon(result->icon);
+    }
 
     emit dataChanged(index(row), index(row, columnCount(QModelIndex()) - 1));
 }
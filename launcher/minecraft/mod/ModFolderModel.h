@@ -47,6 +47,7 @@
 #include "Mod.h"
 #include "ResourceFolderModel.h"
 
+#include "minecraft/mod/ModDetailsCache.h"
 #include "minecraft/mod/tasks/LocalModParseTask.h"
 #include "minecraft/mod/tasks/ModFolderLoadTask.h"
 #include "modplatform/ModIndex.h"
@@ -116,4 +117,5 @@ class ModFolderModel : public ResourceFolderModel {
    protected:
     bool m_is_indexed;
     bool m_first_folder_load = true;
+    ModDetailsCache::Ptr m_details_cache;
 };
@@ -12,6 +12,7 @@
 
 #include "FileSystem.h"
 #include "Json.h"
+#include "MMCZip.h"
 #include "minecraft/mod/ModDetails.h"
 #include "settings/INIFile.h"
 
@@ -459,113 +460,79 @@ bool process(Mod& mod, ProcessingLevel level)
     }
 }
 
-bool processZIP(Mod& mod, [[maybe_unused]] ProcessingLevel level)
+bool processZIP(Mod& mod, ProcessingLevel level)
 {
-    ModDetails details;
+    MMCZip::ArchiveIndex archive(mod.fileinfo().filePath());
+    return processZIP(mod, archive, level);
+}
 
-    QuaZip zip(mod.fileinfo().filePath());
-    if (!zip.open(QuaZip::mdUnzip))
+bool processZIP(Mod& mod, MMCZip::ArchiveIndex& archive, [[maybe_unused]] ProcessingLevel level)
+{
+    if (!archive.isOpen())
         return false;
 
-    QuaZipFile file(&zip);
+    auto readEntry = [&archive, &mod](const QString& name, ModDetails (*reader)(QByteArray)) {
+        auto data = archive.read(name);
+        if (!data)
+            return false;
+        mod.setDetails(reader(*data));
+        return true;
+    };
 
-    if (zip.setCurrentFile("META-INF/mods.toml") || zip.setCurrentFile("META-INF/neoforge.mods.toml")) {
-        if (!file.open(QIODevice::ReadOnly)) {
-            zip.close();
+    QString mods_toml;
+    if (archive.contains("META-INF/mods.toml"))
+        mods_toml = "META-INF/mods.toml";
+    else if (archive.contains("META-INF/neoforge.mods.toml"))
+        mods_toml = "META-INF/neoforge.mods.toml";
+
+    if (!mods_toml.isEmpty()) {
+        auto data = archive.read(mods_toml);
+        if (!data)
             return false;
-        }
 
-        details = ReadMCModTOML(file.readAll());
-        file.close();
+        auto details = ReadMCModTOML(*data);
 
         // to replace ${file.jarVersion} with the actual version, as needed
-        if (details.version == "${file.jarVersion}") {
-            if (zip.setCurrentFile("META-INF/MANIFEST.MF")) {
-                if (!file.open(QIODevice::ReadOnly)) {
-                    zip.close();
-                    return false;
-                }
-
-                // quick and dirty line-by-line parser
-                auto manifestLines = file.readAll().split('\n');
-                QString manifestVersion = "";
-                for (auto& line : manifestLines) {
-                    if (QString(line).startsWith("Implementation-Version: ")) {
-                        manifestVersion = QString(line).remove("Implementation-Version: ");
-                        break;
-                    }
-                }
+        if (details.version == "${file.jarVersion}" && archive.contains("META-INF/MANIFEST.MF")) {
+            auto manifest = archive.read("META-INF/MANIFEST.MF");
+            if (!manifest)
+                return false;
 
-                // some mods use ${projectversion} in their build.gradle, causing this mess to show up in MANIFEST.MF
-                // also keep with forge's behavior of setting the version to "NONE" if none is found
-                if (manifestVersion.contains("task ':jar' property 'archiveVersion'") || manifestVersion == "") {
-                    manifestVersion = "NONE";
+            // quick and dirty line-by-line parser
+            auto manifestLines = manifest->split('\n');
+            QString manifestVersion = "";
+            for (auto& line : manifestLines) {
+                if (QString(line).startsWith("Implementation-Version: ")) {
+                    manifestVersion = QString(line).remove("Implementation-Version: ");
+                    break;
                 }
-
-                details.version = manifestVersion;
-
-                file.close();
             }
-        }
-
-        zip.close();
-        mod.setDetails(details);
-
-        return true;
-    } else if (zip.setCurrentFile("mcmod.info")) {
-        if (!file.open(QIODevice::ReadOnly)) {
-            zip.close();
-            return false;
-        }
 
-        details = ReadMCModInfo(file.readAll());
-        file.close();
-        zip.close();
-
-        mod.setDetails(details);
-        return true;
-    } else if (zip.setCurrentFile("quilt.mod.json")) {
-        if (!file.open(QIODevice::ReadOnly)) {
-            zip.close();
-            return false;
-        }
-
-        details = ReadQuiltModInfo(file.readAll());
-        file.close();
-        zip.close();
-
-        mod.setDetails(details);
-        return true;
-    } else if (zip.setCurrentFile("fabric.mod.json")) {
-        if (!file.open(QIODevice::ReadOnly)) {
-            zip.close();
-            return false;
-        }
-
-        details = ReadFabricModInfo(file.readAll());
-        file.close();
-        zip.close();
+            // some mods use ${projectversion} in their build.gradle, causing this mess to show up in MANIFEST.MF
+            // also keep with forge's behavior of setting the version to "NONE" if none is found
+            if (manifestVersion.contains("task ':jar' property 'archiveVersion'") || manifestVersion == "") {
+                manifestVersion = "NONE";
+            }
 
-        mod.setDetails(details);
-        return true;
-    } else if (zip.setCurrentFile("forgeversion.properties")) {
-        if (!file.open(QIODevice::ReadOnly)) {
-            zip.close();
-            return false;
+            details.version = manifestVersion;
         }
 
-        details = ReadForgeInfo(file.readAll());
-        file.close();
-        zip.close();
-
         mod.setDetails(details);
         return true;
-    } else if (zip.setCurrentFile("META-INF/nil/mappings.json")) {
+    } else if (archive.contains("mcmod.info")) {
+        return readEntry("mcmod.info", ReadMCModInfo);
+    } else if (archive.contains("quilt.mod.json")) {
+        return readEntry("quilt.mod.json", ReadQuiltModInfo);
+    } else if (archive.contains("fabric.mod.json")) {
+        return readEntry("fabric.mod.json", ReadFabricModInfo);
+    } else if (archive.contains("forgeversion.properties")) {
+        return readEntry("forgeversion.properties", ReadForgeInfo);
+    } else if (archive.contains("META-INF/nil/mappings.json")) {
         // nilloader uses the filename of the metadata file for the modid, so we can't know the exact filename
         // thankfully, there is a good file to use as a canary so we don't look for nil meta all the time
 
         QString foundNilMeta;
-        for (auto& fname : zip.getFileNameList()) {
+        for (auto& fname : archive.entries()) {
             // nilmods can shade nilloader to be able to run as a standalone agent - which includes nilloader's own meta file
             if (fname.endsWith(".nilmod.css") && fname != "nilloader.nilmod.css") {
                 foundNilMeta = fname;
@@ -573,22 +540,16 @@ bool processZIP(Mod& mod, [[maybe_unused]] ProcessingLevel level)
             }
         }
 
-        if (zip.setCurrentFile(foundNilMeta)) {
-            if (!file.open(QIODevice::ReadOnly)) {
-                zip.close();
+        if (!foundNilMeta.isEmpty()) {
+            auto data = archive.read(foundNilMeta);
+            if (!data)
                 return false;
-            }
 
-            details = ReadNilModInfo(file.readAll(), foundNilMeta);
-            file.close();
-            zip.close();
-
-            mod.setDetails(details);
+            mod.setDetails(ReadNilModInfo(*data, foundNilMeta));
             return true;
         }
     }
 
-    zip.close();
     return false;  // no valid mod found in archive
 }
 
@@ -659,79 +620,102 @@ bool processIconPNG(const Mod& mod, QByteArray&& raw_data, QPixmap* pixmap)
     return true;
 }
 
-bool loadIconFile(const Mod& mod, QPixmap* pixmap)
+bool readIconFile(const Mod& mod, QByteArray& data, QString& error, MMCZip::ArchiveIndex* archive)
 {
-    if (mod.iconPath().isEmpty()) {
-        qWarning() << "No Iconfile set, be sure to parse the mod first";
-        return false;
-    }
-
-    auto png_invalid = [&mod](const QString& reason) {
-        qWarning() << "Mod at" << mod.fileinfo().filePath() << "does not have a valid icon:" << reason;
-        return false;
-    };
-
     switch (mod.type()) {
         case ResourceType::FOLDER: {
             QFileInfo icon_info(FS::PathCombine(mod.fileinfo().filePath(), mod.iconPath()));
             if (icon_info.exists() && icon_info.isFile()) {
                 QFile icon(icon_info.filePath());
                 if (!icon.open(QIODevice::ReadOnly)) {
-                    return png_invalid("failed  to open file " + icon_info.filePath());
+                    error = "failed  to open file " + icon_info.filePath();
+                    return false;
                 }
-                auto data = icon.readAll();
-
-                bool icon_result = ModUtils::processIconPNG(mod, std::move(data), pixmap);
-
+                data = icon.readAll();
                 icon.close();
-
-                if (!icon_result) {
-                    return png_invalid("invalid png image");  // icon invalid
-                }
                 return true;
             }
-            return png_invalid("file '" + icon_info.filePath() + "' does not exists or is not a file");
+            error = "file '" + icon_info.filePath() + "' does not exists or is not a file";
+            return false;
         }
         case ResourceType::ZIPFILE: {
-            QuaZip zip(mod.fileinfo().filePath());
-            if (!zip.open(QuaZip::mdUnzip))
-                return png_invalid("failed to open '" + mod.fileinfo().filePath() + "' as a zip archive");
-
-            QuaZipFile file(&zip);
-
-            if (zip.setCurrentFile(mod.iconPath())) {
-                if (!file.open(QIODevice::ReadOnly)) {
-                    qCritical() << "Failed to open file in zip.";
-                    zip.close();
-                    return png_invalid("Failed to open '" + mod.iconPath() + "' in zip archive");
-                }
-
-                auto data = file.readAll();
-
-                bool icon_result = ModUtils::processIconPNG(mod, std::move(data), pixmap);
+            std::optional<MMCZip::ArchiveIndex> own_archive;
+            if (!archive) {
+                own_archive.emplace(mod.fileinfo().filePath());
+                archive = &*own_archive;
+            }
+            if (!archive->isOpen()) {
+                error = "failed to open '" + mod.fileinfo().filePath() + "' as a zip archive";
+                return false;
+            }
+            if (!archive->contains(mod.iconPath())) {
+                error = "'" + mod.iconPath() + "' does not exist in zip archive";
+                return false;
+            }
 
-                file.close();
-                if (!icon_result) {
-                    return png_invalid("invalid png image");  // icon png invalid
-                }
-                return true;
+            auto icon = archive->read(mod.iconPath());
+            if (!icon) {
+                error = "Failed to read '" + mod.iconPath() + "' from zip archive";
+                return false;
             }
-            return png_invalid("Failed to set '" + mod.iconPath() +
-                               "' as current file in zip archive");  // could not set icon as current file.
+            data = std::move(*icon);
+            return true;
         }
         case ResourceType::LITEMOD: {
-            return png_invalid("litemods do not have icons");  // can lightmods even have icons?
+            error = "litemods do not have icons";  // can lightmods even have icons?
+            return false;
         }
         default:
-            return png_invalid("Invalid type for mod, can not load icon.");
+            error = "Invalid type for mod, can not load icon.";
+            return false;
     }
 }
 
+bool loadIconFile(const Mod& mod, QPixmap* pixmap)
+{
+    if (mod.iconPath().isEmpty()) {
+        qWarning() << "No Iconfile set, be sure to parse the mod first";
+        return false;
+    }
+
+    auto png_invalid = [&mod](const QString& reason) {
+        qWarning() << "Mod at" << mod.fileinfo().filePath() << "does not have a valid icon:" << reason;
+        return false;
+    };
+
+    QByteArray data;
+    QString error;
+    if (!readIconFile(mod, data, error))
+        return png_invalid(error);
+
+    if (!ModUtils::processIconPNG(mod, std::move(data), pixmap))
+        return png_invalid("invalid png image");  // icon png invalid
+    return true;
+}
+
+QImage loadIconThumbnail(const Mod& mod, MMCZip::ArchiveIndex* archive)
+{
+    QByteArray data;
+    QString error;
+    if (mod.iconPath().isEmpty() || !readIconFile(mod, data, error, archive))
+        return {};
+
+    auto img = QImage::fromData(data);
+    if (img.isNull())
+        return {};
+    // same size Mod::setIcon scales to
+    return img.scaled({ 64, 64 }, Qt::AspectRatioMode::KeepAspectRatioByExpanding, Qt::SmoothTransformation);
+}
+
 }  // namespace ModUtils
 
-LocalModParseTask::LocalModParseTask(int token, ResourceType type, const QFileInfo& modFile)
+LocalModParseTask::LocalModParseTask(int token, ResourceType type, const QFileInfo& modFile, ModDetailsCache::Ptr cache)
     : Task(nullptr, false), m_token(token), m_type(type), m_modFile(modFile), m_result(new Result())
-{}
+{
+    // the stamp of a folder doesn't change when the metadata files inside it do
+    if (type != ResourceType::FOLDER)
+        m_cache = cache;
+}
 
 bool LocalModParseTask::abort()
 {
@@ -741,11 +725,29 @@ bool LocalModParseTask::abort()
 
 void LocalModParseTask::executeTask()
 {
+    if (m_cache && m_cache->find(m_modFile, m_result->details, m_result->icon)) {
+        emitSucceeded();
+        return;
+    }
+
     Mod mod{ m_modFile };
-    ModUtils::process(mod, ModUtils::ProcessingLevel::Full);
+    // index the jar once, both the metadata and the icon are then looked up in it
+    std::optional<MMCZip::ArchiveIndex> archive;
+    if (mod.type() == ResourceType::ZIPFILE) {
+        archive.emplace(m_modFile.filePath());
+        ModUtils::processZIP(mod, *archive, ModUtils::ProcessingLevel::Full);
+    } else {
+        ModUtils::process(mod, ModUtils::ProcessingLevel::Full);
+    }
 
     m_result->details = mod.details();
 
+    if (m_cache && mod.valid() && !m_aborted) {
+        // the jar is hot in the page cache right now, grab the icon while at it so it doesn't need to be reopened later
+        m_result->icon = ModUtils::loadIconThumbnail(mod, archive ? &*archive : nullptr);
+        m_cache->insert(m_modFile, m_result->details, m_result->icon);
+    }
+
     if (m_aborted)
         emitAborted();
     else
@@ -1,13 +1,19 @@
 #pragma once
 
 #include <QDebug>
+#include <QImage>
 #include <QObject>
 
 #include "minecraft/mod/Mod.h"
 #include "minecraft/mod/ModDetails.h"
+#include "minecraft/mod/ModDetailsCache.h"
 
 #include "tasks/Task.h"
 
+namespace MMCZip {
+class ArchiveIndex;
+}
+
 namespace ModUtils {
 
 ModDetails ReadFabricModInfo(QByteArray contents);
@@ -20,6 +26,7 @@ enum class ProcessingLevel { Full, BasicInfoOnly };
 bool process(Mod& mod, ProcessingLevel level = ProcessingLevel::Full);
 
 bool processZIP(Mod& mod, ProcessingLevel level = ProcessingLevel::Full);
+bool processZIP(Mod& mod, MMCZip::ArchiveIndex& archive, ProcessingLevel level = ProcessingLevel::Full);
 bool processFolder(Mod& mod, ProcessingLevel level = ProcessingLevel::Full);
 bool processLitemod(Mod& mod, ProcessingLevel level = ProcessingLevel::Full);
 
@@ -27,7 +34,11 @@ bool processLitemod(Mod& mod, ProcessingLevel level = ProcessingLevel::Full);
 bool validate(QFileInfo file);
 
 bool processIconPNG(const Mod& mod, QByteArray&& raw_data, QPixmap* pixmap);
+/** Reads the raw contents of the mod's icon file, wherever it is stored. Zipped mods are looked up in `archive` if given. */
+bool readIconFile(const Mod& mod, QByteArray& data, QString& error, MMCZip::ArchiveIndex* archive = nullptr);
 bool loadIconFile(const Mod& mod, QPixmap* pixmap);
+/** Loads the mod's icon scaled down for display. Safe to call outside of the GUI thread. */
+QImage loadIconThumbnail(const Mod& mod, MMCZip::ArchiveIndex* archive = nullptr);
 }  // namespace ModUtils
 
 class LocalModParseTask : public Task {
@@ -35,6 +46,8 @@ class LocalModParseTask : public Task {
    public:
     struct Result {
         ModDetails details;
+        // only set when the icon was loaded along with the details
+        QImage icon;
     };
     using ResultPtr = std::shared_ptr<Result>;
     ResultPtr result() const { return m_result; }
@@ -42,7 +55,7 @@ class LocalModParseTask : public Task {
     [[nodiscard]] bool canAbort() const override { return true; }
     bool abort() override;
 
-    LocalModParseTask(int token, ResourceType type, const QFileInfo& modFile);
+    LocalModParseTask(int token, ResourceType type, const QFileInfo& modFile, ModDetailsCache::Ptr cache = nullptr);
     void executeTask() override;
 
     [[nodiscard]] int token() const { return m_token; }
@@ -57,6 +70,7 @@ class LocalModParseTask : public Task {
     ResourceType m_type;
     QFileInfo m_modFile;
     ResultPtr m_result;
+    ModDetailsCache::Ptr m_cache;
 
     std::atomic<bool> m_aborted = false;
 };
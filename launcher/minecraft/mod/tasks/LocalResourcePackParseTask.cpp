@@ -20,10 +20,7 @@
 
 #include "FileSystem.h"
 #include "Json.h"
-
-#include <quazip/quazip.h>
-#include <quazip/quazipdir.h>
-#include <quazip/quazipfile.h>
+#include "MMCZip.h"
 
 #include <QCryptographicHash>
 
@@ -108,43 +105,27 @@ bool processZIP(ResourcePack& pack, ProcessingLevel level)
 {
     Q_ASSERT(pack.type() == ResourceType::ZIPFILE);
 
-    QuaZip zip(pack.fileinfo().filePath());
-    if (!zip.open(QuaZip::mdUnzip))
+    MMCZip::ArchiveIndex archive(pack.fileinfo().filePath());
+    if (!archive.isOpen())
         return false;  // can't open zip file
 
-    QuaZipFile file(&zip);
-
     auto mcmeta_invalid = [&pack]() {
         qWarning() << "Resource pack at" << pack.fileinfo().filePath() << "does not have a valid pack.mcmeta";
         return false;  // the mcmeta is not optional
     };
 
-    if (zip.setCurrentFile("pack.mcmeta")) {
-        if (!file.open(QIODevice::ReadOnly)) {
-            qCritical() << "Failed to open file in zip.";
-            zip.close();
-            return mcmeta_invalid();
-        }
-
-        auto data = file.readAll();
+    auto mcmeta = archive.read("pack.mcmeta");
+    if (!mcmeta)
+        return mcmeta_invalid();  // pack.mcmeta does not exist or can't be read
 
-        bool mcmeta_result = ResourcePackUtils::processMCMeta(pack, std::move(data));
-
-        file.close();
-        if (!mcmeta_result) {
-            return mcmeta_invalid();  // mcmeta invalid
-        }
-    } else {
-        return mcmeta_invalid();  // could not set pack.mcmeta as current file.
-    }
+    if (!ResourcePackUtils::processMCMeta(pack, std::move(*mcmeta)))
+        return mcmeta_invalid();  // mcmeta invalid
 
-    QuaZipDir zipDir(&zip);
-    if (!zipDir.exists("/assets")) {
+    if (!archive.containsDir("assets")) {
         return false;  // assets dir does not exists at zip root
     }
 
     if (level == ProcessingLevel::BasicInfoOnly) {
-        zip.close();
         return true;  // only need basic info already checked
     }
 
@@ -153,28 +134,13 @@ bool processZIP(ResourcePack& pack, ProcessingLevel level)
         return true;  // the png is optional
     };
 
-    if (zip.setCurrentFile("pack.png")) {
-        if (!file.open(QIODevice::ReadOnly)) {
-            qCritical() << "Failed to open file in zip.";
-            zip.close();
-            return png_invalid();
-        }
-
-        auto data = file.readAll();
-
-        bool pack_png_result = ResourcePackUtils::processPackPNG(pack, std::move(data));
+    auto pack_png = archive.read("pack.png");
+    if (!pack_png)
+        return png_invalid();  // pack.png does not exist or can't be read
 
-        file.close();
-        zip.close();
-        if (!pack_png_result) {
-            return png_invalid();  // pack.png invalid
-        }
-    } else {
-        zip.close();
-        return png_invalid();  // could not set pack.mcmeta as current file.
-    }
+    if (!ResourcePackUtils::processPackPNG(pack, std::move(*pack_png)))
+        return png_invalid();  // pack.png invalid
 
-    zip.close();
     return true;
 }
 
@@ -319,28 +285,16 @@ bool processPackPNG(const ResourcePack& pack)
             return false;  // not processed correctly; https://github.com/PrismLauncher/PrismLauncher/issues/1740
         }
         case ResourceType::ZIPFILE: {
-            QuaZip zip(pack.fileinfo().filePath());
-            if (!zip.open(QuaZip::mdUnzip))
+            MMCZip::ArchiveIndex archive(pack.fileinfo().filePath());
+            if (!archive.isOpen())
                 return false;  // can't open zip file
 
-            QuaZipFile file(&zip);
-            if (zip.setCurrentFile("pack.png")) {
-                if (!file.open(QIODevice::ReadOnly)) {
-                    qCritical() << "Failed to open file in zip.";
-                    zip.close();
-                    return png_invalid();
-                }
-
-                auto data = file.readAll();
-
-                bool pack_png_result = ResourcePackUtils::processPackPNG(pack, std::move(data));
+            auto data = archive.read("pack.png");
+            if (!data)
+                return png_invalid();  // pack.png does not exist or can't be read
 
-                file.close();
-                if (!pack_png_result) {
-                    return png_invalid();  // pack.png invalid
-                }
-            } else {
-                return png_invalid();  // could not set pack.mcmeta as current file.
+            if (!ResourcePackUtils::processPackPNG(pack, std::move(*data))) {
+                return png_invalid();  // pack.png invalid
             }
             return false;  // not processed correctly; https://github.com/PrismLauncher/PrismLauncher/issues/1740
         }
@@ -22,10 +22,7 @@
 #include "LocalShaderPackParseTask.h"
 
 #include "FileSystem.h"
-
-#include <quazip/quazip.h>
-#include <quazip/quazipdir.h>
-#include <quazip/quazipfile.h>
+#include "MMCZip.h"
 
 namespace ShaderPackUtils {
 
@@ -63,25 +60,19 @@ bool processZIP(ShaderPack& pack, ProcessingLevel level)
 {
     Q_ASSERT(pack.type() == ResourceType::ZIPFILE);
 
-    QuaZip zip(pack.fileinfo().filePath());
-    if (!zip.open(QuaZip::mdUnzip))
+    MMCZip::ArchiveIndex archive(pack.fileinfo().filePath());
+    if (!archive.isOpen())
         return false;  // can't open zip file
 
-    QuaZipFile file(&zip);
-
-    QuaZipDir zipDir(&zip);
-    if (!zipDir.exists("/shaders")) {
+    if (!archive.containsDir("shaders")) {
         return false;  // assets dir does not exists at zip root
     }
     pack.setPackFormat(ShaderPackFormat::VALID);
 
     if (level == ProcessingLevel::BasicInfoOnly) {
-        zip.close();
         return true;  // only need basic info already checked
     }
 
-    zip.close();
-
     return true;
 }
 
@@ -10,6 +10,8 @@
 
 #include "net/ApiDownload.h"
 
+#include <QtConcurrent>
+
 AssetUpdateTask::AssetUpdateTask(MinecraftInstance* inst)
 {
     m_inst = inst;
@@ -24,6 +26,7 @@ void AssetUpdateTask::executeTask()
     QUrl indexUrl = assets->url;
     QString localPath = assets->id + ".json";
     auto job = makeShared<NetJob>(tr("Asset index for %1").arg(m_inst->name()), APPLICATION->network());
+    job->setPriority(Net::Priority::Blocking);
 
     auto metacache = APPLICATION->metacache();
     auto entry = metacache->resolveEntry("asset_indexes", localPath);
@@ -53,7 +56,6 @@ bool AssetUpdateTask::canAbort() const
 
 void AssetUpdateTask::assetIndexFinished()
 {
-    AssetsIndex index;
     qDebug() << m_inst->name() << ": Finished asset index download";
 
     auto components = m_inst->getPackProfile();
@@ -62,18 +64,37 @@ void AssetUpdateTask::assetIndexFinished()
 
     QString asset_fname = "assets/indexes/" + assets->id + ".json";
     // FIXME: this looks like a job for a generic validator based on json schema?
-    if (!AssetsUtils::loadAssetsIndexJson(assets->id, asset_fname, index)) {
+    auto index = AssetsUtils::loadAssetsIndex(assets->id, asset_fname);
+    if (!index) {
         auto metacache = APPLICATION->metacache();
         auto entry = metacache->resolveEntry("asset_indexes", assets->id + ".json");
         metacache->evictEntry(entry);
         emitFailed(tr("Failed to read the assets index!"));
+        return;
     }
 
-    auto job = index.getDownloadJob();
+    // stats thousands of files when it can't be skipped, keep it off the GUI thread
+    setStatus(tr("Checking the assets files..."));
+    m_index = index;
+    m_missing = QtConcurrent::run(QThreadPool::globalInstance(), [index] { return index->missingObjects(); });
+    connect(&m_missingWatcher, &QFutureWatcher<QVector<int>>::finished, this, &AssetUpdateTask::assetsChecked);
+    m_missingWatcher.setFuture(m_missing);
+}
+
+void AssetUpdateTask::assetsChecked()
+{
+    if (!isRunning())
+        return;
+
+    auto job = m_index->getDownloadJob(m_missing.result());
     if (job) {
         setStatus(tr("Getting the assets files from Mojang..."));
         downloadJob = job;
-        connect(downloadJob.get(), &NetJob::succeeded, this, &AssetUpdateTask::emitSucceeded);
+        connect(downloadJob.get(), &NetJob::succeeded, this, [this] {
+            // lists the object folders, and nothing waits for it
+            QtConcurrent::run(QThreadPool::globalInstance(), [index = m_index] { index->markVerified(index->objectFolderStamps()); });
+            emitSucceeded();
+        });
         connect(downloadJob.get(), &NetJob::failed, this, &AssetUpdateTask::assetsFailed);
         connect(downloadJob.get(), &NetJob::aborted, this, [this] { emitFailed(tr("Aborted")); });
         connect(downloadJob.get(), &NetJob::progress, this, &AssetUpdateTask::progress);
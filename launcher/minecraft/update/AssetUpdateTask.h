@@ -1,4 +1,8 @@
 #pragma once
+#include <QFuture>
+#include <QFutureWatcher>
+
+#include "minecraft/AssetsUtils.h"
 #include "net/NetJob.h"
 #include "tasks/Task.h"
 class MinecraftInstance;
@@ -15,6 +19,7 @@ class AssetUpdateTask : public Task {
 
    private slots:
     void assetIndexFinished();
+    void assetsChecked();
     void assetIndexFailed(QString reason);
     void assetsFailed(QString reason);
 
@@ -24,4 +29,7 @@ class AssetUpdateTask : public Task {
    private:
     MinecraftInstance* m_inst;
     NetJob::Ptr downloadJob;
+    AssetsIndex::Ptr m_index;
+    QFuture<QVector<int>> m_missing;
+    QFutureWatcher<QVector<int>> m_missingWatcher;
 };
@@ -32,15 +32,26 @@ EnsureMetadataTask::EnsureMetadataTask(Mod* mod, QDir dir, ModPlatform::Resource
 EnsureMetadataTask::EnsureMetadataTask(QList<Mod*>& mods, QDir dir, ModPlatform::ResourceProvider prov)
     : Task(nullptr), m_index_dir(dir), m_provider(prov), m_current_task(nullptr)
 {
-    m_hashing_task.reset(new ConcurrentTask(this, "MakeHashesTask", APPLICATION->settings()->get("NumberOfConcurrentTasks").toInt()));
+    // every jar is read once by a single batch, instead of one task per mod
+    QStringList paths;
+    QHash<QString, Mod*> mods_by_path;
     for (auto* mod : mods) {
-        auto hash_task = createNewHash(mod);
-        if (!hash_task)
+        if (!mod || !mod->valid() || mod->type() == ResourceType::FOLDER)
             continue;
-        connect(hash_task.get(), &Hashing::Hasher::resultsReady, [this, mod](QString hash) { m_mods.insert(hash, mod); });
-        connect(hash_task.get(), &Task::failed, [this, mod] { emitFail(mod, "", RemoveFromList::No); });
-        m_hashing_task->addTask(hash_task);
+        auto path = mod->fileinfo().absoluteFilePath();
+        paths.append(path);
+        mods_by_path.insert(path, mod);
     }
+
+    auto algorithm = Hashing::algorithmForProvider(m_provider);
+    m_hashing_task.reset(
+        new Hashing::BatchHasher(paths, { algorithm }, APPLICATION->settings()->get("NumberOfConcurrentTasks").toInt()));
+    connect(m_hashing_task.get(), &Hashing::BatchHasher::fileHashed, this,
+            [this, mods_by_path, algorithm](QString path, Hashing::Digests digests) {
+                m_mods.insert(digests.value(algorithm), mods_by_path.value(path));
+            });
+    connect(m_hashing_task.get(), &Hashing::BatchHasher::fileFailed, this,
+            [this, mods_by_path](QString path) { emitFail(mods_by_path.value(path), "", RemoveFromList::No); });
 }
 EnsureMetadataTask::EnsureMetadataTask(QHash<QString, Mod*>& mods, QDir dir, ModPlatform::ResourceProvider prov)
     : Task(nullptr), m_mods(mods), m_index_dir(dir), m_provider(prov), m_current_task(nullptr)
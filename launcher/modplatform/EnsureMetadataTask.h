@@ -58,6 +58,6 @@ class EnsureMetadataTask : public Task {
     ModPlatform::ResourceProvider m_provider;
 
     QHash<QString, ModPlatform::IndexedVersion> m_temp_versions;
-    ConcurrentTask::Ptr m_hashing_task;
+    Hashing::BatchHasher::Ptr m_hashing_task;
     Task::Ptr m_current_task;
 };
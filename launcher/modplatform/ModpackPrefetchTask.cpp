@@ -0,0 +1,148 @@
+// SPDX-License-Identifier: GPL-3.0-only
+/*
+ *  Prism Launcher - Minecraft Launcher
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, version 3.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "ModpackPrefetchTask.h"
+
+#include <QDebug>
+#include <QFileInfo>
+#include <QSet>
+
+#include "Json.h"
+
+#include "net/ApiDownload.h"
+#include "net/ChecksumValidator.h"
+#include "net/NetJob.h"
+
+ModpackPrefetchTask::ModpackPrefetchTask(ContentStore::Ptr store, shared_qobject_ptr<QNetworkAccessManager> network, int max_concurrent)
+    : m_store(std::move(store)), m_network(std::move(network)), m_max_concurrent(max_concurrent)
+{}
+
+void ModpackPrefetchTask::setModrinthIndex(const QByteArray& index)
+{
+    m_files = modrinthFiles(index);
+}
+
+void ModpackPrefetchTask::setFlameManifest(Flame::Manifest manifest)
+{
+    m_resolver.reset(new Flame::FileResolvingTask(m_network, manifest));
+}
+
+QList<ModpackPrefetchTask::File> ModpackPrefetchTask::modrinthFiles(const QByteArray& index)
+{
+    QList<File> files;
+    try {
+        auto obj = Json::requireObject(Json::requireDocument(index, "modrinth.index.json"), "modrinth.index.json");
+        for (const auto& info : Json::requireIsArrayOf<QJsonObject>(obj, "files", "modrinth.index.json")) {
+            // same as ModrinthCreationTask: a missing 'env' means required, a missing client means unsupported
+            auto env = Json::ensureObject(info, "env");
+            if (!env.isEmpty() && Json::ensureString(env, "client", "unsupported") != "required")
+                continue;
+
+            auto hash = Json::ensureString(Json::ensureObject(info, "hashes"), "sha512");
+            QUrl url;
+            for (auto download : Json::ensureArray(info, "downloads")) {
+                url = QUrl(download.toString());
+                if (url.isValid())
+                    break;
+            }
+            if (hash.isEmpty() || !url.isValid())
+                continue;
+
+            files.append({ url, QCryptographicHash::Sha512, hash });
+        }
+    } catch (const JSONValidationError& e) {
+        // the creation task reports it once the pack is extracted
+        qWarning() << "Not prefetching files of an invalid pack index:" << e.cause();
+        return {};
+    }
+    return files;
+}
+
+QList<ModpackPrefetchTask::File> ModpackPrefetchTask::flameFiles(const Flame::Manifest& resolved)
+{
+    QList<File> files;
+    for (const auto& file : resolved.files) {
+        // only sha1 is trusted enough to share files between instances
+        if (!file.required || file.version.downloadUrl.isEmpty() || file.version.hash_type != "sha1" || file.version.hash.isEmpty())
+            continue;
+        files.append({ QUrl(file.version.downloadUrl), QCryptographicHash::Sha1, file.version.hash });
+    }
+    return files;
+}
+
+void ModpackPrefetchTask::executeTask()
+{
+    if (!m_resolver) {
+        fetch(m_files);
+        return;
+    }
+
+    setStatus(tr("Resolving mod IDs..."));
+    connect(m_resolver.get(), &Task::succeeded, this, [this] { fetch(flameFiles(m_resolver->getResults())); });
+    connect(m_resolver.get(), &Task::failed, this, [this](QString reason) {
+        qWarning() << "Could not resolve the mods to prefetch:" << reason;
+        emitSucceeded();
+    });
+    connect(m_resolver.get(), &Task::aborted, this, &ModpackPrefetchTask::emitAborted);
+    connect(m_resolver.get(), &Task::stepProgress, this, &ModpackPrefetchTask::propagateStepProgress);
+    m_task = m_resolver;
+    m_resolver->start();
+}
+
+void ModpackPrefetchTask::fetch(const QList<File>& files)
+{
+    auto job = makeShared<NetJob>(tr("Modpack prefetch"), m_network, m_max_concurrent);
+    job->setAskRetry(false);
+
+    QSet<QString> queued;
+    for (const auto& file : files) {
+        auto blob = m_store->blobPath(file.algorithm, file.hash);
+        if (blob.isEmpty() || queued.contains(blob) || QFileInfo(blob).isFile())
+            continue;
+        queued.insert(blob);
+
+        // straight into the store: the sink only moves the file in place once it passed validation
+        auto dl = Net::ApiDownload::makeFile(file.url, blob);
+        dl->addValidator(new Net::ChecksumValidator(file.algorithm, file.hash));
+        job->addNetAction(dl);
+    }
+
+    if (job->size() == 0) {
+        emitSucceeded();
+        return;
+    }
+
+    qDebug() << "Prefetching" << job->size() << "modpack files";
+    setStatus(tr("Downloading mods..."));
+    connect(job.get(), &Task::succeeded, this, &ModpackPrefetchTask::emitSucceeded);
+    connect(job.get(), &Task::failed, this, [this](QString reason) {
+        qWarning() << "Some modpack files could not be prefetched:" << reason;
+        emitSucceeded();
+    });
+    connect(job.get(), &Task::aborted, this, &ModpackPrefetchTask::emitAborted);
+    connect(job.get(), &Task::progress, this, &ModpackPrefetchTask::setProgress);
+    connect(job.get(), &Task::stepProgress, this, &ModpackPrefetchTask::propagateStepProgress);
+    m_task = job;
+    job->start();
+}
+
+bool ModpackPrefetchTask::abort()
+{
+    if (m_task && m_task->isRunning())
+        return m_task->abort();
+    return Task::abort();
+}
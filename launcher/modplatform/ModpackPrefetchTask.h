@@ -0,0 +1,79 @@
+// SPDX-License-Identifier: GPL-3.0-only
+/*
+ *  Prism Launcher - Minecraft Launcher
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, version 3.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <QCryptographicHash>
+#include <QList>
+#include <QNetworkAccessManager>
+#include <QUrl>
+
+#include "ContentStore.h"
+#include "modplatform/flame/FileResolvingTask.h"
+#include "tasks/Task.h"
+
+/**
+ * Downloads the files listed in a modpack's manifest into the content store, so that can happen while the rest of the
+ * pack is still being extracted. The creation tasks then materialize them from the store instead of downloading them.
+ *
+ * Only files that are always installed and have a hash the store can address are fetched, anything the user still has
+ * to decide on (optional and blocked mods) is left to the creation tasks. Files that fail to download aren't an error
+ * here either, the creation tasks try them again and report it.
+ */
+class ModpackPrefetchTask : public Task {
+    Q_OBJECT
+
+   public:
+    using Ptr = shared_qobject_ptr<ModpackPrefetchTask>;
+
+    struct File {
+        QUrl url;
+        QCryptographicHash::Algorithm algorithm;
+        QString hash;
+    };
+
+    ModpackPrefetchTask(ContentStore::Ptr store, shared_qobject_ptr<QNetworkAccessManager> network, int max_concurrent = -1);
+    virtual ~ModpackPrefetchTask() = default;
+
+    /** Fetches the files of a modrinth.index.json. */
+    void setModrinthIndex(const QByteArray& index);
+    /** Fetches the files of a CurseForge manifest, once their IDs are resolved. */
+    void setFlameManifest(Flame::Manifest manifest);
+
+    /** The resolver used for the CurseForge manifest, so its results don't have to be resolved again. */
+    shared_qobject_ptr<Flame::FileResolvingTask> flameResolver() const { return m_resolver; }
+
+    static QList<File> modrinthFiles(const QByteArray& index);
+    static QList<File> flameFiles(const Flame::Manifest& resolved);
+
+    bool canAbort() const override { return true; }
+    bool abort() override;
+
+   protected:
+    void executeTask() override;
+
+   private:
+    void fetch(const QList<File>& files);
+
+    ContentStore::Ptr m_store;
+    shared_qobject_ptr<QNetworkAccessManager> m_network;
+    int m_max_concurrent;
+
+    QList<File> m_files;
+    shared_qobject_ptr<Flame::FileResolvingTask> m_resolver;
+    Task::Ptr m_task;
+};
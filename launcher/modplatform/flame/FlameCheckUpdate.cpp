@@ -3,7 +3,6 @@
 #include "FlameAPI.h"
 #include "FlameModIndex.h"
 
-#include <MurmurHash2.h>
 #include <memory>
 
 #include "Json.h"
@@ -14,131 +13,211 @@
 #include "minecraft/mod/tasks/GetModDependenciesTask.h"
 
 #include "net/ApiDownload.h"
+#include "net/ApiUpload.h"
 
 static FlameAPI api;
 
-bool FlameCheckUpdate::abort()
+namespace {
+// the endpoints take more, but huge requests are slow to be answered and are all lost when one fails
+const int s_batch_size = 100;
+
+QJsonObject parseResponse(const QByteArray& response)
 {
-    m_was_aborted = true;
-    if (m_net_job)
-        return m_net_job->abort();
-    return true;
+    QJsonParseError parse_error{};
+    QJsonDocument doc = QJsonDocument::fromJson(response, &parse_error);
+    if (parse_error.error != QJsonParseError::NoError) {
+        qWarning() << "Error while parsing JSON response from FlameCheckUpdate at " << parse_error.offset
+                   << " reason: " << parse_error.errorString();
+        qWarning() << response;
+        throw Json::JsonException(parse_error.errorString());
+    }
+    return Json::requireObject(doc);
 }
 
-ModPlatform::IndexedPack FlameCheckUpdate::getProjectInfo(ModPlatform::IndexedVersion& ver_info)
+// one request per batch of ids, run as many at a time as the downloads are
+NetJob::Ptr batchedUpload(shared_qobject_ptr<QNetworkAccessManager> network,
+                          QString name,
+                          QString url,
+                          QString key,
+                          const QStringList& ids,
+                          QList<std::shared_ptr<QByteArray>>& responses)
 {
-    ModPlatform::IndexedPack pack;
-
-    QEventLoop loop;
+    auto job = makeShared<NetJob>(name, network);
+    responses.clear();
+    for (auto& batch : FlameCheckUpdate::batches(ids)) {
+        QJsonArray ids_arr;
+        for (auto& id : batch)
+            ids_arr.append(id.toInt());
+
+        QJsonObject body_obj;
+        body_obj[key] = ids_arr;
+
+        auto response = std::make_shared<QByteArray>();
+        responses.append(response);
+        job->addNetAction(Net::ApiUpload::makeByteArray(url, response, QJsonDocument(body_obj).toJson(QJsonDocument::Compact)));
+    }
+    return job;
+}
+}  // namespace
 
-    auto get_project_job = new NetJob("Flame::GetProjectJob", APPLICATION->network());
+FlameCheckUpdate::FlameCheckUpdate(QList<Mod*>& mods,
+                                   std::list<Version>& mcVersions,
+                                   QList<ModPlatform::ModLoaderType> loadersList,
+                                   std::shared_ptr<ModFolderModel> mods_folder,
+                                   shared_qobject_ptr<QNetworkAccessManager> network)
+    : CheckUpdateTask(mods, mcVersions, loadersList, mods_folder), m_network(network ? network : APPLICATION->network())
+{}
 
-    auto response = std::make_shared<QByteArray>();
-    auto url = QString("https://api.curseforge.com/v1/mods/%1").arg(ver_info.addonId.toString());
-    auto dl = Net::ApiDownload::makeByteArray(url, response);
-    get_project_job->addNetAction(dl);
+QList<QStringList> FlameCheckUpdate::batches(const QStringList& ids)
+{
+    QList<QStringList> batches;
+    for (int i = 0; i < ids.size(); i += s_batch_size)
+        batches.append(ids.mid(i, s_batch_size));
+    return batches;
+}
 
-    QObject::connect(get_project_job, &NetJob::succeeded, [response, &pack]() {
-        QJsonParseError parse_error{};
-        QJsonDocument doc = QJsonDocument::fromJson(*response, &parse_error);
-        if (parse_error.error != QJsonParseError::NoError) {
-            qWarning() << "Error while parsing JSON response from FlameCheckUpdate at " << parse_error.offset
-                       << " reason: " << parse_error.errorString();
-            qWarning() << *response;
-            return;
+QHash<QString, QStringList> FlameCheckUpdate::latestFileIds(const QByteArray& response,
+                                                            const std::list<Version>& game_versions,
+                                                            QHash<QString, ModPlatform::IndexedPack>& packs)
+{
+    QHash<QString, QStringList> latest_files;
+
+    auto data = Json::requireArray(parseResponse(response), "data");
+    for (auto project : data) {
+        auto project_obj = Json::requireObject(project);
+
+        ModPlatform::IndexedPack pack;
+        FlameMod::loadIndexedPack(pack, project_obj);
+        auto addon_id = pack.addonId.toString();
+        packs.insert(addon_id, pack);
+
+        // there is one entry per game version, loader and release type, so the most recent file for a loader is always there
+        auto& file_ids = latest_files[addon_id];
+        for (auto index : Json::ensureArray(project_obj, "latestFilesIndexes")) {
+            auto index_obj = Json::requireObject(index);
+            auto game_version = Json::requireString(index_obj, "gameVersion");
+            auto file_id = QString::number(Json::requireInteger(index_obj, "fileId"));
+            if (file_ids.contains(file_id))
+                continue;
+            for (auto& version : game_versions) {
+                if (version.toString() == game_version) {
+                    file_ids.append(file_id);
+                    break;
+                }
+            }
         }
+    }
+    return latest_files;
+}
+
+void FlameCheckUpdate::loadFiles(const QByteArray& response, QHash<QString, ModPlatform::IndexedVersion>& files)
+{
+    auto data = Json::requireArray(parseResponse(response), "data");
+    for (auto file : data) {
+        auto file_obj = Json::requireObject(file);
+        auto version = FlameMod::loadIndexedPackVersion(file_obj);
+        if (version.fileId.isValid())
+            files.insert(version.fileId.toString(), version);
+    }
+}
 
+bool FlameCheckUpdate::abort()
+{
+    if (m_job)
+        return m_job->abort();
+    return true;
+}
+
+/* Check for update:
+ * - Get the latest files of all the projects, a batch of them per request
+ * - Get the details of those files, again in batches, and pick the latest one for the mod loaders
+ * - Compare hash of the latest version with the current hash
+ * - If equal, no updates, else, there's updates, so add to the list
+ * */
+void FlameCheckUpdate::executeTask()
+{
+    setStatus(tr("Getting API response from CurseForge..."));
+    setProgress(0, 3);
+
+    QStringList addon_ids;
+    for (auto* mod : m_mods) {
+        auto addon_id = mod->metadata()->project_id.toString();
+        if (!addon_ids.contains(addon_id))
+            addon_ids.append(addon_id);
+    }
+
+    auto job =
+        batchedUpload(m_network, "Flame::CheckUpdateProjects", "https://api.curseforge.com/v1/mods", "modIds", addon_ids, m_responses);
+    connect(job.get(), &Task::succeeded, this, [this] {
         try {
-            auto doc_obj = Json::requireObject(doc);
-            auto data_obj = Json::requireObject(doc_obj, "data");
-            FlameMod::loadIndexedPack(pack, data_obj);
+            for (auto& response : m_responses) {
+                auto latest_files = latestFileIds(*response, m_game_versions, m_packs);
+                for (auto it = latest_files.constBegin(); it != latest_files.constEnd(); ++it)
+                    m_latest_files.insert(it.key(), it.value());
+            }
         } catch (Json::JsonException& e) {
-            qWarning() << e.cause();
-            qDebug() << doc;
+            emitFailed(e.cause() + " : " + e.what());
+            return;
         }
+        getFiles();
     });
+    connect(job.get(), &Task::failed, this, &FlameCheckUpdate::emitFailed);
+    connect(job.get(), &Task::aborted, this, &FlameCheckUpdate::emitAborted);
 
-    connect(get_project_job, &NetJob::failed, this, &FlameCheckUpdate::emitFailed);
-    QObject::connect(get_project_job, &NetJob::finished, [&loop, get_project_job] {
-        get_project_job->deleteLater();
-        loop.quit();
-    });
-
-    get_project_job->start();
-    loop.exec();
-
-    return pack;
+    m_job = job;
+    job->start();
 }
 
-ModPlatform::IndexedVersion FlameCheckUpdate::getFileInfo(int addonId, int fileId)
+void FlameCheckUpdate::getFiles()
 {
-    ModPlatform::IndexedVersion ver;
-
-    QEventLoop loop;
+    setStatus(tr("Getting the latest versions from CurseForge..."));
+    setProgress(1, 3);
 
-    auto get_file_info_job = new NetJob("Flame::GetFileInfoJob", APPLICATION->network());
-
-    auto response = std::make_shared<QByteArray>();
-    auto url = QString("https://api.curseforge.com/v1/mods/%1/files/%2").arg(QString::number(addonId), QString::number(fileId));
-    auto dl = Net::ApiDownload::makeByteArray(url, response);
-    get_file_info_job->addNetAction(dl);
-
-    QObject::connect(get_file_info_job, &NetJob::succeeded, [response, &ver]() {
-        QJsonParseError parse_error{};
-        QJsonDocument doc = QJsonDocument::fromJson(*response, &parse_error);
-        if (parse_error.error != QJsonParseError::NoError) {
-            qWarning() << "Error while parsing JSON response from FlameCheckUpdate at " << parse_error.offset
-                       << " reason: " << parse_error.errorString();
-            qWarning() << *response;
-            return;
-        }
+    QStringList file_ids;
+    for (auto& ids : m_latest_files)
+        file_ids.append(ids);
+    // the current versions are only needed to show what is being updated
+    for (auto* mod : m_mods) {
+        if (mod->version().isEmpty() && mod->status() != ModStatus::NotInstalled)
+            file_ids.append(mod->metadata()->file_id.toString());
+    }
+    file_ids.removeDuplicates();
 
+    auto job =
+        batchedUpload(m_network, "Flame::CheckUpdateFiles", "https://api.curseforge.com/v1/mods/files", "fileIds", file_ids, m_responses);
+    connect(job.get(), &Task::succeeded, this, [this] {
         try {
-            auto doc_obj = Json::requireObject(doc);
-            auto data_obj = Json::requireObject(doc_obj, "data");
-            ver = FlameMod::loadIndexedPackVersion(data_obj);
+            for (auto& response : m_responses)
+                loadFiles(*response, m_files);
         } catch (Json::JsonException& e) {
-            qWarning() << e.cause();
-            qDebug() << doc;
+            emitFailed(e.cause() + " : " + e.what());
+            return;
         }
+        checkMods();
     });
-    connect(get_file_info_job, &NetJob::failed, this, &FlameCheckUpdate::emitFailed);
-    QObject::connect(get_file_info_job, &NetJob::finished, [&loop, get_file_info_job] {
-        get_file_info_job->deleteLater();
-        loop.quit();
-    });
+    connect(job.get(), &Task::failed, this, &FlameCheckUpdate::emitFailed);
+    connect(job.get(), &Task::aborted, this, &FlameCheckUpdate::emitAborted);
 
-    get_file_info_job->start();
-    loop.exec();
-
-    return ver;
+    m_job = job;
+    job->start();
 }
 
-/* Check for update:
- * - Get latest version available
- * - Compare hash of the latest version with the current hash
- * - If equal, no updates, else, there's updates, so add to the list
- * */
-void FlameCheckUpdate::executeTask()
+void FlameCheckUpdate::checkMods()
 {
-    setStatus(tr("Preparing mods for CurseForge..."));
+    setStatus(tr("Parsing the API response from CurseForge..."));
+    setProgress(2, 3);
 
-    int i = 0;
     for (auto* mod : m_mods) {
-        setStatus(tr("Getting API response from CurseForge for '%1'...").arg(mod->name()));
-        setProgress(i++, m_mods.size());
-
-        auto latest_vers = api.getLatestVersions({ { mod->metadata()->project_id.toString() }, m_game_versions });
+        auto addon_id = mod->metadata()->project_id.toString();
 
-        // Check if we were aborted while getting the latest version
-        if (m_was_aborted) {
-            aborted();
-            return;
+        QList<ModPlatform::IndexedVersion> latest_vers;
+        for (auto& file_id : m_latest_files.value(addon_id)) {
+            auto file = m_files.constFind(file_id);
+            if (file != m_files.constEnd())
+                latest_vers.append(*file);
         }
         auto latest_ver = api.getLatestVersion(latest_vers, m_loaders_list, mod->loaders());
 
-        setStatus(tr("Parsing the API response from CurseForge for '%1'...").arg(mod->name()));
-
         if (!latest_ver.has_value() || !latest_ver->addonId.isValid()) {
             emit checkFailed(mod, tr("No valid version found for this mod. It's probably unavailable for the current game "
                                      "version / mod loader."));
@@ -146,7 +225,7 @@ void FlameCheckUpdate::executeTask()
         }
 
         if (latest_ver->downloadUrl.isEmpty() && latest_ver->fileId != mod->metadata()->file_id) {
-            auto pack = getProjectInfo(latest_ver.value());
+            auto pack = m_packs.value(addon_id);
             auto recover_url = QString("%1/download/%2").arg(pack.websiteUrl, latest_ver->fileId.toString());
             emit checkFailed(mod, tr("Mod has a new update available, but is not downloadable using CurseForge."), recover_url);
 
@@ -165,18 +244,54 @@ void FlameCheckUpdate::executeTask()
         pack->provider = ModPlatform::ResourceProvider::FLAME;
         if (!latest_ver->hash.isEmpty() && (mod->metadata()->hash != latest_ver->hash || mod->status() == ModStatus::NotInstalled)) {
             auto old_version = mod->version();
-            if (old_version.isEmpty() && mod->status() != ModStatus::NotInstalled) {
-                auto current_ver = getFileInfo(latest_ver->addonId.toInt(), mod->metadata()->file_id.toInt());
-                old_version = current_ver.version;
-            }
+            if (old_version.isEmpty() && mod->status() != ModStatus::NotInstalled)
+                old_version = m_files.value(mod->metadata()->file_id.toString()).version;
 
+            // the changelog is filled in once every update is known
             auto download_task = makeShared<ResourceDownloadTask>(pack, latest_ver.value(), m_mods_folder);
             m_updatable.emplace_back(pack->name, mod->metadata()->hash, old_version, latest_ver->version, latest_ver->version_type,
-                                     api.getModFileChangelog(latest_ver->addonId.toInt(), latest_ver->fileId.toInt()),
-                                     ModPlatform::ResourceProvider::FLAME, download_task, mod->enabled());
+                                     QString(), ModPlatform::ResourceProvider::FLAME, download_task, mod->enabled());
         }
         m_deps.append(std::make_shared<GetModDependenciesTask::PackDependency>(pack, latest_ver.value()));
     }
 
-    emitSucceeded();
+    getChangelogs();
+}
+
+void FlameCheckUpdate::getChangelogs()
+{
+    if (m_updatable.empty()) {
+        emitSucceeded();
+        return;
+    }
+
+    setStatus(tr("Getting the changelogs from CurseForge..."));
+    setProgress(3, 3);
+
+    // there is no endpoint for more than one changelog, but they can at least be fetched concurrently
+    auto job = makeShared<NetJob>("Flame::CheckUpdateChangelogs", m_network);
+    m_responses.clear();
+    for (auto& updatable : m_updatable) {
+        auto& version = updatable.download->getVersion();
+        auto response = std::make_shared<QByteArray>();
+        m_responses.append(response);
+        job->addNetAction(Net::ApiDownload::makeByteArray(
+            QString("https://api.curseforge.com/v1/mods/%1/files/%2/changelog").arg(version.addonId.toString(), version.fileId.toString()),
+            response));
+    }
+
+    // a missing changelog is no reason to hide the updates
+    connect(job.get(), &Task::finished, this, [this] {
+        if (!isRunning())
+            return;
+        for (size_t i = 0; i < m_updatable.size(); i++) {
+            auto doc = QJsonDocument::fromJson(*m_responses.at(i));
+            m_updatable[i].changelog = Json::ensureString(doc.object(), "data");
+        }
+        emitSucceeded();
+    });
+    connect(job.get(), &Task::aborted, this, &FlameCheckUpdate::emitAborted);
+
+    m_job = job;
+    job->start();
 }
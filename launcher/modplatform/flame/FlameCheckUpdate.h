@@ -10,9 +10,21 @@ class FlameCheckUpdate : public CheckUpdateTask {
     FlameCheckUpdate(QList<Mod*>& mods,
                      std::list<Version>& mcVersions,
                      QList<ModPlatform::ModLoaderType> loadersList,
-                     std::shared_ptr<ModFolderModel> mods_folder)
-        : CheckUpdateTask(mods, mcVersions, loadersList, mods_folder)
-    {}
+                     std::shared_ptr<ModFolderModel> mods_folder,
+                     shared_qobject_ptr<QNetworkAccessManager> network = nullptr);
+
+    /** Splits ids in the batches sent to the multiple ids endpoints (`POST /v1/mods` and `POST /v1/mods/files`). */
+    static QList<QStringList> batches(const QStringList& ids);
+
+    /**
+     * Reads a `POST /v1/mods` response, returning the ids of the files each project has as latest for any of the game versions,
+     * whatever their loader and release type. The most recent of them for the right loader is the one to update to.
+     */
+    static QHash<QString, QStringList> latestFileIds(const QByteArray& response,
+                                                     const std::list<Version>& game_versions,
+                                                     QHash<QString, ModPlatform::IndexedPack>& packs);
+    /** Reads a `POST /v1/mods/files` response into `files`, by file id. */
+    static void loadFiles(const QByteArray& response, QHash<QString, ModPlatform::IndexedVersion>& files);
 
    public slots:
     bool abort() override;
@@ -21,10 +33,15 @@ class FlameCheckUpdate : public CheckUpdateTask {
     void executeTask() override;
 
    private:
-    ModPlatform::IndexedPack getProjectInfo(ModPlatform::IndexedVersion& ver_info);
-    ModPlatform::IndexedVersion getFileInfo(int addonId, int fileId);
+    void getFiles();
+    void checkMods();
+    void getChangelogs();
 
-    NetJob* m_net_job = nullptr;
+    shared_qobject_ptr<QNetworkAccessManager> m_network;
+    Task::Ptr m_job;
+    QList<std::shared_ptr<QByteArray>> m_responses;
 
-    bool m_was_aborted = false;
+    QHash<QString, ModPlatform::IndexedPack> m_packs;
+    QHash<QString, QStringList> m_latest_files;
+    QHash<QString, ModPlatform::IndexedVersion> m_files;
 };
@@ -43,6 +43,7 @@
 #include "modplatform/flame/PackManifest.h"
 
 #include "Application.h"
+#include "ContentStore.h"
 #include "FileSystem.h"
 #include "InstanceList.h"
 #include "Json.h"
@@ -65,6 +66,7 @@
 #include "minecraft/World.h"
 #include "minecraft/mod/tasks/LocalResourceParse.h"
 #include "net/ApiDownload.h"
+#include "net/ChecksumValidator.h"
 #include "ui/pages/modplatform/OptionalModDialog.h"
 
 static const FlameAPI api;
@@ -79,7 +81,7 @@ bool FlameCreationTask::abort()
         m_process_update_file_info_job->abort();
     if (m_files_job)
         m_files_job->abort();
-    if (m_mod_id_resolver)
+    if (m_mod_id_resolver && m_mod_id_resolver->isRunning())
         m_mod_id_resolver->abort();
 
     return Task::abort();
@@ -437,18 +439,24 @@ bool FlameCreationTask::createInstance()
 
     instance.setName(name());
 
-    m_mod_id_resolver.reset(new Flame::FileResolvingTask(APPLICATION->network(), m_pack));
-    connect(m_mod_id_resolver.get(), &Flame::FileResolvingTask::succeeded, this, [this, &loop] { idResolverSucceeded(loop); });
-    connect(m_mod_id_resolver.get(), &Flame::FileResolvingTask::failed, [&](QString reason) {
-        m_mod_id_resolver.reset();
-        setError(tr("Unable to resolve mod IDs:\n") + reason);
-        loop.quit();
-    });
-    connect(m_mod_id_resolver.get(), &Flame::FileResolvingTask::progress, this, &FlameCreationTask::setProgress);
-    connect(m_mod_id_resolver.get(), &Flame::FileResolvingTask::status, this, &FlameCreationTask::setStatus);
-    connect(m_mod_id_resolver.get(), &Flame::FileResolvingTask::stepProgress, this, &FlameCreationTask::propagateStepProgress);
-    connect(m_mod_id_resolver.get(), &Flame::FileResolvingTask::details, this, &FlameCreationTask::setDetails);
-    m_mod_id_resolver->start();
+    // updates drop the files that didn't change from the pack, those results would bring them back
+    if (m_mod_id_resolver && m_mod_id_resolver->wasSuccessful() && m_mod_id_resolver->getResults().files.keys() == m_pack.files.keys()) {
+        // resolved while the pack was being extracted, queued so it runs inside the loop
+        QMetaObject::invokeMethod(this, [this, &loop] { idResolverSucceeded(loop); }, Qt::QueuedConnection);
+    } else {
+        m_mod_id_resolver.reset(new Flame::FileResolvingTask(APPLICATION->network(), m_pack));
+        connect(m_mod_id_resolver.get(), &Flame::FileResolvingTask::succeeded, this, [this, &loop] { idResolverSucceeded(loop); });
+        connect(m_mod_id_resolver.get(), &Flame::FileResolvingTask::failed, [&](QString reason) {
+            m_mod_id_resolver.reset();
+            setError(tr("Unable to resolve mod IDs:\n") + reason);
+            loop.quit();
+        });
+        connect(m_mod_id_resolver.get(), &Flame::FileResolvingTask::progress, this, &FlameCreationTask::setProgress);
+        connect(m_mod_id_resolver.get(), &Flame::FileResolvingTask::status, this, &FlameCreationTask::setStatus);
+        connect(m_mod_id_resolver.get(), &Flame::FileResolvingTask::stepProgress, this, &FlameCreationTask::propagateStepProgress);
+        connect(m_mod_id_resolver.get(), &Flame::FileResolvingTask::details, this, &FlameCreationTask::setDetails);
+        m_mod_id_resolver->start();
+    }
 
     loop.exec();
 
@@ -538,6 +546,7 @@ void FlameCreationTask::setupDownloadJob(QEventLoop& loop)
 
         selectedOptionalMods = optionalModDialog.getResult();
     }
+    auto store = APPLICATION->contentStore();
     for (const auto& result : results) {
         auto fileName = result.version.fileName;
         fileName = FS::RemoveInvalidPathChars(fileName);
@@ -551,8 +560,21 @@ void FlameCreationTask::setupDownloadJob(QEventLoop& loop)
         auto path = FS::PathCombine(m_stagingPath, relpath);
 
         if (!result.version.downloadUrl.isEmpty()) {
+            // only sha1 is trusted enough to share files between instances
+            auto sha1 = result.version.hash_type == "sha1" ? result.version.hash : QString();
+            if (!sha1.isEmpty() && store->materialize(QCryptographicHash::Sha1, sha1, path)) {
+                qDebug() << "Reusing" << relpath << "from the content store";
+                continue;
+            }
+
             qDebug() << "Will download" << result.version.downloadUrl << "to" << path;
             auto dl = Net::ApiDownload::makeFile(result.version.downloadUrl, path);
+            if (!sha1.isEmpty()) {
+                dl->addValidator(new Net::ChecksumValidator(QCryptographicHash::Sha1, sha1));
+                connect(dl.get(), &Task::succeeded, this, [store, sha1, path] { store->add(QCryptographicHash::Sha1, sha1, path); });
+            } else if (result.version.hash_type == "md5" && !result.version.hash.isEmpty()) {
+                dl->addValidator(new Net::ChecksumValidator(QCryptographicHash::Md5, result.version.hash));
+            }
             m_files_job->addNetAction(dl);
         }
     }
@@ -70,6 +70,9 @@ class FlameCreationTask final : public InstanceCreationTask {
     bool updateInstance() override;
     bool createInstance() override;
 
+    /** Uses the results of a resolver that already ran for this pack, instead of resolving the mod IDs again. */
+    void setFileResolver(shared_qobject_ptr<Flame::FileResolvingTask> resolver) { m_mod_id_resolver = std::move(resolver); }
+
    private slots:
     void idResolverSucceeded(QEventLoop&);
     void setupDownloadJob(QEventLoop&);
@@ -1,4 +1,5 @@
 #include "PackManifest.h"
+#include "FileSystem.h"
 #include "Json.h"
 
 static void loadFileV1(Flame::File& f, QJsonObject& file)
@@ -56,7 +57,12 @@ static void loadManifestV1(Flame::Manifest& pack, QJsonObject& manifest)
 
 void Flame::loadManifest(Flame::Manifest& m, const QString& filepath)
 {
-    auto doc = Json::requireDocument(filepath);
+    loadManifest(m, FS::read(filepath));
+}
+
+void Flame::loadManifest(Flame::Manifest& m, const QByteArray& data)
+{
+    auto doc = Json::requireDocument(data);
     auto obj = Json::requireObject(doc);
     m.manifestType = Json::requireString(obj, "manifestType");
     if (m.manifestType != "minecraftModpack") {
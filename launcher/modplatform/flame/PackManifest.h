@@ -82,4 +82,5 @@ struct Manifest {
 };
 
 void loadManifest(Flame::Manifest& m, const QString& filepath);
+void loadManifest(Flame::Manifest& m, const QByteArray& data);
 }  // namespace Flame
@@ -3,44 +3,45 @@
 #include <QBuffer>
 #include <QDebug>
 #include <QFile>
+#include <QFileDevice>
+#include <QFileInfo>
 #include <QtConcurrentRun>
 
 #include <MurmurHash2.h>
 
+#include <algorithm>
+#include <vector>
+
+#include "StringUtils.h"
+
 namespace Hashing {
 
-Hasher::Ptr createHasher(QString file_path, ModPlatform::ResourceProvider provider)
+Algorithm algorithmForProvider(ModPlatform::ResourceProvider provider)
 {
     switch (provider) {
         case ModPlatform::ResourceProvider::MODRINTH:
-            return makeShared<Hasher>(file_path,
-                                      ModPlatform::ProviderCapabilities::hashType(ModPlatform::ResourceProvider::MODRINTH).first());
+            return algorithmFromString(ModPlatform::ProviderCapabilities::hashType(ModPlatform::ResourceProvider::MODRINTH).first());
         case ModPlatform::ResourceProvider::FLAME:
-            return makeShared<Hasher>(file_path, Algorithm::Murmur2);
+            return Algorithm::Murmur2;
         default:
             qCritical() << "[Hashing]" << "Unrecognized mod platform!";
-            return nullptr;
+            return Algorithm::Unknown;
     }
 }
 
+Hasher::Ptr createHasher(QString file_path, ModPlatform::ResourceProvider provider)
+{
+    auto algorithm = algorithmForProvider(provider);
+    if (algorithm == Algorithm::Unknown)
+        return nullptr;
+    return makeShared<Hasher>(file_path, algorithm);
+}
+
 Hasher::Ptr createHasher(QString file_path, QString type)
 {
     return makeShared<Hasher>(file_path, type);
 }
 
-class QIODeviceReader : public Murmur2::Reader {
-   public:
-    QIODeviceReader(QIODevice* device) : m_device(device) {}
-    virtual ~QIODeviceReader() = default;
-    virtual int read(char* s, int n) { return m_device->read(s, n); }
-    virtual bool eof() { return m_device->atEnd(); }
-    virtual void goToBeginning() { m_device->seek(0); }
-    virtual void close() { m_device->close(); }
-
-   private:
-    QIODevice* m_device;
-};
-
 QString algorithmToString(Algorithm type)
 {
     switch (type) {
@@ -80,37 +81,57 @@ Algorithm algorithmFromString(QString type)
     return Algorithm::Unknown;
 }
 
-QString hash(QIODevice* device, Algorithm type)
+static bool toCryptographicAlgorithm(Algorithm type, QCryptographicHash::Algorithm& alg)
 {
-    if (!device->isOpen() && !device->open(QFile::ReadOnly))
-        return "";
-    QCryptographicHash::Algorithm alg = QCryptographicHash::Sha1;
     switch (type) {
         case Algorithm::Md4:
             alg = QCryptographicHash::Algorithm::Md4;
-            break;
+            return true;
         case Algorithm::Md5:
             alg = QCryptographicHash::Algorithm::Md5;
-            break;
+            return true;
         case Algorithm::Sha1:
             alg = QCryptographicHash::Algorithm::Sha1;
-            break;
+            return true;
         case Algorithm::Sha256:
             alg = QCryptographicHash::Algorithm::Sha256;
-            break;
+            return true;
         case Algorithm::Sha512:
             alg = QCryptographicHash::Algorithm::Sha512;
-            break;
-        case Algorithm::Murmur2: {  // CF-specific
-            auto should_filter_out = [](char c) { return (c == 9 || c == 10 || c == 13 || c == 32); };
-            auto reader = std::make_unique<QIODeviceReader>(device);
-            auto result = QString::number(Murmur2::hash(reader.get(), 4 * MiB, should_filter_out));
-            device->close();
-            return result;
+            return true;
+        default:
+            return false;
+    }
+}
+
+QString hash(QIODevice* device, Algorithm type)
+{
+    if (!device->isOpen() && !device->open(QFile::ReadOnly))
+        return "";
+
+    if (type == Algorithm::Murmur2) {  // CF-specific
+        // The seed depends on the length without whitespace, so the whole file is needed before hashing.
+        // Map it when possible, otherwise read it once and strip the whitespace in place.
+        uint32_t result;
+        auto file = qobject_cast<QFileDevice*>(device);
+        auto size = device->size();
+        uchar* mapped = file && size > 0 ? file->map(0, size) : nullptr;
+        if (mapped) {
+            result = Murmur2::curseForgeHash(reinterpret_cast<const char*>(mapped), size);
+            file->unmap(mapped);
+        } else {
+            auto data = device->readAll();
+            auto stripped_size = Murmur2::stripWhitespace(data.constData(), data.size(), data.data());
+            result = Murmur2::hash(data.constData(), stripped_size);
         }
-        case Algorithm::Unknown:
-            device->close();
-            return "";
+        device->close();
+        return QString::number(result);
+    }
+
+    QCryptographicHash::Algorithm alg;
+    if (!toCryptographicAlgorithm(type, alg)) {
+        device->close();
+        return "";
     }
 
     QCryptographicHash hash(alg);
@@ -135,6 +156,71 @@ QString hash(QByteArray data, Algorithm type)
     return hash(&buff, type);
 }
 
+Digests hashAll(QString fileName, QList<Algorithm> types)
+{
+    Digests results;
+    QFile file(fileName);
+    if (!file.open(QFile::ReadOnly))
+        return results;
+
+    bool wants_murmur2 = false;
+    QList<Algorithm> crypto_types;
+    std::vector<std::unique_ptr<QCryptographicHash>> crypto_hashes;
+    for (auto type : types) {
+        QCryptographicHash::Algorithm alg;
+        if (type == Algorithm::Murmur2) {
+            wants_murmur2 = true;
+        } else if (toCryptographicAlgorithm(type, alg) && !crypto_types.contains(type)) {
+            crypto_types.append(type);
+            crypto_hashes.push_back(std::make_unique<QCryptographicHash>(alg));
+        }
+    }
+
+    auto feed = [&crypto_hashes](const char* data, qint64 size) {
+        // QByteArray sizes are ints on Qt 5, so never hand it the whole file at once
+        static const qint64 s_slice = 64 * MiB;
+        for (qint64 offset = 0; offset < size; offset += s_slice) {
+            auto chunk = QByteArray::fromRawData(data + offset, static_cast<int>(std::min(s_slice, size - offset)));
+            for (auto& hash : crypto_hashes)
+                hash->addData(chunk);
+        }
+    };
+
+    auto size = file.size();
+    uchar* mapped = size > 0 ? file.map(0, size) : nullptr;
+    if (mapped || wants_murmur2) {
+        // everything comes from the same bytes in memory, read (or paged in) exactly once
+        QByteArray data;
+        const char* bytes = reinterpret_cast<const char*>(mapped);
+        if (!mapped) {
+            data = file.readAll();
+            bytes = data.constData();
+            size = data.size();
+        }
+
+        feed(bytes, size);
+        if (wants_murmur2)
+            results.insert(Algorithm::Murmur2, QString::number(Murmur2::curseForgeHash(bytes, size)));
+
+        if (mapped)
+            file.unmap(mapped);
+    } else {
+        QByteArray buffer(4 * MiB, Qt::Uninitialized);
+        qint64 read;
+        while ((read = file.read(buffer.data(), buffer.size())) > 0)
+            feed(buffer.constData(), read);
+        if (read < 0) {
+            qCritical() << "Failed to read" << fileName << "to create hashes!";
+            return {};
+        }
+    }
+
+    for (int i = 0; i < crypto_types.size(); i++)
+        results.insert(crypto_types.at(i), crypto_hashes.at(i)->result().toHex());
+
+    return results;
+}
+
 void Hasher::executeTask()
 {
     m_future = QtConcurrent::run(
@@ -162,4 +248,91 @@ bool Hasher::abort()
     }
     return false;
 }
+
+BatchHasher::BatchHasher(QStringList file_paths, QList<Algorithm> algorithms, int max_concurrent_reads)
+    : Task(nullptr), m_paths(file_paths), m_algorithms(algorithms), m_aborted(std::make_shared<std::atomic_bool>(false))
+{
+    // hashing is I/O bound, more readers than this just make the disk seek around
+    m_pool.setMaxThreadCount(std::max(1, std::min(max_concurrent_reads, QThread::idealThreadCount())));
+}
+
+BatchHasher::~BatchHasher()
+{
+    m_aborted->store(true);
+    m_pool.clear();
+    m_pool.waitForDone();
+}
+
+double BatchHasher::throughput() const
+{
+    auto elapsed = m_timer.isValid() ? m_timer.elapsed() : 0;
+    return elapsed > 0 ? m_bytes_hashed * 1000.0 / elapsed : 0.0;
+}
+
+void BatchHasher::executeTask()
+{
+    setStatus(tr("Hashing files..."));
+    setProgress(0, m_paths.size());
+    m_timer.start();
+
+    if (m_paths.isEmpty()) {
+        emitSucceeded();
+        return;
+    }
+
+    for (auto path : m_paths) {
+        auto watcher = new QFutureWatcher<FileResult>(this);
+        m_watchers.append(watcher);
+        connect(watcher, &QFutureWatcher<FileResult>::finished, this, [this, watcher, path] {
+            if (watcher->isCanceled() || m_aborted->load())
+                return;
+            onFileHashed(path, watcher->result());
+        });
+
+        watcher->setFuture(QtConcurrent::run(&m_pool, [path, algorithms = m_algorithms, aborted = m_aborted] {
+            FileResult result;
+            if (aborted->load())
+                return result;
+            result.size = QFileInfo(path).size();
+            result.digests = hashAll(path, algorithms);
+            return result;
+        }));
+    }
+}
+
+void BatchHasher::onFileHashed(const QString& file_path, const FileResult& result)
+{
+    m_done++;
+    if (result.digests.isEmpty()) {
+        // the other files are still worth their hashes, it's up to the caller what a missing one means
+        m_failed.append(file_path);
+        logWarning(tr("Failed to hash %1").arg(file_path));
+        emit fileFailed(file_path);
+    } else {
+        m_bytes_hashed += result.size;
+        m_results.insert(file_path, result.digests);
+        emit fileHashed(file_path, result.digests);
+    }
+
+    setProgress(m_done, m_paths.size());
+    setDetails(tr("%1/s").arg(StringUtils::humanReadableFileSize(throughput(), true)));
+
+    if (m_done < m_paths.size())
+        return;
+
+    qDebug() << "[Hashing]" << "Hashed" << m_results.size() << "files," << m_bytes_hashed << "bytes in" << m_timer.elapsed() << "ms,"
+             << m_failed.size() << "failed";
+    emitSucceeded();
+}
+
+bool BatchHasher::abort()
+{
+    m_aborted->store(true);
+    m_pool.clear();
+    for (auto watcher : m_watchers)
+        watcher->cancel();
+    emitAborted();
+    return true;
+}
+
 }  // namespace Hashing
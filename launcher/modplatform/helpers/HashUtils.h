@@ -1,9 +1,16 @@
 #pragma once
 
 #include <QCryptographicHash>
+#include <QElapsedTimer>
 #include <QFuture>
 #include <QFutureWatcher>
+#include <QHash>
+#include <QMap>
 #include <QString>
+#include <QThreadPool>
+
+#include <atomic>
+#include <memory>
 
 #include "modplatform/ModIndex.h"
 #include "tasks/Task.h"
@@ -18,6 +25,11 @@ QString hash(QIODevice* device, Algorithm type);
 QString hash(QString fileName, Algorithm type);
 QString hash(QByteArray data, Algorithm type);
 
+using Digests = QMap<Algorithm, QString>;
+
+/** Computes all the requested digests of the file in a single read of it. */
+Digests hashAll(QString fileName, QList<Algorithm> types);
+
 class Hasher : public Task {
     Q_OBJECT
    public:
@@ -45,6 +57,59 @@ class Hasher : public Task {
     QFutureWatcher<QString> m_watcher;
 };
 
+/**
+ * Hashes a batch of files, each one read only once for all the requested algorithms, on a bounded I/O pool.
+ * Files that can't be read are reported with fileFailed() and failedFiles(), the batch still succeeds with the others.
+ */
+class BatchHasher : public Task {
+    Q_OBJECT
+   public:
+    using Ptr = shared_qobject_ptr<BatchHasher>;
+
+    BatchHasher(QStringList file_paths, QList<Algorithm> algorithms, int max_concurrent_reads = 4);
+    ~BatchHasher() override;
+
+    bool canAbort() const override { return true; }
+    bool abort() override;
+
+    void executeTask() override;
+
+    Digests getResult(const QString& file_path) const { return m_results.value(file_path); }
+    QHash<QString, Digests> getResults() const { return m_results; }
+    QStringList failedFiles() const { return m_failed; }
+
+    qint64 bytesHashed() const { return m_bytes_hashed; }
+    // in bytes per second, over the whole batch
+    double throughput() const;
+
+   signals:
+    void fileHashed(QString file_path, Hashing::Digests digests);
+    void fileFailed(QString file_path);
+
+   private:
+    struct FileResult {
+        Digests digests;
+        qint64 size = 0;
+    };
+
+    void onFileHashed(const QString& file_path, const FileResult& result);
+
+    QStringList m_paths;
+    QList<Algorithm> m_algorithms;
+    QHash<QString, Digests> m_results;
+    QStringList m_failed;
+
+    QThreadPool m_pool;
+    std::shared_ptr<std::atomic_bool> m_aborted;
+    QList<QFutureWatcher<FileResult>*> m_watchers;
+    int m_done = 0;
+    qint64 m_bytes_hashed = 0;
+    QElapsedTimer m_timer;
+};
+
+// the algorithm the provider's API identifies files by
+Algorithm algorithmForProvider(ModPlatform::ResourceProvider provider);
+
 Hasher::Ptr createHasher(QString file_path, ModPlatform::ResourceProvider provider);
 Hasher::Ptr createHasher(QString file_path, QString type);
 
@@ -39,8 +39,8 @@ void ModrinthCheckUpdate::executeTask()
     setStatus(tr("Preparing mods for Modrinth..."));
     setProgress(0, 9);
 
-    auto hashing_task =
-        makeShared<ConcurrentTask>(this, "MakeModrinthHashesTask", APPLICATION->settings()->get("NumberOfConcurrentTasks").toInt());
+    QStringList paths_to_hash;
+    QHash<QString, Mod*> mods_by_path;
     for (auto* mod : m_mods) {
         auto hash = mod->metadata()->hash;
 
@@ -48,15 +48,23 @@ void ModrinthCheckUpdate::executeTask()
         // need to generate a new hash if the current one is innadequate
         // (though it will rarely happen, if at all)
         if (mod->metadata()->hash_format != m_hash_type) {
-            auto hash_task = Hashing::createHasher(mod->fileinfo().absoluteFilePath(), ModPlatform::ResourceProvider::MODRINTH);
-            connect(hash_task.get(), &Hashing::Hasher::resultsReady, [this, mod](QString hash) { m_mappings.insert(hash, mod); });
-            connect(hash_task.get(), &Task::failed, [this] { failed("Failed to generate hash"); });
-            hashing_task->addTask(hash_task);
+            auto path = mod->fileinfo().absoluteFilePath();
+            paths_to_hash.append(path);
+            mods_by_path.insert(path, mod);
         } else {
             m_mappings.insert(hash, mod);
         }
     }
 
+    auto algorithm = Hashing::algorithmForProvider(ModPlatform::ResourceProvider::MODRINTH);
+    auto hashing_task = makeShared<Hashing::BatchHasher>(paths_to_hash, QList<Hashing::Algorithm>{ algorithm },
+                                                         APPLICATION->settings()->get("NumberOfConcurrentTasks").toInt());
+    connect(hashing_task.get(), &Hashing::BatchHasher::fileHashed, this,
+            [this, mods_by_path, algorithm](QString path, Hashing::Digests digests) {
+                m_mappings.insert(digests.value(algorithm), mods_by_path.value(path));
+            });
+    connect(hashing_task.get(), &Hashing::BatchHasher::fileFailed, this, [this] { failed("Failed to generate hash"); });
+
     connect(hashing_task.get(), &Task::finished, this, &ModrinthCheckUpdate::checkNextLoader);
     m_job = hashing_task;
     hashing_task->start();
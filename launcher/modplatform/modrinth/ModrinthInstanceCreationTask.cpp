@@ -1,6 +1,7 @@
 #include "ModrinthInstanceCreationTask.h"
 
 #include "Application.h"
+#include "ContentStore.h"
 #include "FileSystem.h"
 #include "InstanceList.h"
 #include "Json.h"
@@ -244,6 +245,8 @@ bool ModrinthCreationTask::createInstance()
     auto root_modpack_path = FS::PathCombine(m_stagingPath, m_root_path);
     auto root_modpack_url = QUrl::fromLocalFile(root_modpack_path);
     QHash<QString, Mod*> mods;
+    auto store = APPLICATION->contentStore();
+    QList<Modrinth::File> downloaded;
     for (auto file : m_files) {
         auto fileName = file.path;
         fileName = FS::RemoveInvalidPathChars(fileName);
@@ -262,6 +265,12 @@ bool ModrinthCreationTask::createInstance()
             mods[file.hash.toHex()] = mod;
         }
 
+        if (store->materialize(file.hashAlgorithm, file.hash.toHex(), file_path)) {
+            qDebug() << "Reusing" << fileName << "from the content store";
+            continue;
+        }
+        downloaded.append(file);
+
         qDebug() << "Will try to download" << file.downloads.front() << "to" << file_path;
         auto dl = Net::ApiDownload::makeFile(file.downloads.dequeue(), file_path);
         dl->addValidator(new Net::ChecksumValidator(file.hashAlgorithm, file.hash));
@@ -301,6 +310,12 @@ bool ModrinthCreationTask::createInstance()
 
     loop.exec();
 
+    // only now are all the files known to match their hashes, fallback downloads included
+    if (ended_well) {
+        for (auto& file : downloaded)
+            store->add(file.hashAlgorithm, file.hash.toHex(), FS::PathCombine(root_modpack_path, FS::RemoveInvalidPathChars(file.path)));
+    }
+
     QEventLoop ensureMetaLoop;
     QDir folder = FS::PathCombine(instance.modsRoot(), ".index");
     auto ensureMetadataTask = makeShared<EnsureMetadataTask>(mods, folder, ModPlatform::ResourceProvider::MODRINTH);
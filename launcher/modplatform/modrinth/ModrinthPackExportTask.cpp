@@ -23,6 +23,7 @@
 #include <QFileInfo>
 #include <QMessageBox>
 #include <QtConcurrentRun>
+#include "Application.h"
 #include "Json.h"
 #include "MMCZip.h"
 #include "minecraft/PackProfile.h"
@@ -93,9 +94,15 @@ void ModrinthPackExportTask::collectFiles()
 void ModrinthPackExportTask::collectHashes()
 {
     setStatus(tr("Finding file hashes..."));
-    for (const QFileInfo& file : files) {
-        QCoreApplication::processEvents();
 
+    QHash<QString, const Mod*> modsByPath;
+    if (mcInstance) {
+        for (auto* mod : mcInstance->loaderModList()->allMods())
+            modsByPath.insert(mod->fileinfo().absoluteFilePath(), mod);
+    }
+
+    QStringList paths;
+    for (const QFileInfo& file : files) {
         const QString relative = gameRoot.relativeFilePath(file.absoluteFilePath());
         // require sensible file types
         if (!std::any_of(PREFIXES.begin(), PREFIXES.end(), [&relative](const QString& prefix) { return relative.startsWith(prefix); }))
@@ -104,48 +111,46 @@ void ModrinthPackExportTask::collectHashes()
                 return relative.endsWith('.' + extension) || relative.endsWith('.' + extension + ".disabled");
             }))
             continue;
+        paths.append(file.absoluteFilePath());
+    }
 
-        QFile openFile(file.absoluteFilePath());
-        if (!openFile.open(QFile::ReadOnly)) {
-            qWarning() << "Could not open" << file << "for hashing";
-            continue;
-        }
+    // both digests are computed in the same read of each file, sha1 is needed for the files resolved from the local metadata
+    auto hasher = makeShared<Hashing::BatchHasher>(paths, QList<Hashing::Algorithm>{ Hashing::Algorithm::Sha512, Hashing::Algorithm::Sha1 },
+                                                   APPLICATION->settings()->get("NumberOfConcurrentTasks").toInt());
+    connect(hasher.get(), &Hashing::BatchHasher::fileHashed, this, [this, modsByPath](QString path, Hashing::Digests digests) {
+        const QString relative = gameRoot.relativeFilePath(path);
+        auto sha512 = digests.value(Hashing::Algorithm::Sha512);
 
-        const QByteArray data = openFile.readAll();
-        if (openFile.error() != QFileDevice::NoError) {
-            qWarning() << "Could not read" << file;
-            continue;
-        }
-        auto sha512 = Hashing::hash(data, Hashing::Algorithm::Sha512);
-
-        auto allMods = mcInstance->loaderModList()->allMods();
-        if (auto modIter = std::find_if(allMods.begin(), allMods.end(), [&file](Mod* mod) { return mod->fileinfo() == file; });
-            modIter != allMods.end()) {
-            const Mod* mod = *modIter;
-            if (mod->metadata() != nullptr) {
-                QUrl& url = mod->metadata()->url;
-                // ensure the url is permitted on modrinth.com
-                if (!url.isEmpty() && BuildConfig.MODRINTH_MRPACK_HOSTS.contains(url.host())) {
-                    qDebug() << "Resolving" << relative << "from index";
-
-                    auto sha1 = Hashing::hash(data, Hashing::Algorithm::Sha1);
-
-                    ResolvedFile resolvedFile{ sha1, sha512, url.toEncoded(), openFile.size(), mod->metadata()->side };
-                    resolvedFiles[relative] = resolvedFile;
-
-                    // nice! we've managed to resolve based on local metadata!
-                    // no need to enqueue it
-                    continue;
-                }
+        if (const Mod* mod = modsByPath.value(path); mod && mod->metadata() != nullptr) {
+            QUrl& url = mod->metadata()->url;
+            // ensure the url is permitted on modrinth.com
+            if (!url.isEmpty() && BuildConfig.MODRINTH_MRPACK_HOSTS.contains(url.host())) {
+                qDebug() << "Resolving" << relative << "from index";
+
+                auto sha1 = digests.value(Hashing::Algorithm::Sha1);
+
+                ResolvedFile resolvedFile{ sha1, sha512, url.toEncoded(), QFileInfo(path).size(), mod->metadata()->side };
+                resolvedFiles[relative] = resolvedFile;
+
+                // nice! we've managed to resolve based on local metadata!
+                // no need to enqueue it
+                return;
             }
         }
 
         qDebug() << "Enqueueing" << relative << "for Modrinth query";
         pendingHashes[relative] = sha512;
-    }
+    });
+    connect(hasher.get(), &Hashing::BatchHasher::fileFailed, this,
+            [](QString path) { qWarning() << "Could not read" << path << "for hashing"; });
+    // files that couldn't be read are simply left out, like they always were
+    connect(hasher.get(), &Task::succeeded, this, &ModrinthPackExportTask::makeApiRequest);
+    connect(hasher.get(), &Task::failed, this, &ModrinthPackExportTask::makeApiRequest);
+    connect(hasher.get(), &Task::progress, this, &ModrinthPackExportTask::setProgress);
 
     setAbortable(true);
-    makeApiRequest();
+    task = hasher;
+    hasher->start();
 }
 
 void ModrinthPackExportTask::makeApiRequest()
@@ -34,11 +34,15 @@ class ApiHeaderProxy : public HeaderProxy {
     virtual QList<HeaderPair> headers(const QNetworkRequest& request) const override
     {
         QList<HeaderPair> hdrs;
-        if (APPLICATION->capabilities() & Application::SupportsFlame && request.url().host() == QUrl(BuildConfig.FLAME_BASE_URL).host()) {
-            hdrs.append({ "x-api-key", APPLICATION->getFlameAPIKey().toUtf8() });
+        // no keys without the launcher around the request, like in the tests
+        auto application = qobject_cast<Application*>(QCoreApplication::instance());
+        if (!application)
+            return hdrs;
+        if (application->capabilities() & Application::SupportsFlame && request.url().host() == QUrl(BuildConfig.FLAME_BASE_URL).host()) {
+            hdrs.append({ "x-api-key", application->getFlameAPIKey().toUtf8() });
         } else if (request.url().host() == QUrl(BuildConfig.MODRINTH_PROD_URL).host() ||
                    request.url().host() == QUrl(BuildConfig.MODRINTH_STAGING_URL).host()) {
-            QString token = APPLICATION->getModrinthAPIToken();
+            QString token = application->getModrinthAPIToken();
             if (!token.isNull())
                 hdrs.append({ "Authorization", token.toUtf8() });
         }
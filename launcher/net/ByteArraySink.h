@@ -80,13 +80,26 @@ class ByteArraySink : public Sink {
 
     auto finalize(QNetworkReply& reply) -> Task::State override
     {
-        if (finalizeAllValidators(reply))
+        if (finalizeAllValidators(&reply))
             return Task::State::Succeeded;
         return Task::State::Failed;
     }
 
     auto hasLocalData() -> bool override { return false; }
 
+    auto result() const -> QByteArray override { return m_output ? *m_output : QByteArray(); }
+
+    bool adopt(const QByteArray& data) override
+    {
+        QNetworkRequest request;
+        auto copy = data;
+        if (!initAllValidators(request) || !writeAllValidators(copy) || !finalizeAllValidators(nullptr))
+            return false;
+        if (m_output)
+            *m_output = data;
+        return true;
+    }
+
    private:
     std::shared_ptr<QByteArray> m_output;
 };
@@ -69,7 +69,7 @@ class ChecksumValidator : public Validator {
         return true;
     }
 
-    auto validate(QNetworkReply&) -> bool override
+    auto validate(QNetworkReply*) -> bool override
     {
         if (m_expected.size() && m_expected != hash()) {
             qWarning() << "Checksum mismatch, download is bad.";
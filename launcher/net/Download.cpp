@@ -87,4 +87,14 @@ QNetworkReply* Download::getReply(QNetworkRequest& request)
 {
     return m_network->get(request);
 }
+
+QString Download::schedulerKey() const
+{
+    // downloads of the same URL into the same file wait for each other, and then take over the first one's result
+    auto target = m_sink->target();
+    if (!target.isEmpty())
+        return m_url.toString() + '\n' + target;
+    // the ones kept in memory can share it wherever it goes, unless their headers can make the responses differ
+    return m_headerProxies.empty() ? m_url.toString() : QString();
+}
 }  // namespace Net
@@ -59,5 +59,6 @@ class Download : public NetRequest {
 
    protected:
     virtual QNetworkReply* getReply(QNetworkRequest&) override;
+    QString schedulerKey() const override;
 };
 }  // namespace Net
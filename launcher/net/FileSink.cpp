@@ -35,12 +35,93 @@
 
 #include "FileSink.h"
 
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDirIterator>
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <QJsonObject>
+
 #include "FileSystem.h"
 
 #include "net/Logging.h"
 
 namespace Net {
 
+namespace {
+// the data read back from a partial file at once, to catch the validators up with it
+const qint64 s_rehash_chunk_size = 1024 * 1024;
+
+QString& partialFolder()
+{
+    static QString s_folder;
+    return s_folder;
+}
+
+qint64 contentRangeStart(QNetworkReply& reply)
+{
+    // Content-Range: bytes <first>-<last>/<total>
+    auto range = reply.rawHeader("Content-Range").trimmed();
+    if (!range.startsWith("bytes "))
+        return -1;
+    bool ok = false;
+    auto start = range.mid(6, range.indexOf('-') - 6).toLongLong(&ok);
+    return ok ? start : -1;
+}
+}  // namespace
+
+void FileSink::setPartialFolder(const QString& folder)
+{
+    partialFolder() = folder;
+}
+
+void FileSink::expirePartials(qint64 max_age_secs)
+{
+    if (partialFolder().isEmpty())
+        return;
+    auto now = QDateTime::currentDateTime();
+    QDirIterator it(partialFolder(), QDir::Files);
+    while (it.hasNext()) {
+        it.next();
+        if (it.fileInfo().lastModified().secsTo(now) > max_age_secs)
+            QFile::remove(it.filePath());
+    }
+}
+
+QString FileSink::partialPath() const
+{
+    QFileInfo target(m_filename);
+    if (partialFolder().isEmpty())
+        return FS::PathCombine(target.path(), "." + target.fileName() + ".part");
+    auto key = QCryptographicHash::hash(target.absoluteFilePath().toUtf8(), QCryptographicHash::Sha1).toHex();
+    return FS::PathCombine(partialFolder(), key + ".part");
+}
+
+void FileSink::discardPartial()
+{
+    // only once the download is over, whatever is still writing the partial file owns it
+    if (m_output_file)
+        return;
+    QFile::remove(partialPath());
+    QFile::remove(journalPath());
+    m_resume_from = 0;
+}
+
+bool FileSink::adopt(const QByteArray&)
+{
+    // the identical request wrote into our target, so what is there now is what we would have downloaded
+    QFile file(m_filename);
+    QNetworkRequest request;
+    if (!file.open(QIODevice::ReadOnly) || !initAllValidators(request))
+        return false;
+    while (!file.atEnd()) {
+        auto chunk = file.read(s_rehash_chunk_size);
+        if (chunk.isEmpty() || !writeAllValidators(chunk))
+            return false;
+    }
+    return finalizeAllValidators(nullptr);
+}
+
 Task::State FileSink::init(QNetworkRequest& request)
 {
     auto result = initCache(request);
@@ -48,17 +129,46 @@ Task::State FileSink::init(QNetworkRequest& request)
         return result;
     }
 
-    // create a new save file and open it for writing
-    if (!FS::ensureFilePathExists(m_filename)) {
+    if (!FS::ensureFilePathExists(m_filename) || !FS::ensureFilePathExists(partialPath())) {
         qCCritical(taskNetLogC) << "Could not create folder for " + m_filename;
         return Task::State::Failed;
     }
 
+    // following a redirect, nothing was written since the partial file got picked up so keep resuming it
+    bool redirected = m_resume_from > 0 && !m_started;
+
     wroteAnyData = false;
-    m_output_file.reset(new QSaveFile(m_filename));
-    if (!m_output_file->open(QIODevice::WriteOnly)) {
-        qCCritical(taskNetLogC) << "Could not open " + m_filename + " for writing";
-        return Task::State::Failed;
+    m_url = request.url().toString();
+    m_resuming = false;
+    m_started = false;
+    m_range_validator.clear();
+    m_accepts_ranges = false;
+
+    // only decide whether to pick up the partial file an interrupted download of the same URL left behind, it is
+    // opened once the response arrives, so a request that never gets that far leaves it alone
+    if (!redirected) {
+        m_resume_from = 0;
+        m_output_file.reset();
+
+        QFile journal_file(journalPath());
+        if (journal_file.open(QIODevice::ReadOnly)) {
+            auto journal = QJsonDocument::fromJson(journal_file.readAll()).object();
+            journal_file.close();
+
+            auto size = static_cast<qint64>(journal.value("size").toDouble());
+            m_resume_validator = journal.value("validator").toString().toLatin1();
+            if (journal.value("url").toString() == m_url && !m_resume_validator.isEmpty() && size > 0 &&
+                QFileInfo(partialPath()).size() == size) {
+                qCDebug(taskNetLogC) << "Resuming download of" << m_url << "from byte" << size;
+                m_resume_from = size;
+            }
+        }
+    }
+
+    if (m_resume_from > 0) {
+        // if the file changed on the server since, If-Range gets us all of it instead
+        request.setRawHeader("Range", "bytes=" + QByteArray::number(m_resume_from) + "-");
+        request.setRawHeader("If-Range", m_resume_validator);
     }
 
     if (initAllValidators(request))
@@ -66,12 +176,55 @@ Task::State FileSink::init(QNetworkRequest& request)
     return Task::State::Failed;
 }
 
+void FileSink::headersReceived(QNetworkReply& reply)
+{
+    auto status = reply.attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+    m_resuming = m_resume_from > 0 && status == 206 && contentRangeStart(reply) == m_resume_from;
+
+    // If-Range only works with strong validators
+    auto etag = reply.rawHeader("ETag");
+    m_range_validator = !etag.isEmpty() && !etag.startsWith("W/") ? etag : reply.rawHeader("Last-Modified");
+    m_accepts_ranges = m_resuming || (status == 200 && reply.rawHeader("Accept-Ranges").trimmed() == "bytes");
+}
+
+bool FileSink::startWriting()
+{
+    // the journal only describes a partial file nothing is writing to
+    QFile::remove(journalPath());
+
+    m_output_file.reset(new QFile(partialPath()));
+    if (!m_resuming) {
+        // the server sends the whole thing (again)
+        m_resume_from = 0;
+        return m_output_file->open(QIODevice::WriteOnly | QIODevice::Truncate);
+    }
+
+    // the validators have to see the data we already have, before the rest of it
+    if (!m_output_file->open(QIODevice::ReadWrite) || m_output_file->size() != m_resume_from)
+        return false;
+    while (m_output_file->pos() < m_resume_from) {
+        auto chunk = m_output_file->read(qMin(s_rehash_chunk_size, m_resume_from - m_output_file->pos()));
+        if (chunk.isEmpty() || !writeAllValidators(chunk))
+            return false;
+    }
+    wroteAnyData = true;
+    return true;
+}
+
 Task::State FileSink::write(QByteArray& data)
 {
+    if (!m_started) {
+        m_started = true;
+        if (!startWriting()) {
+            qCCritical(taskNetLogC) << "Failed to pick up the partial download in " + partialPath();
+            dropPartial();
+            return Task::State::Failed;
+        }
+    }
+
     if (!writeAllValidators(data) || m_output_file->write(data) != data.size()) {
-        qCCritical(taskNetLogC) << "Failed writing into " + m_filename;
-        m_output_file->cancelWriting();
-        m_output_file.reset();
+        qCCritical(taskNetLogC) << "Failed writing into " + partialPath();
+        dropPartial();
         wroteAnyData = false;
         return Task::State::Failed;
     }
@@ -82,8 +235,30 @@ Task::State FileSink::write(QByteArray& data)
 
 Task::State FileSink::abort()
 {
-    m_output_file->cancelWriting();
     failAllValidators();
+    if (!m_output_file) {
+        m_resume_from = 0;
+        return Task::State::Failed;
+    }
+
+    // keep what we got, if the next attempt can ask for just the rest of it
+    if (wroteAnyData && m_accepts_ranges && !m_range_validator.isEmpty() && m_output_file->flush()) {
+        QJsonObject journal{ { "url", m_url },
+                             { "validator", QString::fromLatin1(m_range_validator) },
+                             { "size", static_cast<double>(m_output_file->size()) } };
+        m_output_file->close();
+        try {
+            FS::write(journalPath(), QJsonDocument(journal).toJson(QJsonDocument::Compact));
+            qCDebug(taskNetLogC) << "Kept" << journal.value("size").toDouble() << "bytes of" << m_url << "to resume from";
+            m_output_file.reset();
+            m_resume_from = 0;
+            return Task::State::Failed;
+        } catch (const Exception& e) {
+            qCWarning(taskNetLogC) << "Failed to write the download journal:" << e.what();
+        }
+    }
+
+    dropPartial();
     return Task::State::Failed;
 }
 
@@ -95,31 +270,59 @@ Task::State FileSink::finalize(QNetworkReply& reply)
     int statusCode = statusCodeV.toInt(&validStatus);
     if (validStatus) {
         // this leaves out 304 Not Modified
-        gotFile = statusCode == 200 || statusCode == 203;
+        gotFile = statusCode == 200 || statusCode == 203 || (statusCode == 206 && m_resuming);
     }
 
-    // if we wrote any data to the save file, we try to commit the data to the real file.
+    // if we wrote any data to the partial file, we try to move it over the real file.
     // if it actually got a proper file, we write it even if it was empty
     if (gotFile || wroteAnyData) {
+        // a response without a body still replaces (or completes) what is in the partial file
+        if (!m_started) {
+            m_started = true;
+            if (!startWriting()) {
+                qCCritical(taskNetLogC) << "Failed to pick up the partial download in " + partialPath();
+                dropPartial();
+                return Task::State::Failed;
+            }
+        }
+
         // ask validators for data consistency
         // we only do this for actual downloads, not 'your data is still the same' cache hits
-        if (!finalizeAllValidators(reply))
+        if (!finalizeAllValidators(&reply)) {
+            dropPartial();
             return Task::State::Failed;
+        }
 
         // nothing went wrong...
-        if (!m_output_file->commit()) {
+        bool flushed = m_output_file->flush();
+        m_output_file->close();
+        if (!flushed || !FS::move(partialPath(), m_filename)) {
             qCCritical(taskNetLogC) << "Failed to commit changes to " << m_filename;
-            m_output_file->cancelWriting();
+            dropPartial();
             return Task::State::Failed;
         }
+    } else {
+        dropPartial();
     }
 
-    // then get rid of the save file
+    // then get rid of the partial file
     m_output_file.reset();
+    m_resume_from = 0;
 
     return finalizeCache(reply);
 }
 
+void FileSink::dropPartial()
+{
+    // a partial file this sink didn't open isn't ours to remove
+    if (m_output_file) {
+        m_output_file->remove();
+        m_output_file.reset();
+        QFile::remove(journalPath());
+    }
+    m_resume_from = 0;
+}
+
 Task::State FileSink::initCache(QNetworkRequest&)
 {
     return Task::State::Running;
@@ -35,11 +35,21 @@
 
 #pragma once
 
-#include <QSaveFile>
+#include <QFile>
 
 #include "Sink.h"
 
 namespace Net {
+/*
+ * Sink object for downloads into a file.
+ *
+ * The data goes into a partial file, which replaces the target once the download succeeded.
+ * If the download gets interrupted and the server supports ranges, the partial file is kept along with a small
+ * journal, so the next attempt at the same URL only asks for the missing part.
+ *
+ * Partial files live in the launcher's own folder for them, named after the target, so an interrupted download never
+ * leaves anything behind in an instance. Without that folder they are hidden files next to the target.
+ */
 class FileSink : public Sink {
    public:
     FileSink(QString filename) : m_filename(filename) {};
@@ -52,14 +62,43 @@ class FileSink : public Sink {
     auto finalize(QNetworkReply& reply) -> Task::State override;
 
     auto hasLocalData() -> bool override;
+    auto target() const -> QString override { return m_filename; }
+    void headersReceived(QNetworkReply& reply) override;
+    void discardPartial() override;
+    bool adopt(const QByteArray&) override;
+
+    QString partialPath() const;
+    QString journalPath() const { return partialPath() + ".json"; }
+
+    /** Where partial files go from now on. */
+    static void setPartialFolder(const QString& folder);
+    /** Removes the partial files nothing resumed for that long, like the ones of downloads that were never retried. */
+    static void expirePartials(qint64 max_age_secs);
 
    protected:
     virtual auto initCache(QNetworkRequest&) -> Task::State;
     virtual auto finalizeCache(QNetworkReply& reply) -> Task::State;
 
+   private:
+    bool startWriting();
+    void dropPartial();
+
    protected:
     QString m_filename;
     bool wroteAnyData = false;
-    std::unique_ptr<QSaveFile> m_output_file;
+    std::unique_ptr<QFile> m_output_file;
+
+   private:
+    QString m_url;
+    /// bytes of the partial file the request asked the server to skip
+    qint64 m_resume_from = 0;
+    QByteArray m_resume_validator;
+    /// whether the server agreed to that
+    bool m_resuming = false;
+    bool m_started = false;
+
+    /// what the current response allows resuming it with, if it gets interrupted
+    QByteArray m_range_validator;
+    bool m_accepts_ranges = false;
 };
 }  // namespace Net
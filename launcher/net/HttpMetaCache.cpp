@@ -38,6 +38,7 @@
 #include "Json.h"
 
 #include <QCryptographicHash>
+#include <QDataStream>
 #include <QDateTime>
 #include <QFile>
 #include <QFileInfo>
@@ -46,13 +47,28 @@
 
 #include "net/Logging.h"
 
+namespace {
+const quint32 s_binary_index_magic = 0x504d4331;  // "PMC1"
+const quint32 s_binary_index_version = 1;
+
+enum class RecordType : quint8 { Update = 0, Removal = 1 };
+
+// compact once the journal holds this many records, so replaying it stays cheap
+const int s_max_journal_records = 4096;
+}  // namespace
+
 auto MetaEntry::getFullPath() -> QString
 {
     // FIXME: make local?
     return FS::PathCombine(m_basePath, m_relativePath);
 }
 
-HttpMetaCache::HttpMetaCache(QString path) : QObject(), m_index_file(path)
+HttpMetaCache::HttpMetaCache(QString path)
+    : QObject()
+    , m_index_file(path)
+    , m_binary_index_file(path.isNull() ? QString() : path + ".bin")
+    , m_journal_file(path.isNull() ? QString() : path + ".journal")
+    , m_digests(path.isNull() ? QString() : path + ".digests")
 {
     saveBatchingTimer.setSingleShot(true);
     saveBatchingTimer.setTimerType(Qt::VeryCoarseTimer);
@@ -64,10 +80,14 @@ HttpMetaCache::~HttpMetaCache()
 {
     saveBatchingTimer.stop();
     SaveNow();
+    if (!m_index_file.isNull() && !m_load_pending && m_json_outdated)
+        compact(true);
 }
 
 auto HttpMetaCache::getEntry(QString base, QString resource_path) -> MetaEntryPtr
 {
+    ensureLoaded();
+
     // no base. no base path. can't store
     if (!m_entries.contains(base)) {
         // TODO: log problem
@@ -98,30 +118,28 @@ auto HttpMetaCache::resolveEntry(QString base, QString resource_path, QString ex
     // is the file really there? if not -> stale
     if (!finfo.isFile() || !finfo.isReadable()) {
         // if the file doesn't exist, we disown the entry
-        selected_base.entry_list.remove(resource_path);
+        removeEntry(base, resource_path);
         return staleEntry(base, resource_path);
     }
 
     if (!expected_etag.isEmpty() && expected_etag != entry->m_etag) {
         // if the etag doesn't match expected, we disown the entry
-        selected_base.entry_list.remove(resource_path);
+        removeEntry(base, resource_path);
         return staleEntry(base, resource_path);
     }
 
     // if the file changed, check md5sum
     qint64 file_last_changed = finfo.lastModified().toUTC().toMSecsSinceEpoch();
     if (file_last_changed != entry->m_local_changed_timestamp) {
-        QFile input(real_path);
-        input.open(QIODevice::ReadOnly);
-        QString md5sum = QCryptographicHash::hash(input.readAll(), QCryptographicHash::Md5).toHex().constData();
+        QString md5sum = m_digests.digest(real_path, QCryptographicHash::Md5);
         if (entry->m_md5sum != md5sum) {
-            selected_base.entry_list.remove(resource_path);
+            removeEntry(base, resource_path);
             return staleEntry(base, resource_path);
         }
 
         // md5sums matched... keep entry and save the new state to file
         entry->m_local_changed_timestamp = file_last_changed;
-        SaveEventually();
+        markDirty(entry);
     }
 
     // Get rid of old entries, to prevent cache problems
@@ -129,7 +147,7 @@ auto HttpMetaCache::resolveEntry(QString base, QString resource_path, QString ex
     if (entry->isExpired(current_time - (file_last_changed / 1000))) {
         qCWarning(taskNetLogC) << "[HttpMetaCache]"
                                << "Removing cache entry because of old age!";
-        selected_base.entry_list.remove(resource_path);
+        removeEntry(base, resource_path);
         return staleEntry(base, resource_path);
     }
 
@@ -140,6 +158,8 @@ auto HttpMetaCache::resolveEntry(QString base, QString resource_path, QString ex
 
 auto HttpMetaCache::updateEntry(MetaEntryPtr stale_entry) -> bool
 {
+    ensureLoaded();
+
     if (!m_entries.contains(stale_entry->m_baseId)) {
         qCCritical(taskHttpMetaCacheLogC) << "Cannot add entry with unknown base: " << stale_entry->m_baseId.toLocal8Bit();
         return false;
@@ -151,7 +171,9 @@ auto HttpMetaCache::updateEntry(MetaEntryPtr stale_entry) -> bool
     }
 
     m_entries[stale_entry->m_baseId].entry_list[stale_entry->m_relativePath] = stale_entry;
-    SaveEventually();
+    // the sink already hashed the file while writing it, no need to read it again later
+    m_digests.insert(stale_entry->getFullPath(), QCryptographicHash::Md5, stale_entry->m_md5sum.toLatin1());
+    markDirty(stale_entry);
 
     return true;
 }
@@ -162,12 +184,15 @@ auto HttpMetaCache::evictEntry(MetaEntryPtr entry) -> bool
         return false;
 
     entry->m_stale = true;
-    SaveEventually();
+    m_digests.remove(entry->getFullPath());
+    markDirty(entry);
     return true;
 }
 
 void HttpMetaCache::evictAll()
 {
+    ensureLoaded();
+
     for (QString& base : m_entries.keys()) {
         EntryMap& map = m_entries[base];
         qCDebug(taskHttpMetaCacheLogC) << "Evicting base" << base;
@@ -178,6 +203,10 @@ void HttpMetaCache::evictAll()
         map.entry_list.clear();
         FS::deletePath(map.base_path);
     }
+
+    // everything is gone, rewriting the index is cheaper than journaling every removal
+    m_dirty.clear();
+    m_needs_compaction = true;
 }
 
 auto HttpMetaCache::staleEntry(QString base, QString resource_path) -> MetaEntryPtr
@@ -191,6 +220,20 @@ auto HttpMetaCache::staleEntry(QString base, QString resource_path) -> MetaEntry
     return MetaEntryPtr(foo);
 }
 
+void HttpMetaCache::removeEntry(QString base, QString resource_path)
+{
+    m_entries[base].entry_list.remove(resource_path);
+    m_digests.remove(FS::PathCombine(getBasePath(base), resource_path));
+    m_dirty.insert({ base, resource_path }, nullptr);
+    SaveEventually();
+}
+
+void HttpMetaCache::markDirty(MetaEntryPtr entry)
+{
+    m_dirty.insert({ entry->m_baseId, entry->m_relativePath }, entry);
+    SaveEventually();
+}
+
 void HttpMetaCache::addBase(QString base, QString base_root)
 {
     // TODO: report error
@@ -217,6 +260,132 @@ void HttpMetaCache::Load()
     if (m_index_file.isNull())
         return;
 
+    m_load_pending = true;
+}
+
+void HttpMetaCache::ensureLoaded()
+{
+    if (!m_load_pending)
+        return;
+    m_load_pending = false;
+
+    m_digests.load();
+
+    // the JSON index is written before the binary one, so it's only newer if an older version of the launcher used it since
+    QFileInfo json_info(m_index_file);
+    QFileInfo binary_info(m_binary_index_file);
+    bool json_newer = json_info.isFile() && binary_info.isFile() && json_info.lastModified() > binary_info.lastModified();
+
+    if (json_newer || !loadBinary()) {
+        // first run with the binary index (or it got corrupted or outdated), import the JSON one and write it out in the new format
+        for (auto& map : m_entries)
+            map.entry_list.clear();
+        m_journal_records = 0;
+        loadJson();
+        m_needs_compaction = true;
+        SaveEventually();
+    }
+}
+
+void HttpMetaCache::writeRecord(QDataStream& out, const QString& base, const QString& path, const MetaEntry* entry)
+{
+    if (!entry) {
+        out << quint8(RecordType::Removal) << base << path;
+        return;
+    }
+
+    out << quint8(RecordType::Update) << base << path << entry->m_md5sum << entry->m_etag << entry->m_local_changed_timestamp
+        << entry->m_remote_changed_timestamp << entry->m_is_eternal << entry->m_current_age << entry->m_max_age;
+}
+
+bool HttpMetaCache::readRecord(QDataStream& in, MetaEntry& entry, bool& removed)
+{
+    quint8 type = 0xff;
+    in >> type >> entry.m_baseId >> entry.m_relativePath;
+    removed = type == quint8(RecordType::Removal);
+    if (!removed) {
+        in >> entry.m_md5sum >> entry.m_etag >> entry.m_local_changed_timestamp >> entry.m_remote_changed_timestamp >>
+            entry.m_is_eternal >> entry.m_current_age >> entry.m_max_age;
+    }
+    return in.status() == QDataStream::Ok && type <= quint8(RecordType::Removal);
+}
+
+bool HttpMetaCache::loadBinary()
+{
+    QFile index(m_binary_index_file);
+    if (!index.open(QIODevice::ReadOnly))
+        return false;
+
+    QDataStream in(&index);
+    in.setVersion(QDataStream::Qt_5_12);
+
+    quint32 magic, version, count;
+    in >> magic >> version >> count;
+    if (in.status() != QDataStream::Ok || magic != s_binary_index_magic || version != s_binary_index_version) {
+        qCWarning(taskHttpMetaCacheLogC) << "Ignoring incompatible binary metacache index" << m_binary_index_file;
+        return false;
+    }
+
+    for (quint32 i = 0; i < count; i++) {
+        auto foo = new MetaEntry();
+        bool removed;
+        if (!readRecord(in, *foo, removed) || removed) {
+            delete foo;
+            qCWarning(taskHttpMetaCacheLogC) << "Binary metacache index" << m_binary_index_file << "is corrupted";
+            for (auto& map : m_entries)
+                map.entry_list.clear();
+            return false;
+        }
+
+        if (!m_entries.contains(foo->m_baseId)) {
+            delete foo;
+            continue;
+        }
+
+        // presumed innocent until closer examination
+        foo->m_stale = false;
+        m_entries[foo->m_baseId].entry_list[foo->m_relativePath] = MetaEntryPtr(foo);
+    }
+
+    // replay the changes made since the last compaction
+    QFile journal(m_journal_file);
+    if (journal.open(QIODevice::ReadOnly)) {
+        QDataStream journal_in(&journal);
+        journal_in.setVersion(QDataStream::Qt_5_12);
+        while (!journal_in.atEnd()) {
+            auto foo = new MetaEntry();
+            bool removed;
+            if (!readRecord(journal_in, *foo, removed)) {
+                // a partially written record at the end, from a crash in the middle of a save
+                delete foo;
+                qCWarning(taskHttpMetaCacheLogC) << "Ignoring truncated metacache journal tail";
+                m_needs_compaction = true;
+                break;
+            }
+            m_journal_records++;
+
+            if (!m_entries.contains(foo->m_baseId)) {
+                delete foo;
+                continue;
+            }
+
+            auto& entrymap = m_entries[foo->m_baseId];
+            if (removed) {
+                entrymap.entry_list.remove(foo->m_relativePath);
+                delete foo;
+                continue;
+            }
+
+            foo->m_stale = false;
+            entrymap.entry_list[foo->m_relativePath] = MetaEntryPtr(foo);
+        }
+    }
+
+    return true;
+}
+
+void HttpMetaCache::loadJson()
+{
     QFile index(m_index_file);
     if (!index.open(QIODevice::ReadOnly))
         return;
@@ -285,11 +454,90 @@ void HttpMetaCache::SaveEventually()
 
 void HttpMetaCache::SaveNow()
 {
-    if (m_index_file.isNull())
+    if (m_index_file.isNull() || m_load_pending)
         return;
 
-    qCDebug(taskHttpMetaCacheLogC) << "Saving metacache with" << m_entries.size() << "entries";
+    if (m_needs_compaction || m_journal_records + m_dirty.size() > s_max_journal_records) {
+        compact();
+    } else if (!m_dirty.isEmpty()) {
+        appendJournal();
+    }
 
+    m_digests.save();
+}
+
+void HttpMetaCache::appendJournal()
+{
+    qCDebug(taskHttpMetaCacheLogC) << "Journaling" << m_dirty.size() << "metacache changes";
+
+    QByteArray data;
+    QDataStream out(&data, QIODevice::WriteOnly);
+    out.setVersion(QDataStream::Qt_5_12);
+    for (auto it = m_dirty.constBegin(); it != m_dirty.constEnd(); ++it) {
+        auto entry = it.value();
+        // do not save stale entries. they are dead.
+        writeRecord(out, it.key().first, it.key().second, entry && !entry->m_stale ? entry.get() : nullptr);
+    }
+
+    try {
+        FS::append(m_journal_file, data);
+        m_journal_records += m_dirty.size();
+        m_dirty.clear();
+        m_json_outdated = true;
+    } catch (const Exception& e) {
+        qCWarning(taskHttpMetaCacheLogC) << "Error writing cache journal:" << e.what();
+        m_needs_compaction = true;
+    }
+}
+
+void HttpMetaCache::compact(bool export_json)
+{
+    int count = 0;
+    for (auto& group : m_entries)
+        count += group.entry_list.size();
+    qCDebug(taskHttpMetaCacheLogC) << "Saving metacache with" << count << "entries";
+
+    QByteArray data;
+    QDataStream out(&data, QIODevice::WriteOnly);
+    out.setVersion(QDataStream::Qt_5_12);
+    out << s_binary_index_magic << s_binary_index_version << quint32(0);
+
+    // QMap keeps both levels sorted, so the records end up ordered by (base, path)
+    quint32 written = 0;
+    for (auto& group : m_entries) {
+        for (auto& entry : group.entry_list) {
+            // do not save stale entries. they are dead.
+            if (entry->m_stale) {
+                continue;
+            }
+            writeRecord(out, entry->m_baseId, entry->m_relativePath, entry.get());
+            written++;
+        }
+    }
+
+    // patch in the real record count
+    out.device()->seek(2 * sizeof(quint32));
+    out << written;
+
+    // first, so the binary index is never older than a JSON index this version wrote
+    bool exported = export_json && exportJson();
+
+    try {
+        FS::write(m_binary_index_file, data);
+    } catch (const Exception& e) {
+        qCWarning(taskHttpMetaCacheLogC) << "Error writing cache:" << e.what();
+        return;
+    }
+
+    QFile::remove(m_journal_file);
+    m_journal_records = 0;
+    m_needs_compaction = false;
+    m_dirty.clear();
+    m_json_outdated = !exported;
+}
+
+bool HttpMetaCache::exportJson()
+{
     QJsonObject toplevel;
     Json::writeString(toplevel, "version", "1");
 
@@ -324,5 +572,7 @@ void HttpMetaCache::SaveNow()
         Json::write(toplevel, m_index_file);
     } catch (const Exception& e) {
         qCWarning(taskHttpMetaCacheLogC) << "Error writing cache:" << e.what();
+        return false;
     }
+    return true;
 }
@@ -35,11 +35,15 @@
 
 #pragma once
 
+#include <QDataStream>
 #include <QMap>
+#include <QPair>
 #include <QString>
 #include <QTimer>
 #include <memory>
 
+#include "FileDigestCache.h"
+
 class HttpMetaCache;
 
 class MetaEntry {
@@ -119,23 +123,53 @@ class HttpMetaCache : public QObject {
 
     // (re)start a timer that calls SaveNow later.
     void SaveEventually();
+    // the index is only read when an entry is first needed
     void Load();
 
     auto getBasePath(QString base) -> QString;
 
    public slots:
+    // append the pending changes to the journal, compacting it into the index when it grew too large
     void SaveNow();
 
    private:
     // create a new stale entry, given the parameters
     auto staleEntry(QString base, QString resource_path) -> MetaEntryPtr;
 
+    // drop the entry and remember to journal its removal
+    void removeEntry(QString base, QString resource_path);
+    void markDirty(MetaEntryPtr entry);
+
+    void ensureLoaded();
+    bool loadBinary();
+    void loadJson();
+    void appendJournal();
+    // rewrite the whole index and clear the journal
+    void compact(bool export_json = false);
+    bool exportJson();
+
+    // a null entry records a removal
+    static void writeRecord(QDataStream& out, const QString& base, const QString& path, const MetaEntry* entry);
+    static bool readRecord(QDataStream& in, MetaEntry& entry, bool& removed);
+
     struct EntryMap {
         QString base_path;
         QMap<QString, MetaEntryPtr> entry_list;
     };
 
     QMap<QString, EntryMap> m_entries;
+    // JSON index, only read when the binary one doesn't exist yet and written back on shutdown
     QString m_index_file;
+    QString m_binary_index_file;
+    QString m_journal_file;
+    bool m_load_pending = false;
+    bool m_needs_compaction = false;
+    int m_journal_records = 0;
+    // the binary index or the journal changed since the JSON index was last written
+    bool m_json_outdated = false;
+    // (base, path) -> entry changed since the last save, with its state at save time deciding between update and removal
+    QMap<QPair<QString, QString>, MetaEntryPtr> m_dirty;
+    // (size, mtime, inode) -> md5 of the cached files, so staleness checks don't have to re-read them
+    FileDigestCache m_digests;
     QTimer saveBatchingTimer;
 };
@@ -46,6 +46,8 @@ class MetaCacheSink : public FileSink {
     virtual ~MetaCacheSink() = default;
 
     auto hasLocalData() -> bool override;
+    /** The retry picks the result up from the cache instead, which keeps the cache entry up to date as well. */
+    bool adopt(const QByteArray&) override { return false; }
 
    protected:
     auto initCache(QNetworkRequest& request) -> Task::State override;
@@ -42,14 +42,22 @@
 #if defined(LAUNCHER_APPLICATION)
 #include "Application.h"
 #include "ui/dialogs/CustomMessageBox.h"
+
+namespace {
+// null when the jobs run without the launcher around them, like in the tests
+Application* application()
+{
+    return qobject_cast<Application*>(QCoreApplication::instance());
+}
+}  // namespace
 #endif
 
 NetJob::NetJob(QString job_name, shared_qobject_ptr<QNetworkAccessManager> network, int max_concurrent)
     : ConcurrentTask(nullptr, job_name), m_network(network)
 {
 #if defined(LAUNCHER_APPLICATION)
-    if (max_concurrent < 0)
-        max_concurrent = APPLICATION->settings()->get("NumberOfConcurrentDownloads").toInt();
+    if (max_concurrent < 0 && application())
+        max_concurrent = application()->settings()->get("NumberOfConcurrentDownloads").toInt();
 #endif
     if (max_concurrent > 0)
         setMaxConcurrent(max_concurrent);
@@ -58,6 +66,7 @@ NetJob::NetJob(QString job_name, shared_qobject_ptr<QNetworkAccessManager> netwo
 auto NetJob::addNetAction(Net::NetRequest::Ptr action) -> bool
 {
     action->setNetwork(m_network);
+    action->setPriority(m_priority);
 
     addTask(action);
 
@@ -102,9 +111,12 @@ auto NetJob::abort() -> bool
 {
     bool fullyAborted = true;
 
-    // fail all downloads on the queue
-    for (auto task : m_queue)
+    // fail all downloads on the queue, along with what earlier tries of them kept to resume from
+    for (auto task : m_queue) {
+        if (auto request = dynamic_cast<Net::NetRequest*>(task.get()))
+            request->discardPartial();
         m_failed.insert(task.get(), task);
+    }
     m_queue.clear();
 
     // abort active downloads
@@ -161,7 +173,7 @@ bool NetJob::isOnline()
 void NetJob::emitFailed(QString reason)
 {
 #if defined(LAUNCHER_APPLICATION)
-    if (m_ask_retry && m_manual_try < APPLICATION->settings()->get("NumberOfManualRetries").toInt() && isOnline()) {
+    if (m_ask_retry && application() && m_manual_try < application()->settings()->get("NumberOfManualRetries").toInt() && isOnline()) {
         m_manual_try++;
         auto response = CustomMessageBox::selectable(nullptr, "Confirm retry",
                                                      "The tasks failed.\n"
@@ -180,6 +192,11 @@ void NetJob::emitFailed(QString reason)
         }
     }
 #endif
+    // this was the last try, nothing is going to resume those
+    for (auto action : getFailedActions()) {
+        if (action)
+            action->discardPartial();
+    }
     ConcurrentTask::emitFailed(reason);
 }
 
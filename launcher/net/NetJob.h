@@ -59,6 +59,8 @@ class NetJob : public ConcurrentTask {
 
     auto canAbort() const -> bool override;
     auto addNetAction(Net::NetRequest::Ptr action) -> bool;
+    // applies to the actions added after it
+    void setPriority(Net::Priority priority) { m_priority = priority; }
 
     auto getFailedActions() -> QList<Net::NetRequest*>;
     auto getFailedFiles() -> QList<QString>;
@@ -78,6 +80,7 @@ class NetJob : public ConcurrentTask {
 
    private:
     shared_qobject_ptr<QNetworkAccessManager> m_network;
+    Net::Priority m_priority = Net::Priority::Normal;
 
     int m_try = 1;
     bool m_ask_retry = true;
@@ -39,10 +39,14 @@
 
 #include "NetRequest.h"
 
+#include <QCoreApplication>
 #include <QDateTime>
 #include <QFileInfo>
 #include <QNetworkReply>
+#include <QThread>
+#include <QThreadPool>
 #include <QUrl>
+#include <QtConcurrentRun>
 #include <memory>
 
 #if defined(LAUNCHER_APPLICATION)
@@ -55,6 +59,47 @@
 
 namespace Net {
 
+namespace {
+// how much received data may wait for the sink before we stop reading from the reply
+const qint64 s_max_pending_bytes = 8 * 1024 * 1024;
+
+// sinks write files and feed checksums with every chunk, keep that off the GUI thread and out of the global pool
+QThreadPool* ioThreadPool()
+{
+    static QThreadPool* s_pool = [] {
+        auto pool = new QThreadPool(QCoreApplication::instance());
+        pool->setMaxThreadCount(qBound(2, QThread::idealThreadCount(), 8));
+        return pool;
+    }();
+    return s_pool;
+}
+
+#if defined(LAUNCHER_APPLICATION)
+// null when the requests run without the launcher around them, like in the tests
+Application* application()
+{
+    return qobject_cast<Application*>(QCoreApplication::instance());
+}
+#endif
+}  // namespace
+
+NetRequest::NetRequest() : Task()
+{
+    // whichever way the request ends, its connection goes to the next one, and its result to the ones waiting on it
+    connect(this, &Task::finished, this, [this] {
+        RequestScheduler::Result result;
+        if (m_shareResult)
+            result = { true, m_sink->result() };
+        RequestScheduler::instance()->release(this, result);
+    });
+}
+
+NetRequest::~NetRequest()
+{
+    RequestScheduler::instance()->release(this);
+    m_writer.waitForFinished();
+}
+
 void NetRequest::addValidator(Validator* v)
 {
     m_sink->addValidator(v);
@@ -71,11 +116,45 @@ void NetRequest::executeTask()
         return;
     }
 
-    QNetworkRequest request(m_url);
-    m_state = m_sink->init(request);
+    auto scheduler = RequestScheduler::instance();
+    if (scheduler->holdsConnection(this)) {
+        // following a redirect, keep the connection we got for the original URL
+        startRequest();
+        return;
+    }
+    // the sink is only set up once the request gets its connection, so nothing touches its files while the request
+    // waits, possibly on another one writing into the same place
+    scheduler->enqueue(
+        this, m_url, schedulerKey(), m_priority, [this] { startRequest(); },
+        [this](const RequestScheduler::Result& leader) {
+            if (getState() != State::Running)
+                return;
+            if (leader.succeeded && m_sink->adopt(leader.data)) {
+                qCDebug(logCat) << getUid().toString() << "Request took over the result of an identical one:" << m_url.toString();
+                m_state = State::Succeeded;
+                emit succeeded();
+                emit finished();
+                return;
+            }
+            executeTask();
+        });
+}
+
+void NetRequest::startRequest()
+{
+    {
+        QMutexLocker locker(&m_writeLock);
+        m_writeFailed = false;
+        m_readPaused = false;
+    }
+    m_shareResult = false;
+
+    m_request = QNetworkRequest(m_url);
+    m_state = m_sink->init(m_request);
     switch (m_state) {
         case State::Succeeded:
             qCDebug(logCat) << getUid().toString() << "Request cache hit " << m_url.toString();
+            m_shareResult = true;
             emit succeeded();
             emit finished();
             return;
@@ -94,31 +173,42 @@ void NetRequest::executeTask()
     }
 
 #if defined(LAUNCHER_APPLICATION)
-    auto user_agent = APPLICATION->getUserAgent();
+    auto user_agent = application() ? application()->getUserAgent() : BuildConfig.USER_AGENT;
 #else
     auto user_agent = BuildConfig.USER_AGENT;
 #endif
 
-    request.setHeader(QNetworkRequest::UserAgentHeader, user_agent.toUtf8());
+    m_request.setHeader(QNetworkRequest::UserAgentHeader, user_agent.toUtf8());
     for (auto& header_proxy : m_headerProxies) {
-        header_proxy->writeHeaders(request);
+        header_proxy->writeHeaders(m_request);
     }
 
 #if QT_VERSION >= QT_VERSION_CHECK(5, 15, 0)
 #if defined(LAUNCHER_APPLICATION)
-    request.setTransferTimeout(APPLICATION->settings()->get("RequestTimeout").toInt() * 1000);
+    if (application())
+        m_request.setTransferTimeout(application()->settings()->get("RequestTimeout").toInt() * 1000);
+    else
+        m_request.setTransferTimeout();
 #else
-    request.setTransferTimeout();
+    m_request.setTransferTimeout();
 #endif
 #endif
 
+    sendRequest();
+}
+
+void NetRequest::sendRequest()
+{
     m_last_progress_time = m_clock.now();
     m_last_progress_bytes = 0;
+    m_responseStarted = false;
 
-    auto rep = getReply(request);
+    auto rep = getReply(m_request);
     if (rep == nullptr)  // it failed
         return;
     m_reply.reset(rep);
+    // if the sink falls behind, let the data back up into the socket instead of into memory
+    rep->setReadBufferSize(s_max_pending_bytes);
     connect(rep, &QNetworkReply::uploadProgress, this, &NetRequest::onProgress);
     connect(rep, &QNetworkReply::downloadProgress, this, &NetRequest::onProgress);
     connect(rep, &QNetworkReply::finished, this, &NetRequest::downloadFinished);
@@ -134,6 +224,15 @@ void NetRequest::executeTask()
 void NetRequest::onProgress(qint64 bytesReceived, qint64 bytesTotal)
 {
     auto now = m_clock.now();
+
+    // the details are only worth putting together for something that shows them, and not more often than it can
+    if (!detailsObserved() ||
+        (bytesReceived != bytesTotal && now - m_last_details_time < std::chrono::milliseconds(s_progress_interval_ms))) {
+        setProgress(bytesReceived, bytesTotal);
+        return;
+    }
+    m_last_details_time = now;
+
     auto elapsed = now - m_last_progress_time;
 
     // use milliseconds for speed precision
@@ -248,6 +347,18 @@ auto NetRequest::handleRedirect() -> bool
 
 void NetRequest::downloadFinished()
 {
+    {
+        // the sink can be neither finalized nor re-initialized for a redirect while chunks are still being written into it
+        QMutexLocker locker(&m_writeLock);
+        if (m_writing) {
+            m_finishPending = true;
+            return;
+        }
+        m_finishPending = false;
+        if (m_writeFailed && m_state == State::Running)
+            m_state = State::Failed;
+    }
+
     // handle HTTP redirection first
     if (handleRedirect()) {
         qCDebug(logCat) << getUid().toString() << "Request redirected:" << m_url.toString();
@@ -271,12 +382,15 @@ void NetRequest::downloadFinished()
     } else if (m_state == State::AbortedByUser) {
         qCDebug(logCat) << getUid().toString() << "Request aborted in previous step:" << m_url.toString();
         m_sink->abort();
+        // whoever aborted it isn't coming back for the rest
+        m_sink->discardPartial();
         emit aborted();
         emit finished();
         return;
     }
 
     // make sure we got all the remaining data, if any
+    startResponse();
     auto data = m_reply->readAll();
     if (data.size()) {
         qCDebug(logCat) << getUid().toString() << "Writing extra" << data.size() << "bytes";
@@ -301,27 +415,112 @@ void NetRequest::downloadFinished()
     }
 
     qCDebug(logCat) << getUid().toString() << "Request succeeded:" << m_url.toString();
+    m_shareResult = true;
     emit succeeded();
     emit finished();
 }
 
 void NetRequest::downloadReadyRead()
 {
+    if (!m_reply)
+        return;
     if (m_state == State::Running) {
-        auto data = m_reply->readAll();
-        m_state = m_sink->write(data);
-        if (m_state == State::Failed) {
-            qCCritical(logCat) << getUid().toString() << "Failed to process response chunk";
+        {
+            QMutexLocker locker(&m_writeLock);
+            // picked up again by drainWrites() once the sink catches up
+            if (m_readPaused)
+                return;
         }
-        // qDebug() << "Request" << m_url.toString() << "gained" << data.size() << "bytes";
+        auto status = replyStatusCode();
+        if (status == 301 || status == 302 || status == 303 || status == 307 || status == 308) {
+            // the body of a redirect is not what we are downloading
+            m_reply->readAll();
+            return;
+        }
+        startResponse();
+        // only take the data off the reply here, the sink gets it on the I/O pool
+        queueWrite(m_reply->readAll());
     } else {
         qCCritical(logCat) << getUid().toString() << "Cannot write download data! illegal status " << m_status;
     }
 }
 
+void NetRequest::startResponse()
+{
+    if (!m_responseStarted) {
+        m_responseStarted = true;
+        m_sink->headersReceived(*m_reply);
+    }
+}
+
+void NetRequest::queueWrite(QByteArray data)
+{
+    QMutexLocker locker(&m_writeLock);
+    if (m_writeFailed || data.isEmpty())
+        return;
+
+    m_pendingWrites.append(data);
+    m_pendingBytes += data.size();
+    if (m_pendingBytes >= s_max_pending_bytes)
+        m_readPaused = true;
+
+    if (!m_writing) {
+        m_writing = true;
+        m_writer = QtConcurrent::run(ioThreadPool(), [this] { drainWrites(); });
+    }
+}
+
+// runs on the I/O pool, at most once per request at a time so the chunks reach the sink in order
+void NetRequest::drainWrites()
+{
+    forever {
+        QByteArray data;
+        {
+            QMutexLocker locker(&m_writeLock);
+            if (m_readPaused && m_pendingBytes < s_max_pending_bytes / 2) {
+                m_readPaused = false;
+                QMetaObject::invokeMethod(this, &NetRequest::downloadReadyRead, Qt::QueuedConnection);
+            }
+            if (m_pendingWrites.isEmpty()) {
+                m_writing = false;
+                if (m_finishPending)
+                    QMetaObject::invokeMethod(this, &NetRequest::downloadFinished, Qt::QueuedConnection);
+                return;
+            }
+            data = m_pendingWrites.takeFirst();
+            m_pendingBytes -= data.size();
+        }
+
+        if (m_sink->write(data) == State::Failed) {
+            qCCritical(logCat) << getUid().toString() << "Failed to process response chunk";
+            QMutexLocker locker(&m_writeLock);
+            m_writeFailed = true;
+            m_pendingWrites.clear();
+            m_pendingBytes = 0;
+        }
+    }
+}
+
 auto NetRequest::abort() -> bool
 {
+    auto scheduler = RequestScheduler::instance();
+    if (isRunning() && !scheduler->holdsConnection(this)) {
+        // still waiting for a connection, so there's no reply to report the abort for us and the sink wasn't set up yet
+        scheduler->release(this);
+        m_state = State::AbortedByUser;
+        emit aborted();
+        emit finished();
+        return true;
+    }
+
     m_state = State::AbortedByUser;
+    {
+        // nothing queued is going to be used anymore
+        QMutexLocker locker(&m_writeLock);
+        m_pendingWrites.clear();
+        m_pendingBytes = 0;
+        m_readPaused = false;
+    }
     if (m_reply) {
 #if QT_VERSION >= QT_VERSION_CHECK(5, 15, 0)  // QNetworkReply::errorOccurred added in 5.15
         disconnect(m_reply.get(), &QNetworkReply::errorOccurred, nullptr, nullptr);
@@ -333,6 +532,12 @@ auto NetRequest::abort() -> bool
     return true;
 }
 
+void NetRequest::discardPartial()
+{
+    if (m_sink)
+        m_sink->discardPartial();
+}
+
 int NetRequest::replyStatusCode() const
 {
     return m_reply ? m_reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt() : -1;
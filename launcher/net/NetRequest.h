@@ -40,11 +40,14 @@
 #pragma once
 
 #include <qloggingcategory.h>
+#include <QFuture>
+#include <QMutex>
 #include <QNetworkReply>
 #include <QUrl>
 #include <chrono>
 
 #include "HeaderProxy.h"
+#include "RequestScheduler.h"
 #include "Sink.h"
 #include "Validator.h"
 
@@ -56,7 +59,7 @@ namespace Net {
 class NetRequest : public Task {
     Q_OBJECT
    protected:
-    explicit NetRequest() : Task() {}
+    explicit NetRequest();
 
    public:
     using Ptr = shared_qobject_ptr<class NetRequest>;
@@ -64,23 +67,34 @@ class NetRequest : public Task {
     Q_DECLARE_FLAGS(Options, Option)
 
    public:
-    ~NetRequest() override = default;
+    ~NetRequest() override;
     void addValidator(Validator* v);
     auto abort() -> bool override;
     auto canAbort() const -> bool override { return true; }
 
     void setNetwork(shared_qobject_ptr<QNetworkAccessManager> network) { m_network = network; }
     void addHeaderProxy(Net::HeaderProxy* proxy) { m_headerProxies.push_back(std::shared_ptr<Net::HeaderProxy>(proxy)); }
+    void setPriority(Priority priority) { m_priority = priority; }
 
     QUrl url() const;
     void setUrl(QUrl url) { m_url = url; }
     int replyStatusCode() const;
     QNetworkReply::NetworkError error() const;
     QString errorString() const;
+    /** Drops what the sink kept to resume the request from, as it's not going to be tried again. */
+    void discardPartial();
 
    private:
     auto handleRedirect() -> bool;
     virtual QNetworkReply* getReply(QNetworkRequest&) = 0;
+    /** Requests with the same non-empty key produce the same result, so only one of them runs at a time. */
+    virtual QString schedulerKey() const { return {}; }
+    void startRequest();
+    void sendRequest();
+
+    void startResponse();
+    void queueWrite(QByteArray data);
+    void drainWrites();
 
    protected slots:
     void onProgress(qint64 bytesReceived, qint64 bytesTotal);
@@ -93,12 +107,14 @@ class NetRequest : public Task {
    protected:
     std::unique_ptr<Sink> m_sink;
     Options m_options;
+    Priority m_priority = Priority::Normal;
 
     using logCatFunc = const QLoggingCategory& (*)();
     logCatFunc logCat = taskUploadLogC;
 
     std::chrono::steady_clock m_clock;
     std::chrono::time_point<std::chrono::steady_clock> m_last_progress_time;
+    std::chrono::time_point<std::chrono::steady_clock> m_last_details_time;
     qint64 m_last_progress_bytes;
 
     shared_qobject_ptr<QNetworkAccessManager> m_network;
@@ -106,9 +122,29 @@ class NetRequest : public Task {
     /// the network reply
     unique_qobject_ptr<QNetworkReply> m_reply;
 
+    /// the request sent over the connection
+    QNetworkRequest m_request;
+
     /// source URL
     QUrl m_url;
     std::vector<std::shared_ptr<Net::HeaderProxy>> m_headerProxies;
+
+   private:
+    /// response chunks waiting to be written into the sink, which happens on the I/O thread pool
+    QMutex m_writeLock;
+    QList<QByteArray> m_pendingWrites;
+    qint64 m_pendingBytes = 0;
+    QFuture<void> m_writer;
+    bool m_writing = false;
+    bool m_writeFailed = false;
+    bool m_finishPending = false;
+    bool m_readPaused = false;
+
+    /// whether the sink saw the headers of the current reply yet
+    bool m_responseStarted = false;
+
+    /// whether the request actually got its data, which the requests waiting on it can then take over
+    bool m_shareResult = false;
 };
 }  // namespace Net
 
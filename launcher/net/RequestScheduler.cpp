@@ -0,0 +1,141 @@
+// SPDX-License-Identifier: GPL-3.0-only
+/*
+ *  Prism Launcher - Minecraft Launcher
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, version 3.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "RequestScheduler.h"
+
+#include <QMetaObject>
+
+namespace Net {
+
+RequestScheduler* RequestScheduler::instance()
+{
+    static RequestScheduler s_instance;
+    return &s_instance;
+}
+
+void RequestScheduler::setMaxPerHost(int max_per_host)
+{
+    m_max_per_host = qMax(1, max_per_host);
+    dispatch();
+}
+
+void RequestScheduler::enqueue(QObject* owner,
+                               const QUrl& url,
+                               const QString& key,
+                               Priority priority,
+                               std::function<void()> start,
+                               std::function<void(const Result&)> retry)
+{
+    Entry entry{ owner, url.host(), key, priority, std::move(start), std::move(retry) };
+
+    if (!key.isEmpty()) {
+        auto leader = m_leaders.value(key);
+        if (leader && leader != owner) {
+            // don't let something urgent wait on a leader that is still queued behind less urgent requests
+            for (auto& queued : m_queue) {
+                if (queued.owner == leader && queued.priority < priority)
+                    queued.priority = priority;
+            }
+            m_followers[key].append(entry);
+            return;
+        }
+        m_leaders.insert(key, owner);
+    }
+
+    m_queue.append(entry);
+    dispatch();
+}
+
+void RequestScheduler::release(QObject* owner, const Result& result)
+{
+    QString key;
+
+    auto active = m_active.find(owner);
+    if (active != m_active.end()) {
+        key = active->key;
+        if (--m_active_per_host[active->host] <= 0)
+            m_active_per_host.remove(active->host);
+        m_active.erase(active);
+    } else {
+        for (int i = 0; i < m_queue.size(); i++) {
+            if (m_queue[i].owner == owner) {
+                key = m_queue.takeAt(i).key;
+                break;
+            }
+        }
+        for (auto& followers : m_followers) {
+            for (int i = 0; i < followers.size(); i++) {
+                if (followers[i].owner == owner) {
+                    followers.removeAt(i);
+                    break;
+                }
+            }
+        }
+    }
+
+    if (!key.isEmpty() && m_leaders.value(key) == owner)
+        retryFollowers(key, result);
+
+    dispatch();
+}
+
+void RequestScheduler::retryFollowers(const QString& key, const Result& result)
+{
+    m_leaders.remove(key);
+    // queued, so they run once the leader is completely done and its result is in place
+    for (auto& follower : m_followers.take(key)) {
+        if (follower.owner)
+            QMetaObject::invokeMethod(follower.owner.data(), [retry = follower.retry, result] { retry(result); }, Qt::QueuedConnection);
+    }
+}
+
+void RequestScheduler::dispatch()
+{
+    // starting a request can finish it right away and get us called again, the running pass picks that up
+    if (m_dispatching)
+        return;
+    m_dispatching = true;
+
+    forever {
+        int next = -1;
+        for (int i = 0; i < m_queue.size(); i++) {
+            auto& entry = m_queue[i];
+            if (m_active_per_host.value(entry.host) >= m_max_per_host)
+                continue;
+            // the queue is oldest first, so among the same priority the oldest one wins
+            if (next == -1 || entry.priority > m_queue[next].priority)
+                next = i;
+        }
+        if (next == -1)
+            break;
+
+        auto entry = m_queue.takeAt(next);
+        if (!entry.owner) {
+            if (!entry.key.isEmpty())
+                retryFollowers(entry.key);
+            continue;
+        }
+
+        m_active_per_host[entry.host]++;
+        m_active.insert(entry.owner.data(), entry);
+        entry.start();
+    }
+
+    m_dispatching = false;
+}
+
+}  // namespace Net
@@ -0,0 +1,111 @@
+// SPDX-License-Identifier: GPL-3.0-only
+/*
+ *  Prism Launcher - Minecraft Launcher
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, version 3.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <QByteArray>
+#include <QHash>
+#include <QList>
+#include <QObject>
+#include <QPointer>
+#include <QString>
+#include <QUrl>
+
+#include <functional>
+
+namespace Net {
+
+/** How urgently a request is needed. Connections go to the most urgent requests first. */
+enum class Priority {
+    Background,  // icons, thumbnails and the like
+    Normal,      // installs and everything else
+    Blocking     // something is waiting on it to launch the game
+};
+
+/**
+ * Hands out connections to the network requests of all the jobs, so that together they stay within a budget per host.
+ *
+ * A request that would fetch the same thing into the same place as one that is already queued or running is held back
+ * until that one is done, and then retried with its result, so it can take that over instead of downloading it again.
+ *
+ * Not thread-safe, it is meant to be used from the thread the requests live on.
+ */
+class RequestScheduler {
+   public:
+    /** How the request others waited on ended. */
+    struct Result {
+        bool succeeded = false;
+        /// the response, for requests that keep it in memory
+        QByteArray data;
+    };
+
+    static RequestScheduler* instance();
+
+    void setMaxPerHost(int max_per_host);
+    int maxPerHost() const { return m_max_per_host; }
+
+    /**
+     * Queues up the request made by owner.
+     *
+     * start is called as soon as a connection to the host of url is free, the owner then holds it until release().
+     * If key isn't empty and another request with the same key is queued or running, retry is called instead, once that
+     * other request is done, with what it released.
+     */
+    void enqueue(QObject* owner,
+                 const QUrl& url,
+                 const QString& key,
+                 Priority priority,
+                 std::function<void()> start,
+                 std::function<void(const Result&)> retry);
+
+    /**
+     * Gives back the connection held by owner, or takes it out of the queue if it didn't get one yet.
+     * The requests waiting on owner are handed result.
+     */
+    void release(QObject* owner, const Result& result = {});
+
+    bool holdsConnection(QObject* owner) const { return m_active.contains(owner); }
+    int activeCount(const QString& host) const { return m_active_per_host.value(host); }
+    int queuedCount() const { return m_queue.size(); }
+
+   private:
+    struct Entry {
+        QPointer<QObject> owner;
+        QString host;
+        QString key;
+        Priority priority;
+        std::function<void()> start;
+        std::function<void(const Result&)> retry;
+    };
+
+    void dispatch();
+    void retryFollowers(const QString& key, const Result& result = {});
+
+    int m_max_per_host = 6;
+    bool m_dispatching = false;
+
+    // waiting for a connection, oldest first
+    QList<Entry> m_queue;
+    QHash<QObject*, Entry> m_active;
+    QHash<QString, int> m_active_per_host;
+
+    // the request fetching each key, and the ones waiting for it to be done
+    QHash<QString, QObject*> m_leaders;
+    QHash<QString, QList<Entry>> m_followers;
+};
+
+}  // namespace Net
@@ -51,6 +51,19 @@ class Sink {
     virtual auto finalize(QNetworkReply& reply) -> Task::State = 0;
 
     virtual auto hasLocalData() -> bool = 0;
+    /** Called with the reply before the first chunk of its data is written. */
+    virtual void headersReceived(QNetworkReply&) {}
+    /** Where the data ends up, if that is somewhere other requests could be writing to as well. */
+    virtual auto target() const -> QString { return {}; }
+    /** Drops what an interrupted attempt kept around to resume from, once nothing is going to resume it anymore. */
+    virtual void discardPartial() {}
+    /** The data, for sinks that keep it in memory, so an identical request that waited on this one can take it over. */
+    virtual auto result() const -> QByteArray { return {}; }
+    /**
+     * Takes over the result of an identical request that just succeeded, data being what its sink's result() was.
+     * Returns false if the data has to be fetched after all.
+     */
+    virtual bool adopt(const QByteArray&) { return false; }
 
     void addValidator(Validator* validator)
     {
@@ -68,7 +81,7 @@ class Sink {
         }
         return true;
     }
-    bool finalizeAllValidators(QNetworkReply& reply)
+    bool finalizeAllValidators(QNetworkReply* reply)
     {
         for (auto& validator : validators) {
             if (!validator->validate(reply))
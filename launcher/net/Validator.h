@@ -46,6 +46,7 @@ class Validator {
     virtual bool init(QNetworkRequest& request) = 0;
     virtual bool write(QByteArray& data) = 0;
     virtual bool abort() = 0;
-    virtual bool validate(QNetworkReply& reply) = 0;
+    /** Checks what was written. There is no reply when the data was taken over from an identical request instead. */
+    virtual bool validate(QNetworkReply* reply) = 0;
 };
 }  // namespace Net
@@ -44,13 +44,60 @@ INISettingsObject::INISettingsObject(QString path, QObject* parent) : SettingsOb
     m_ini.loadFile(path);
 }
 
+INISettingsObject::INISettingsObject(QString path, INIFile contents, QSet<QString> partialKeys, QObject* parent)
+    : SettingsObject(parent), m_ini(contents), m_filePath(path), m_partialKeys(partialKeys), m_loaded(partialKeys.isEmpty())
+{}
+
+bool INISettingsObject::ensureLoaded()
+{
+    if (m_loaded)
+        return true;
+
+    INIFile contents;
+    if (!contents.loadFile(m_filePath)) {
+        // saving just the keys we have would wipe everything else in the file, so that waits until it can be read
+        qWarning() << "Could not load" << m_filePath << "- settings changes are kept in memory until it can be read";
+        return false;
+    }
+
+    // what was changed while the file couldn't be read wins over what is in it
+    for (auto& key : m_unsavedKeys) {
+        if (m_ini.contains(key))
+            contents.set(key, m_ini.value(key));
+        else
+            contents.remove(key);
+    }
+    m_ini = contents;
+    m_loaded = true;
+
+    if (!m_unsavedKeys.isEmpty()) {
+        m_unsavedKeys.clear();
+        doSave();
+    }
+    return true;
+}
+
+void INISettingsObject::markUnsaved(const QStringList& keys)
+{
+    if (m_loaded)
+        return;
+    for (auto& key : keys) {
+        m_unsavedKeys.insert(key);
+        // the value in memory is the current one now
+        m_partialKeys.insert(key);
+    }
+}
+
 void INISettingsObject::setFilePath(const QString& filePath)
 {
+    ensureLoaded();
     m_filePath = filePath;
 }
 
 bool INISettingsObject::reload()
 {
+    if (!m_loaded)
+        return ensureLoaded() && SettingsObject::reload();
     return m_ini.loadFile(m_filePath) && SettingsObject::reload();
 }
 
@@ -62,7 +109,7 @@ void INISettingsObject::suspendSave()
 void INISettingsObject::resumeSave()
 {
     m_suspendSave = false;
-    if (m_doSave) {
+    if (m_doSave && m_loaded) {
         m_ini.saveFile(m_filePath);
     }
 }
@@ -70,6 +117,7 @@ void INISettingsObject::resumeSave()
 void INISettingsObject::changeSetting(const Setting& setting, QVariant value)
 {
     if (contains(setting.id())) {
+        ensureLoaded();
         // valid value -> set the main config, remove all the sysnonyms
         if (value.isValid()) {
             auto list = setting.configKeys();
@@ -82,12 +130,16 @@ void INISettingsObject::changeSetting(const Setting& setting, QVariant value)
             for (auto iter : setting.configKeys())
                 m_ini.remove(iter);
         }
+        markUnsaved(setting.configKeys());
         doSave();
     }
 }
 
 void INISettingsObject::doSave()
 {
+    // ensureLoaded() saves once the whole file is there
+    if (!m_loaded)
+        return;
     if (m_suspendSave) {
         m_doSave = true;
     } else {
@@ -99,8 +151,10 @@ void INISettingsObject::resetSetting(const Setting& setting)
 {
     // if we have the setting, remove all the synonyms. ALL OF THEM
     if (contains(setting.id())) {
+        ensureLoaded();
         for (auto iter : setting.configKeys())
             m_ini.remove(iter);
+        markUnsaved(setting.configKeys());
         doSave();
     }
 }
@@ -110,6 +164,8 @@ QVariant INISettingsObject::retrieveValue(const Setting& setting)
     // if we have the setting, return value of the first matching synonym
     if (contains(setting.id())) {
         for (auto iter : setting.configKeys()) {
+            if (!m_loaded && !m_partialKeys.contains(iter))
+                ensureLoaded();
             if (m_ini.contains(iter))
                 return m_ini[iter];
         }
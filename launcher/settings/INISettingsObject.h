@@ -16,6 +16,7 @@
 #pragma once
 
 #include <QObject>
+#include <QSet>
 
 #include "settings/INIFile.h"
 
@@ -32,6 +33,13 @@ class INISettingsObject : public SettingsObject {
 
     explicit INISettingsObject(QString path, QObject* parent = nullptr);
 
+    /**
+     * Uses contents of the INI file that were already read elsewhere, e.g. on a worker thread.
+     * If 'partialKeys' is not empty, 'contents' only covers those keys and the rest of the file is read
+     * the first time a setting outside of them is needed, or before anything gets written back.
+     */
+    INISettingsObject(QString path, INIFile contents, QSet<QString> partialKeys = {}, QObject* parent = nullptr);
+
     /*!
      * \brief Gets the path to the INI file.
      * \return The path to the INI file.
@@ -56,8 +64,16 @@ class INISettingsObject : public SettingsObject {
    protected:
     virtual QVariant retrieveValue(const Setting& setting) override;
     void doSave();
+    /** Loads the rest of the file if it wasn't yet, returns false if it couldn't be read. */
+    bool ensureLoaded();
+    /** Remembers keys changed while the file couldn't be read, so they get saved once it can. */
+    void markUnsaved(const QStringList& keys);
 
    protected:
     INIFile m_ini;
     QString m_filePath;
+    // keys that are known to be up to date while the rest of the file hasn't been loaded
+    QSet<QString> m_partialKeys;
+    QSet<QString> m_unsavedKeys;
+    bool m_loaded = true;
 };
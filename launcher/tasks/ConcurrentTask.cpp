@@ -36,6 +36,8 @@
 #include "ConcurrentTask.h"
 
 #include <QDebug>
+#include <QMetaMethod>
+#include <QTimer>
 #include "tasks/Task.h"
 
 ConcurrentTask::ConcurrentTask(QObject* parent, QString task_name, int max_concurrent) : Task(parent), m_total_max_size(max_concurrent)
@@ -137,7 +139,9 @@ void ConcurrentTask::startSubTask(Task::Ptr next)
     connect(next.get(), &Task::aborted, this, [this, next] { subTaskFailed(next, "Aborted"); });
 
     connect(next.get(), &Task::status, this, [this, next](QString msg) { subTaskStatus(next, msg); });
-    connect(next.get(), &Task::details, this, [this, next](QString msg) { subTaskDetails(next, msg); });
+    // without anything showing them, leaving the details unconnected lets the subtask skip putting them together
+    if (detailsObserved() || isSignalConnected(QMetaMethod::fromSignal(&Task::stepProgress)))
+        connect(next.get(), &Task::details, this, [this, next](QString msg) { subTaskDetails(next, msg); });
     connect(next.get(), &Task::stepProgress, this, &ConcurrentTask::stepProgress);
 
     connect(next.get(), &Task::progress, this, [this, next](qint64 current, qint64 total) { subTaskProgress(next, current, total); });
@@ -162,6 +166,10 @@ void ConcurrentTask::subTaskFinished(Task::Ptr task, TaskStepState state)
     auto task_progress = *m_task_progress.value(task->getUid());
     task_progress.state = state;
     m_task_progress.remove(task->getUid());
+    // anything of it still waiting to go out is covered by the final state
+    m_changed_progress.remove(task->getUid());
+    if (totalSize() == 1)
+        setProgress(task_progress.current, task_progress.total);
 
     disconnect(task.get(), 0, this, 0);
 
@@ -199,7 +207,7 @@ void ConcurrentTask::subTaskDetails(Task::Ptr task, const QString& msg)
     task_progress->details = msg;
     task_progress->state = TaskStepState::Running;
 
-    emit stepProgress(*task_progress);
+    scheduleSubTaskUpdate(task->getUid());
 
     if (totalSize() == 1) {
         setDetails(msg);
@@ -212,14 +220,42 @@ void ConcurrentTask::subTaskProgress(Task::Ptr task, qint64 current, qint64 tota
 
     task_progress->update(current, total);
 
-    emit stepProgress(*task_progress);
-    updateState();
+    scheduleSubTaskUpdate(task->getUid());
+}
 
-    if (totalSize() == 1) {
-        setProgress(task_progress->current, task_progress->total);
+void ConcurrentTask::scheduleSubTaskUpdate(const QUuid& uid)
+{
+    // with thousands of downloads running, updating on every chunk of every one of them would swamp the UI
+    m_changed_progress.insert(uid);
+    if (!m_update_scheduled) {
+        m_update_scheduled = true;
+        QTimer::singleShot(s_progress_interval_ms, this, &ConcurrentTask::flushSubTaskUpdates);
     }
 }
 
+void ConcurrentTask::flushSubTaskUpdates()
+{
+    m_update_scheduled = false;
+    auto changed = m_changed_progress;
+    m_changed_progress.clear();
+
+    bool any_running = false;
+    for (auto& uid : changed) {
+        // it may have finished in the meantime, which already sent out its final state
+        auto task_progress = m_task_progress.value(uid);
+        if (!task_progress)
+            continue;
+        any_running = true;
+        emit stepProgress(*task_progress);
+
+        if (totalSize() == 1)
+            setProgress(task_progress->current, task_progress->total);
+    }
+
+    if (any_running)
+        updateState();
+}
+
 void ConcurrentTask::updateState()
 {
     if (totalSize() > 1) {
@@ -89,6 +89,10 @@ class ConcurrentTask : public Task {
 
     void startSubTask(Task::Ptr task);
 
+   private:
+    void scheduleSubTaskUpdate(const QUuid& uid);
+    void flushSubTaskUpdates();
+
    protected:
     QQueue<Task::Ptr> m_queue;
 
@@ -100,4 +104,9 @@ class ConcurrentTask : public Task {
     QHash<QUuid, std::shared_ptr<TaskStepProgress>> m_task_progress;
 
     int m_total_max_size;
+
+   private:
+    /// subtasks whose progress or details changed since the last update went out
+    QSet<QUuid> m_changed_progress;
+    bool m_update_scheduled = false;
 };
@@ -37,6 +37,8 @@
 #include "Task.h"
 
 #include <QDebug>
+#include <QMetaMethod>
+#include <QTimer>
 
 Q_LOGGING_CATEGORY(taskLogC, "launcher.task")
 
@@ -68,10 +70,41 @@ void Task::setProgress(qint64 current, qint64 total)
         m_progress = current;
         m_progressTotal = total;
 
+        emitProgress();
+    }
+}
+
+void Task::emitProgress()
+{
+    // nothing can show more than an update per frame, the ones in between are folded into the next
+    // the last one goes out right away though, there may not be another one to flush it
+    if (m_progress_emitted.isValid() && m_progress_emitted.elapsed() < s_progress_interval_ms && m_progress != m_progressTotal) {
+        if (!m_progress_pending) {
+            m_progress_pending = true;
+            QTimer::singleShot(static_cast<int>(s_progress_interval_ms - m_progress_emitted.elapsed()), this, &Task::flushProgress);
+        }
+        return;
+    }
+
+    m_progress_pending = false;
+    m_progress_emitted.start();
+    emit progress(m_progress, m_progressTotal);
+}
+
+void Task::flushProgress()
+{
+    if (m_progress_pending) {
+        m_progress_pending = false;
+        m_progress_emitted.start();
         emit progress(m_progress, m_progressTotal);
     }
 }
 
+bool Task::detailsObserved() const
+{
+    return isSignalConnected(QMetaMethod::fromSignal(&Task::details));
+}
+
 void Task::start()
 {
     switch (m_state) {
@@ -114,6 +147,7 @@ void Task::emitFailed(QString reason)
         qCCritical(taskLogC) << "Task" << describe() << "failed while not running!!!!: " << reason;
         return;
     }
+    flushProgress();
     m_state = State::Failed;
     m_failReason = reason;
     qCCritical(taskLogC) << "Task" << describe() << "failed: " << reason;
@@ -128,6 +162,7 @@ void Task::emitAborted()
         qCCritical(taskLogC) << "Task" << describe() << "aborted while not running!!!!";
         return;
     }
+    flushProgress();
     m_state = State::AbortedByUser;
     m_failReason = "Aborted.";
     if (m_show_debug)
@@ -143,6 +178,7 @@ void Task::emitSucceeded()
         qCCritical(taskLogC) << "Task" << describe() << "succeeded while not running!!!!";
         return;
     }
+    flushProgress();
     m_state = State::Succeeded;
     if (m_show_debug)
         qCDebug(taskLogC) << "Task" << describe() << "succeeded";
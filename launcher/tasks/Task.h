@@ -36,6 +36,7 @@
 
 #pragma once
 
+#include <QElapsedTimer>
 #include <QLoggingCategory>
 #include <QRunnable>
 #include <QUuid>
@@ -124,8 +125,16 @@ class Task : public QObject, public QRunnable {
    protected:
     void logWarning(const QString& line);
 
+    /** Whether anything listens to the details of this task, so they are worth putting together. */
+    bool detailsObserved() const;
+
+    /// progress updates closer together than this (about a frame) are coalesced
+    static constexpr int s_progress_interval_ms = 16;
+
    private:
     QString describe();
+    void emitProgress();
+    void flushProgress();
 
    signals:
     void started();
@@ -191,4 +200,7 @@ class Task : public QObject, public QRunnable {
     // Change using setAbortStatus
     bool m_can_abort = false;
     QUuid m_uid;
+
+    QElapsedTimer m_progress_emitted;
+    bool m_progress_pending = false;
 };
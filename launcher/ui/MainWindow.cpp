@@ -40,6 +40,7 @@
 
 #include "Application.h"
 #include "BuildConfig.h"
+#include "ContentStore.h"
 #include "FileSystem.h"
 
 #include "MainWindow.h"
@@ -71,6 +72,7 @@
 #include <QToolButton>
 #include <QWidget>
 #include <QWidgetAction>
+#include <QtConcurrent>
 
 #include <BaseInstance.h>
 #include <BuildConfig.h>
@@ -1294,6 +1296,9 @@ void MainWindow::on_actionClearMetadata_triggered()
 {
     APPLICATION->metacache()->evictAll();
     APPLICATION->metacache()->SaveNow();
+
+    // walks every stored file, keep it off the GUI thread
+    QtConcurrent::run(QThreadPool::globalInstance(), [store = APPLICATION->contentStore()] { store->collectGarbage(); });
 }
 
 #ifdef Q_OS_MAC
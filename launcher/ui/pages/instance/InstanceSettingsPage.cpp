@@ -81,11 +81,15 @@ InstanceSettingsPage::InstanceSettingsPage(BaseInstance* inst, QWidget* parent)
     auto mInst = dynamic_cast<MinecraftInstance*>(inst);
     m_world_quickplay_supported = mInst && mInst->traits().contains("feature:is_quick_play_singleplayer");
     if (m_world_quickplay_supported) {
-        auto worlds = mInst->worldList();
-        worlds->update();
-        for (const auto& world : worlds->allWorlds()) {
-            ui->worldsCb->addItem(world.folderName());
-        }
+        // the worlds show up as they are scanned, the page doesn't wait for that
+        m_worlds = mInst->worldList();
+        connect(m_worlds.get(), &QAbstractItemModel::rowsInserted, this, &InstanceSettingsPage::updateWorlds);
+        connect(m_worlds.get(), &QAbstractItemModel::rowsRemoved, this, &InstanceSettingsPage::updateWorlds);
+        connect(m_worlds.get(), &QAbstractItemModel::modelReset, this, &InstanceSettingsPage::updateWorlds);
+        connect(ui->worldsCb, QOverload<int>::of(&QComboBox::activated), this,
+                [this] { m_selectedWorld = ui->worldsCb->currentText(); });
+        updateWorlds();
+        m_worlds->update();
     } else {
         ui->worldsCb->hide();
         ui->worldJoinButton->hide();
@@ -104,6 +108,17 @@ InstanceSettingsPage::~InstanceSettingsPage()
     delete ui;
 }
 
+void InstanceSettingsPage::updateWorlds()
+{
+    ui->worldsCb->clear();
+    for (const auto& world : m_worlds->allWorlds()) {
+        ui->worldsCb->addItem(world.folderName());
+    }
+    // the saved world might not have been scanned yet when the settings were loaded
+    if (!m_selectedWorld.isEmpty())
+        ui->worldsCb->setCurrentText(m_selectedWorld);
+}
+
 void InstanceSettingsPage::globalSettingsButtonClicked(bool)
 {
     switch (ui->settingsTabs->currentIndex()) {
@@ -418,6 +433,7 @@ void InstanceSettingsPage::loadSettings()
         ui->serverJoinAddress->setEnabled(true);
         ui->worldsCb->setEnabled(false);
     } else if (auto world = m_settings->get("JoinWorldOnLaunch").toString(); !world.isEmpty() && m_world_quickplay_supported) {
+        m_selectedWorld = world;
         ui->worldsCb->setCurrentText(world);
         ui->serverJoinAddressButton->setChecked(false);
         ui->worldJoinButton->setChecked(true);
@@ -43,6 +43,7 @@
 #include "BaseInstance.h"
 #include "JavaCommon.h"
 #include "java/JavaChecker.h"
+#include "minecraft/WorldList.h"
 #include "ui/pages/BasePage.h"
 
 class JavaChecker;
@@ -88,10 +89,15 @@ class InstanceSettingsPage : public QWidget, public BasePage {
     QIcon getFaceForAccount(MinecraftAccountPtr account);
     void changeInstanceAccount(int index);
 
+    void updateWorlds();
+
    private:
     Ui::InstanceSettingsPage* ui;
     BaseInstance* m_instance;
     SettingsObjectPtr m_settings;
     unique_qobject_ptr<JavaCommon::TestCheck> checker;
     bool m_world_quickplay_supported;
+    std::shared_ptr<WorldList> m_worlds;
+    // the world to join, kept while the combo box is filled again
+    QString m_selectedWorld;
 };
@@ -320,6 +320,7 @@ std::optional<QIcon> ResourceModel::getIcon(QModelIndex& index, const QUrl& url)
     if (!m_current_icon_job) {
         m_current_icon_job.reset(new NetJob("IconJob", APPLICATION->network()));
         m_current_icon_job->setAskRetry(false);
+        m_current_icon_job->setPriority(Net::Priority::Background);
     }
 
     if (m_currently_running_icon_actions.contains(url))
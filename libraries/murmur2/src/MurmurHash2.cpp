@@ -8,6 +8,10 @@
 
 #include "MurmurHash2.h"
 
+#include <cstring>
+#include <memory>
+#include <vector>
+
 namespace Murmur2 {
 
 // 'm' and 'r' are mixing constants generated offline.
@@ -15,53 +19,126 @@ namespace Murmur2 {
 const uint32_t m = 0x5bd1e995;
 const int r = 24;
 
-uint32_t hash(Reader* file_stream, std::size_t buffer_size, std::function<bool(char)> filter_out)
+namespace {
+inline bool isWhitespace(char c)
 {
-    auto* buffer = new char[buffer_size];
-    char data[4];
+    return c == 9 || c == 10 || c == 13 || c == 32;
+}
 
-    int read = 0;
-    uint32_t size = 0;
+// Whether any byte of the word is equal to the byte repeated in `pattern`.
+inline bool hasByte(uint64_t word, uint64_t pattern)
+{
+    const uint64_t v = word ^ pattern;
+    return ((v - 0x0101010101010101ULL) & ~v & 0x8080808080808080ULL) != 0;
+}
 
+inline bool hasWhitespace(uint64_t word)
+{
+    return hasByte(word, 0x0909090909090909ULL) || hasByte(word, 0x0a0a0a0a0a0a0a0aULL) || hasByte(word, 0x0d0d0d0d0d0d0d0dULL) ||
+           hasByte(word, 0x2020202020202020ULL);
+}
+}  // namespace
+
+uint32_t hash(Reader* file_stream, std::size_t buffer_size, std::function<bool(char)> filter_out)
+{
     // We need the size without the filtered out characters before actually calculating the hash,
-    // to setup the initial value for the hash.
+    // to setup the initial value for the hash. So keep what passes the filter instead of reading twice.
+    std::vector<char> data;
+    std::vector<char> buffer(buffer_size);
+
+    int read = 0;
     do {
-        read = file_stream->read(buffer, buffer_size);
+        read = file_stream->read(buffer.data(), static_cast<int>(buffer_size));
         for (int i = 0; i < read; i++) {
             if (!filter_out(buffer[i]))
-                size += 1;
+                data.push_back(buffer[i]);
         }
-    } while (!file_stream->eof());
+    } while (read > 0 && !file_stream->eof());
+
+    return hash(data.data(), data.size());
+}
 
-    file_stream->goToBeginning();
+uint32_t hash(const char* data, std::size_t len, uint32_t seed)
+{
+    // This forces a seed of 1 by default.
+    uint32_t h = seed ^ static_cast<uint32_t>(len);
 
-    int index = 0;
+    // Mix 4 bytes at a time into the hash
+    while (len >= 4) {
+        uint32_t k;
+        std::memcpy(&k, data, 4);
 
-    // This forces a seed of 1.
-    IncrementalHashInfo info{ (uint32_t)1 ^ size, (uint32_t)size };
-    do {
-        read = file_stream->read(buffer, buffer_size);
-        for (int i = 0; i < read; i++) {
-            char c = buffer[i];
+        k *= m;
+        k ^= k >> r;
+        k *= m;
 
-            if (filter_out(c))
-                continue;
+        h *= m;
+        h ^= k;
 
-            data[index] = c;
-            index = (index + 1) % 4;
+        data += 4;
+        len -= 4;
+    }
 
-            // Mix 4 bytes at a time into the hash
-            if (index == 0)
-                FourBytes_MurmurHash2(reinterpret_cast<unsigned char*>(&data), info);
+    // Handle the last few bytes of the input array
+    const auto* tail = reinterpret_cast<const unsigned char*>(data);
+    switch (len) {
+        case 3:
+            h ^= tail[2] << 16;
+            /* fall through */
+        case 2:
+            h ^= tail[1] << 8;
+            /* fall through */
+        case 1:
+            h ^= tail[0];
+            h *= m;
+    };
+
+    // Do a few final mixes of the hash to ensure the last few
+    // bytes are well-incorporated.
+    h ^= h >> 13;
+    h *= m;
+    h ^= h >> 15;
+
+    return h;
+}
+
+std::size_t stripWhitespace(const char* in, std::size_t len, char* out)
+{
+    std::size_t written = 0;
+    std::size_t i = 0;
+
+    // Most 8 byte runs of a (compressed) jar have no whitespace at all, so test a whole word at once
+    // and only look at the single bytes when one of them has to go.
+    // The word is loaded before being stored, so this is safe to do in place.
+    for (; i + 8 <= len; i += 8) {
+        uint64_t word;
+        std::memcpy(&word, in + i, 8);
+        if (!hasWhitespace(word)) {
+            std::memcpy(out + written, &word, 8);
+            written += 8;
+            continue;
         }
-    } while (!file_stream->eof());
+        for (std::size_t j = 0; j < 8; j++) {
+            char c = in[i + j];
+            out[written] = c;
+            written += !isWhitespace(c);
+        }
+    }
 
-    // Do one last bit shuffle in the hash
-    FourBytes_MurmurHash2(reinterpret_cast<unsigned char*>(&data), info);
+    for (; i < len; i++) {
+        char c = in[i];
+        out[written] = c;
+        written += !isWhitespace(c);
+    }
 
-    delete[] buffer;
+    return written;
+}
 
-    return info.h;
+uint32_t curseForgeHash(const char* data, std::size_t len)
+{
+    std::unique_ptr<char[]> stripped(new char[len]);
+    auto stripped_len = stripWhitespace(data, len, stripped.get());
+    return hash(stripped.get(), stripped_len);
 }
 
 void FourBytes_MurmurHash2(const unsigned char* data, IncrementalHashInfo& prev)
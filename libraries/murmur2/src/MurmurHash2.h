@@ -8,6 +8,7 @@
 
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
 #include <functional>
 
@@ -24,8 +25,19 @@ class Reader {
     virtual void goToBeginning() = 0;
 };
 
+// Reads the whole stream once, dropping the filtered out bytes, and hashes what's left.
 uint32_t hash(Reader* file_stream, std::size_t buffer_size = 4 * MiB, std::function<bool(char)> filter_out = [](char) { return false; });
 
+// Plain MurmurHash2 over a contiguous buffer, mixing a word at a time.
+uint32_t hash(const char* data, std::size_t len, uint32_t seed = 1);
+
+// Copies the bytes of `in` that aren't whitespace as CurseForge defines it (\t, \n, \r and space) to `out`,
+// returning how many were copied. `out` may alias `in` to compact a buffer in place.
+std::size_t stripWhitespace(const char* in, std::size_t len, char* out);
+
+// The CurseForge fingerprint: MurmurHash2 with seed 1 of the data without its whitespace.
+uint32_t curseForgeHash(const char* data, std::size_t len);
+
 struct IncrementalHashInfo {
     uint32_t h;
     uint32_t len;
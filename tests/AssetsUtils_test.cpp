@@ -0,0 +1,264 @@
+#include <QTemporaryDir>
+#include <QTest>
+
+#include <FileSystem.h>
+#include <minecraft/AssetsUtils.h>
+
+// Makes a folder the current one for as long as it's around, even when a check fails half way through the test.
+class CurrentDirectory {
+   public:
+    CurrentDirectory(const QString& path) : m_previous(QDir::currentPath()) { QDir::setCurrent(path); }
+    ~CurrentDirectory() { QDir::setCurrent(m_previous); }
+
+   private:
+    QString m_previous;
+};
+
+class AssetsUtilsTest : public QObject {
+    Q_OBJECT
+
+    QString copyIndex(const QTemporaryDir& tmp, const QString& name)
+    {
+        auto path = FS::PathCombine(tmp.path(), name + ".json");
+        QFile::copy(QFINDTESTDATA("testdata/AssetsUtils/legacy.json"), path);
+        return path;
+    }
+
+   private slots:
+    void test_parse()
+    {
+        QTemporaryDir tmp;
+        QVERIFY(tmp.isValid());
+        auto index = AssetsUtils::loadAssetsIndex("legacy", copyIndex(tmp, "legacy"));
+        QVERIFY(index);
+
+        QCOMPARE(index->id, QString("legacy"));
+        QVERIFY(index->isVirtual);
+        QVERIFY(!index->mapToResources);
+        QCOMPARE(index->sha1.size(), 20);
+
+        QCOMPARE(index->objects.size(), 3);
+        QCOMPARE(index->name(index->objects[0]), QString("icons/icon_16x16.png"));
+        QCOMPARE(index->name(index->objects[1]), QString("lang/fr_FR.lang"));
+        QCOMPARE(index->name(index->objects[2]), QString("sounds/ambient/cave/cave1.ogg"));
+
+        QCOMPARE(index->objects[0].hash(), QString("bdf48ef6b5d0d23bbb02e17d04865216179f510a"));
+        QCOMPARE(index->objects[0].size, qint64(3665));
+        QCOMPARE(index->objects[0].getRelPath(), QString("bd/bdf48ef6b5d0d23bbb02e17d04865216179f510a"));
+        // upper case hashes end up in the same place as everything else
+        QCOMPARE(index->objects[1].hash(), QString("4e2b8f6d8b6f0c7a54a1c3b2f0d9e8a7b6c5d4e3"));
+    }
+
+    void test_loadAssetsIndex()
+    {
+        QTemporaryDir tmp;
+        QVERIFY(tmp.isValid());
+        auto path = copyIndex(tmp, "legacy");
+
+        auto index = AssetsUtils::loadAssetsIndex("legacy", path);
+        QVERIFY(index);
+        QCOMPARE(index->objects.size(), 3);
+        QVERIFY(QFileInfo::exists(FS::PathCombine(tmp.path(), "legacy.bin")));
+
+        // parsed only once
+        QVERIFY(AssetsUtils::loadAssetsIndex("legacy", path) == index);
+
+        // a copy with the same contents is read from its binary cache
+        auto other = copyIndex(tmp, "other");
+        QFile::copy(FS::PathCombine(tmp.path(), "legacy.bin"), FS::PathCombine(tmp.path(), "other.bin"));
+        auto cached = AssetsUtils::loadAssetsIndex("other", other);
+        QVERIFY(cached);
+        QCOMPARE(cached->sha1, index->sha1);
+        QCOMPARE(cached->isVirtual, index->isVirtual);
+        QCOMPARE(cached->objects.size(), index->objects.size());
+        for (int i = 0; i < index->objects.size(); i++) {
+            QCOMPARE(cached->name(cached->objects[i]), index->name(index->objects[i]));
+            QCOMPARE(cached->objects[i].hash(), index->objects[i].hash());
+            QCOMPARE(cached->objects[i].size, index->objects[i].size);
+        }
+    }
+
+    void test_staleCache()
+    {
+        QTemporaryDir tmp;
+        QVERIFY(tmp.isValid());
+        auto path = copyIndex(tmp, "legacy");
+        QVERIFY(AssetsUtils::loadAssetsIndex("legacy", path));
+
+        // the cache of another version of the index must not be used
+        FS::write(path, R"({ "objects": { "a.txt": { "hash": "bdf48ef6b5d0d23bbb02e17d04865216179f510a", "size": 1 } } })");
+        auto index = AssetsUtils::loadAssetsIndex("legacy", path);
+        QVERIFY(index);
+        QVERIFY(!index->isVirtual);
+        QCOMPARE(index->objects.size(), 1);
+        QCOMPARE(index->name(index->objects[0]), QString("a.txt"));
+    }
+
+    void test_corruptedCache()
+    {
+        QTemporaryDir tmp;
+        QVERIFY(tmp.isValid());
+        auto path = copyIndex(tmp, "legacy");
+        QVERIFY(AssetsUtils::loadAssetsIndex("legacy", path));
+
+        // an object count way past what the file holds, it comes right before the three objects
+        auto copy = copyIndex(tmp, "copy");
+        auto cache = FS::read(FS::PathCombine(tmp.path(), "legacy.bin"));
+        cache.replace(cache.size() - 3 * 36 - 4, 4, QByteArray(4, '\xff'));
+        FS::write(FS::PathCombine(tmp.path(), "copy.bin"), cache);
+
+        // the index is parsed again instead
+        auto index = AssetsUtils::loadAssetsIndex("copy", copy);
+        QVERIFY(index);
+        QCOMPARE(index->objects.size(), 3);
+    }
+
+    void test_stampedCache()
+    {
+        QTemporaryDir tmp;
+        QVERIFY(tmp.isValid());
+        auto path = copyIndex(tmp, "legacy");
+        auto index = AssetsUtils::loadAssetsIndex("legacy", path);
+        QVERIFY(index);
+        auto cachePath = FS::PathCombine(tmp.path(), "legacy.bin");
+        auto stamp = QFileInfo(path).lastModified();
+
+        // the same size and modification time are enough to trust the cache, the index file isn't even read
+        QVERIFY(tmp.mkpath("copy"));
+        auto copy = FS::PathCombine(tmp.path(), "copy", "legacy.json");
+        FS::write(copy, QByteArray(QFileInfo(path).size(), ' '));
+        QFile file(copy);
+        QVERIFY(file.open(QIODevice::ReadWrite) && file.setFileTime(stamp, QFileDevice::FileModificationTime));
+        file.close();
+        QVERIFY(QFile::copy(cachePath, FS::PathCombine(tmp.path(), "copy", "legacy.bin")));
+        auto cached = AssetsUtils::loadAssetsIndex("legacy", copy);
+        QVERIFY(cached);
+        QCOMPARE(cached->sha1, index->sha1);
+        QCOMPARE(cached->objects.size(), 3);
+
+        // only touched: the contents are the same, so the cache is too, with a new stamp
+        auto before = FS::read(cachePath);
+        QFile touched(path);
+        QVERIFY(touched.open(QIODevice::ReadWrite) && touched.setFileTime(stamp.addDays(1), QFileDevice::FileModificationTime));
+        touched.close();
+        auto reloaded = AssetsUtils::loadAssetsIndex("legacy", path);
+        QVERIFY(reloaded);
+        QVERIFY(reloaded != index);
+        QCOMPARE(reloaded->sha1, index->sha1);
+        QCOMPARE(reloaded->objects.size(), 3);
+        QVERIFY(FS::read(cachePath) != before);
+    }
+
+    void test_reconstructAssets()
+    {
+        QTemporaryDir tmp;
+        QVERIFY(tmp.isValid());
+        CurrentDirectory current(tmp.path());
+
+        FS::ensureFolderPathExists("assets/indexes");
+        QFile::copy(QFINDTESTDATA("testdata/AssetsUtils/legacy.json"), "assets/indexes/legacy.json");
+        auto index = AssetsUtils::loadAssetsIndex("legacy", "assets/indexes/legacy.json");
+        QVERIFY(index);
+
+        // all the objects but the last one were downloaded
+        for (int i = 0; i < index->objects.size() - 1; i++) {
+            auto path = index->objects[i].getLocalPath();
+            FS::ensureFilePathExists(path);
+            FS::write(path, QByteArray(index->objects[i].size, 'a' + i));
+        }
+        FS::ensureFilePathExists("assets/virtual/legacy/sounds/removed.ogg");
+        FS::write("assets/virtual/legacy/sounds/removed.ogg", "old");
+
+        QVERIFY(AssetsUtils::reconstructAssets("legacy", "resources"));
+        QCOMPARE(FS::read("assets/virtual/legacy/icons/icon_16x16.png"), QByteArray(3665, 'a'));
+        QCOMPARE(FS::read("assets/virtual/legacy/lang/fr_FR.lang"), QByteArray(12, 'b'));
+        QVERIFY(!QFileInfo::exists("assets/virtual/legacy/sounds/ambient/cave/cave1.ogg"));
+        QVERIFY(!QFileInfo::exists("assets/virtual/legacy/sounds/removed.ogg"));
+        // not complete, so it has to be looked at again next time
+        QVERIFY(!QFileInfo::exists("assets/virtual/legacy/.index-sha1"));
+
+        auto& last = index->objects.last();
+        FS::ensureFilePathExists(last.getLocalPath());
+        FS::write(last.getLocalPath(), QByteArray(last.size, 'c'));
+        QVERIFY(AssetsUtils::reconstructAssets("legacy", "resources"));
+        QCOMPARE(FS::read("assets/virtual/legacy/sounds/ambient/cave/cave1.ogg"), QByteArray(last.size, 'c'));
+        QVERIFY(QFileInfo::exists("assets/virtual/legacy/.index-sha1"));
+    }
+
+    void test_reconstructResources()
+    {
+        QTemporaryDir tmp;
+        QVERIFY(tmp.isValid());
+        CurrentDirectory current(tmp.path());
+
+        FS::ensureFolderPathExists("assets/indexes");
+        FS::write("assets/indexes/pre-1.6.json", R"({ "map_to_resources": true, "objects": {
+            "sounds/step/grass1.ogg": { "hash": "bdf48ef6b5d0d23bbb02e17d04865216179f510a", "size": 5 },
+            "lang/en_US.lang": { "hash": "4e2b8f6d8b6f0c7a54a1c3b2f0d9e8a7b6c5d4e3", "size": 4 } } })");
+        auto index = AssetsUtils::loadAssetsIndex("pre-1.6", "assets/indexes/pre-1.6.json");
+        QVERIFY(index);
+        QVERIFY(index->mapToResources);
+        for (auto& object : index->objects) {
+            FS::ensureFilePathExists(object.getLocalPath());
+            FS::write(object.getLocalPath(), QByteArray(object.size, 'a'));
+        }
+
+        QVERIFY(AssetsUtils::reconstructAssets("pre-1.6", "resources"));
+        QCOMPARE(FS::read("resources/sounds/step/grass1.ogg"), QByteArray(5, 'a'));
+        // editing it must not change the object every other instance uses
+        QCOMPARE(FS::hardLinkCount("resources/sounds/step/grass1.ogg"), uintmax_t(1));
+
+        // the user's changes are kept, and what they deleted comes back
+        FS::write("resources/sounds/step/grass1.ogg", "edited by the user");
+        QVERIFY(QFile::remove("resources/lang/en_US.lang"));
+        QVERIFY(AssetsUtils::reconstructAssets("pre-1.6", "resources"));
+        QCOMPARE(FS::read("resources/sounds/step/grass1.ogg"), QByteArray("edited by the user"));
+        QCOMPARE(FS::read("resources/lang/en_US.lang"), QByteArray(4, 'a'));
+        QCOMPARE(FS::read(index->objects[0].getLocalPath()), QByteArray(index->objects[0].size, 'a'));
+    }
+
+    void test_missingObjects()
+    {
+        QTemporaryDir tmp;
+        QVERIFY(tmp.isValid());
+        CurrentDirectory current(tmp.path());
+
+        FS::ensureFolderPathExists("assets/indexes");
+        QFile::copy(QFINDTESTDATA("testdata/AssetsUtils/legacy.json"), "assets/indexes/legacy.json");
+        auto index = AssetsUtils::loadAssetsIndex("legacy", "assets/indexes/legacy.json");
+        QVERIFY(index);
+
+        QCOMPARE(index->missingObjects(), QVector<int>({ 0, 1, 2 }));
+        QVERIFY(!QFileInfo::exists("assets/indexes/legacy.verified"));
+
+        for (auto& object : index->objects) {
+            FS::ensureFilePathExists(object.getLocalPath());
+            FS::write(object.getLocalPath(), QByteArray(object.size, 'a'));
+        }
+        QVERIFY(index->missingObjects().isEmpty());
+        QVERIFY(QFileInfo::exists("assets/indexes/legacy.verified"));
+        QVERIFY(!index->getDownloadJob(index->missingObjects()));
+
+        // a removed object changes how many entries its folder has, however coarse the file system's timestamps are
+        QVERIFY(QFile::remove(index->objects[1].getLocalPath()));
+        QCOMPARE(index->missingObjects(), QVector<int>({ 1 }));
+
+        // once downloaded again, the folders are stamped as they are now
+        FS::write(index->objects[1].getLocalPath(), QByteArray(index->objects[1].size, 'a'));
+        index->markVerified(index->objectFolderStamps());
+        QVERIFY(index->missingObjects().isEmpty());
+    }
+
+    void test_invalidHash()
+    {
+        QTemporaryDir tmp;
+        QVERIFY(tmp.isValid());
+        auto path = FS::PathCombine(tmp.path(), "bad.json");
+        FS::write(path, R"({ "objects": { "a.txt": { "hash": "../../../../etc/passwd", "size": 1 } } })");
+        QVERIFY(!AssetsUtils::loadAssetsIndex("bad", path));
+    }
+};
+
+QTEST_GUILESS_MAIN(AssetsUtilsTest)
+
+#include "AssetsUtils_test.moc"
@@ -0,0 +1,136 @@
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QTemporaryDir>
+#include <QTest>
+
+#include <ContentStore.h>
+#include <FileSystem.h>
+
+class ContentStoreTest : public QObject {
+    Q_OBJECT
+
+    static QString sha1(const QByteArray& data) { return QCryptographicHash::hash(data, QCryptographicHash::Sha1).toHex(); }
+
+    static bool makeOld(const QString& path)
+    {
+        QFile file(path);
+        return file.open(QIODevice::ReadWrite) && file.setFileTime(QDateTime::currentDateTime().addDays(-30), QFileDevice::FileModificationTime);
+    }
+
+    static QString writeFile(const QString& path, const QByteArray& data)
+    {
+        FS::write(path, data);
+        return path;
+    }
+
+   private slots:
+    void test_blobPath()
+    {
+        ContentStore store("/store");
+        auto hash = sha1("hello");
+        QCOMPARE(store.blobPath(QCryptographicHash::Sha1, hash), FS::PathCombine("/store", "sha1", hash.left(2), hash));
+        QCOMPARE(store.blobPath(QCryptographicHash::Sha1, hash.toUpper()), FS::PathCombine("/store", "sha1", hash.left(2), hash));
+
+        // anything that isn't a digest of the right algorithm could escape the store
+        QVERIFY(store.blobPath(QCryptographicHash::Sha1, "../../../../etc/passwd").isEmpty());
+        QVERIFY(store.blobPath(QCryptographicHash::Sha1, hash.left(38) + "/.").isEmpty());
+        QVERIFY(store.blobPath(QCryptographicHash::Sha1, hash + "00").isEmpty());
+        QVERIFY(store.blobPath(QCryptographicHash::Sha1, QString()).isEmpty());
+        QVERIFY(store.blobPath(QCryptographicHash::Md5, QCryptographicHash::hash("hello", QCryptographicHash::Md5).toHex()).isEmpty());
+    }
+
+    void test_addAndMaterialize()
+    {
+        QTemporaryDir tmp;
+        QVERIFY(tmp.isValid());
+        ContentStore store(FS::PathCombine(tmp.path(), "store"));
+
+        QByteArray data("some mod jar");
+        auto hash = sha1(data);
+        auto download = writeFile(FS::PathCombine(tmp.path(), "instance1", "mods", "mod.jar"), data);
+
+        QVERIFY(!store.contains(QCryptographicHash::Sha1, hash));
+        QVERIFY(!store.materialize(QCryptographicHash::Sha1, hash, FS::PathCombine(tmp.path(), "nowhere.jar")));
+
+        QVERIFY(store.add(QCryptographicHash::Sha1, hash, download));
+        QVERIFY(store.contains(QCryptographicHash::Sha1, hash));
+        // the instance could change its file in place, that must never reach the blob
+        QCOMPARE(FS::hardLinkCount(store.blobPath(QCryptographicHash::Sha1, hash)), uintmax_t(1));
+
+        auto target = FS::PathCombine(tmp.path(), "instance2", "mods", "mod.jar");
+        QVERIFY(store.materialize(QCryptographicHash::Sha1, hash, target));
+        QCOMPARE(FS::read(target), data);
+
+        // both instances still use the blob, whatever way it was shared
+        QCOMPARE(store.collectGarbage(), 0);
+        QVERIFY(store.contains(QCryptographicHash::Sha1, hash));
+
+        // a recently used blob survives its users going away
+        FS::deletePath(FS::PathCombine(tmp.path(), "instance1"));
+        FS::deletePath(FS::PathCombine(tmp.path(), "instance2"));
+        QCOMPARE(store.collectGarbage(), 0);
+        QVERIFY(store.contains(QCryptographicHash::Sha1, hash));
+    }
+
+    void test_collectGarbage()
+    {
+        QTemporaryDir tmp;
+        QVERIFY(tmp.isValid());
+        ContentStore store(FS::PathCombine(tmp.path(), "store"));
+        auto staging = FS::PathCombine(tmp.path(), "instances", ".tmp", "abcdef");
+        auto failed = FS::PathCombine(tmp.path(), "instances", ".tmp", "012345");
+        auto instance = FS::PathCombine(tmp.path(), "instances", "instance");
+
+        QByteArray kept("kept mod"), removed("removed mod"), unused("prefetched mod");
+        QVERIFY(store.add(QCryptographicHash::Sha1, sha1(kept), writeFile(FS::PathCombine(staging, "mods", "kept.jar"), kept)));
+        QVERIFY(store.add(QCryptographicHash::Sha1, sha1(removed), writeFile(FS::PathCombine(staging, "mods", "removed.jar"), removed)));
+        QVERIFY(store.add(QCryptographicHash::Sha1, sha1(unused), writeFile(FS::PathCombine(failed, "mods", "unused.jar"), unused)));
+        for (auto data : { kept, removed, unused })
+            QVERIFY(makeOld(store.blobPath(QCryptographicHash::Sha1, sha1(data))));
+
+        // until the staging folder is committed, its files only exist there
+        QCOMPARE(store.collectGarbage(), 0);
+        QVERIFY(FS::move(staging, instance));
+        store.commitReferences(staging, instance);
+        store.dropReferences(failed);
+        FS::deletePath(failed);
+
+        FS::deletePath(FS::PathCombine(instance, "mods", "removed.jar"));
+        for (auto data : { kept, removed })
+            QVERIFY(makeOld(store.blobPath(QCryptographicHash::Sha1, sha1(data)) + ".refs"));
+
+        // the reference now points to the instance, which still has the file
+        QCOMPARE(store.collectGarbage(), 2);
+        QVERIFY(store.contains(QCryptographicHash::Sha1, sha1(kept)));
+        QVERIFY(!store.contains(QCryptographicHash::Sha1, sha1(removed)));
+        QVERIFY(!store.contains(QCryptographicHash::Sha1, sha1(unused)));
+        QCOMPARE(QString(FS::read(store.blobPath(QCryptographicHash::Sha1, sha1(kept)) + ".refs")),
+                 QFileInfo(FS::PathCombine(instance, "mods", "kept.jar")).absoluteFilePath() + '\n');
+    }
+
+    void test_materializedFileIsIndependent()
+    {
+        QTemporaryDir tmp;
+        QVERIFY(tmp.isValid());
+        ContentStore store(FS::PathCombine(tmp.path(), "store"));
+
+        QByteArray data("some mod jar");
+        auto hash = sha1(data);
+        QVERIFY(store.add(QCryptographicHash::Sha1, hash, writeFile(FS::PathCombine(tmp.path(), "mod.jar"), data)));
+
+        auto target = FS::PathCombine(tmp.path(), "instance", "mods", "mod.jar");
+        QVERIFY(store.materialize(QCryptographicHash::Sha1, hash, target));
+        QCOMPARE(FS::hardLinkCount(target), uintmax_t(1));
+
+        // written to in place, same size and all
+        QFile file(target);
+        QVERIFY(file.open(QIODevice::ReadWrite));
+        file.write("some mod jaR");
+        file.close();
+        QCOMPARE(FS::read(store.blobPath(QCryptographicHash::Sha1, hash)), data);
+    }
+};
+
+QTEST_GUILESS_MAIN(ContentStoreTest)
+
+#include "ContentStore_test.moc"
@@ -0,0 +1,75 @@
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QTemporaryDir>
+#include <QTest>
+
+#include <FileDigestCache.h>
+#include <FileSystem.h>
+
+class FileDigestCacheTest : public QObject {
+    Q_OBJECT
+
+    static bool touch(const QString& path)
+    {
+        QFile file(path);
+        auto later = QDateTime::currentDateTime().addSecs(3600);
+        return file.open(QIODevice::ReadWrite) && file.setFileTime(later, QFileDevice::FileModificationTime);
+    }
+
+    static bool overwrite(const QString& path, qint64 offset, const QByteArray& data)
+    {
+        // in place, keeping the inode and the size
+        QFile file(path);
+        return file.open(QIODevice::ReadWrite) && file.seek(offset) && file.write(data) == data.size();
+    }
+
+   private slots:
+    void test_digest()
+    {
+        QTemporaryDir tmp;
+        QVERIFY(tmp.isValid());
+        auto path = FS::PathCombine(tmp.path(), "file.bin");
+        QByteArray data(100 * 1024, 'a');
+        FS::write(path, data);
+
+        FileDigestCache cache;
+        QVERIFY(cache.cachedDigest(path, QCryptographicHash::Md5).isEmpty());
+        QCOMPARE(cache.digest(path, QCryptographicHash::Md5), QCryptographicHash::hash(data, QCryptographicHash::Md5).toHex());
+        QCOMPARE(cache.cachedDigest(path, QCryptographicHash::Md5), QCryptographicHash::hash(data, QCryptographicHash::Md5).toHex());
+
+        // replaced by a new file, with the same size
+        data.fill('b');
+        FS::write(path, data);
+        QVERIFY(cache.cachedDigest(path, QCryptographicHash::Md5).isEmpty());
+        QCOMPARE(cache.digest(path, QCryptographicHash::Md5), QCryptographicHash::hash(data, QCryptographicHash::Md5).toHex());
+
+        cache.remove(path);
+        QVERIFY(cache.cachedDigest(path, QCryptographicHash::Md5).isEmpty());
+    }
+
+    void test_changedInPlace()
+    {
+        QTemporaryDir tmp;
+        QVERIFY(tmp.isValid());
+        auto path = FS::PathCombine(tmp.path(), "file.bin");
+        QByteArray data(100 * 1024, 'a');
+        FS::write(path, data);
+
+        FileDigestCache cache(FS::PathCombine(tmp.path(), "digests.bin"));
+        QCOMPARE(cache.digest(path, QCryptographicHash::Md5), QCryptographicHash::hash(data, QCryptographicHash::Md5).toHex());
+        cache.save();
+
+        // patched in place somewhere in the middle, same size, same inode, only the modification time tells
+        data[50 * 1024 + 123] = 'b';
+        QVERIFY(overwrite(path, 50 * 1024 + 123, "b"));
+        QVERIFY(touch(path));
+        FileDigestCache reloaded(FS::PathCombine(tmp.path(), "digests.bin"));
+        reloaded.load();
+        QVERIFY(reloaded.cachedDigest(path, QCryptographicHash::Md5).isEmpty());
+        QCOMPARE(reloaded.digest(path, QCryptographicHash::Md5), QCryptographicHash::hash(data, QCryptographicHash::Md5).toHex());
+    }
+};
+
+QTEST_GUILESS_MAIN(FileDigestCacheTest)
+
+#include "FileDigestCache_test.moc"
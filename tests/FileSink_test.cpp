@@ -0,0 +1,347 @@
+#include <QCryptographicHash>
+#include <QEventLoop>
+#include <QNetworkAccessManager>
+#include <QNetworkReply>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QTemporaryDir>
+#include <QTest>
+#include <QTimer>
+
+#include <FileSystem.h>
+
+#include <net/ChecksumValidator.h>
+#include <net/Download.h>
+#include <net/FileSink.h>
+#include <net/NetJob.h>
+
+#include <memory>
+
+// Serves a single file, with range support, and can drop the connection in the middle of sending it.
+class FileServerStandIn : public QTcpServer {
+    Q_OBJECT
+
+   public:
+    FileServerStandIn(QByteArray data, QByteArray etag) : m_data(data), m_etag(etag) { listen(QHostAddress::LocalHost); }
+
+    QUrl url() const { return QUrl(QString("http://127.0.0.1:%1/file.bin").arg(serverPort())); }
+
+    void change(QByteArray data, QByteArray etag)
+    {
+        m_data = data;
+        m_etag = etag;
+    }
+
+    // only send that many bytes of the next response before disconnecting
+    int cut_next = -1;
+    // the same for every response
+    int cut_all = -1;
+    // only send that many bytes of the next response right away, and the rest a moment later
+    int stall_next = -1;
+    bool ranges = true;
+    int requests = 0;
+
+    QByteArray last_range;
+    QByteArray last_if_range;
+
+   protected:
+    void incomingConnection(qintptr handle) override
+    {
+        auto socket = new QTcpSocket(this);
+        socket->setSocketDescriptor(handle);
+        connect(socket, &QTcpSocket::readyRead, this, [this, socket] { readRequest(socket); });
+        connect(socket, &QTcpSocket::disconnected, socket, &QObject::deleteLater);
+    }
+
+   private:
+    void readRequest(QTcpSocket* socket)
+    {
+        auto& buffer = m_buffers[socket];
+        buffer += socket->readAll();
+        auto header_end = buffer.indexOf("\r\n\r\n");
+        if (header_end < 0)
+            return;
+
+        last_range.clear();
+        last_if_range.clear();
+        for (auto& line : buffer.left(header_end).split('\n')) {
+            auto lower = line.toLower();
+            if (lower.startsWith("range:"))
+                last_range = line.mid(6).trimmed();
+            else if (lower.startsWith("if-range:"))
+                last_if_range = line.mid(9).trimmed();
+        }
+        buffer.remove(0, header_end + 4);
+        requests++;
+
+        QByteArray status = "200 OK";
+        QByteArray headers = "ETag: " + m_etag + "\r\n";
+        if (ranges)
+            headers += "Accept-Ranges: bytes\r\n";
+        auto body = m_data;
+
+        qint64 from = last_range.startsWith("bytes=") ? last_range.mid(6, last_range.indexOf('-') - 6).toLongLong() : 0;
+        if (ranges && from > 0 && (last_if_range.isEmpty() || last_if_range == m_etag)) {
+            status = "206 Partial Content";
+            headers += "Content-Range: bytes " + QByteArray::number(from) + "-" + QByteArray::number(m_data.size() - 1) + "/" +
+                       QByteArray::number(m_data.size()) + "\r\n";
+            body = m_data.mid(from);
+        }
+
+        socket->write("HTTP/1.1 " + status + "\r\n" + headers + "Content-Length: " + QByteArray::number(body.size()) + "\r\n\r\n");
+        if (cut_next >= 0 || cut_all >= 0) {
+            socket->write(body.left(cut_next >= 0 ? cut_next : cut_all));
+            cut_next = -1;
+            socket->disconnectFromHost();
+        } else if (stall_next >= 0) {
+            socket->write(body.left(stall_next));
+            QTimer::singleShot(300, socket, [socket, rest = body.mid(stall_next)] { socket->write(rest); });
+            stall_next = -1;
+        } else {
+            socket->write(body);
+        }
+    }
+
+    QByteArray m_data;
+    QByteArray m_etag;
+    QHash<QTcpSocket*, QByteArray> m_buffers;
+};
+
+class FileSinkTest : public QObject {
+    Q_OBJECT
+
+    static QByteArray someData(int size, int seed)
+    {
+        QByteArray data(size, Qt::Uninitialized);
+        for (int i = 0; i < size; i++)
+            data[i] = static_cast<char>((i * 31 + seed) % 251);
+        return data;
+    }
+
+    // drives the sink the way Net::NetRequest does
+    static bool download(Net::FileSink& sink, QNetworkAccessManager& network, const QUrl& url)
+    {
+        QNetworkRequest request(url);
+        if (sink.init(request) != Task::State::Running)
+            return false;
+
+        auto reply = network.get(request);
+        bool started = false;
+        bool write_failed = false;
+        auto write = [&] {
+            if (!started) {
+                started = true;
+                sink.headersReceived(*reply);
+            }
+            auto data = reply->readAll();
+            if (!data.isEmpty() && sink.write(data) != Task::State::Running)
+                write_failed = true;
+        };
+        connect(reply, &QNetworkReply::readyRead, reply, write);
+
+        QEventLoop loop;
+        connect(reply, &QNetworkReply::finished, &loop, &QEventLoop::quit);
+        if (!reply->isFinished())
+            loop.exec();
+        reply->deleteLater();
+
+        if (reply->error() != QNetworkReply::NoError || write_failed) {
+            sink.abort();
+            return false;
+        }
+        write();
+        return sink.finalize(*reply) == Task::State::Succeeded;
+    }
+
+    static QByteArray readFile(const QString& path)
+    {
+        QFile file(path);
+        return file.open(QIODevice::ReadOnly) ? file.readAll() : QByteArray();
+    }
+
+   private slots:
+    void test_resumeAfterDisconnect()
+    {
+        QTemporaryDir tmp;
+        auto target = FS::PathCombine(tmp.path(), "file.bin");
+        auto data = someData(1024 * 1024, 1);
+        FileServerStandIn server(data, "\"v1\"");
+        QNetworkAccessManager network;
+
+        server.cut_next = 300 * 1000;
+        Net::FileSink sink(target);
+        QVERIFY(!download(sink, network, server.url()));
+        QVERIFY(!QFileInfo::exists(target));
+        auto kept = QFileInfo(sink.partialPath()).size();
+        QVERIFY(kept > 0);
+        QVERIFY(QFileInfo::exists(sink.journalPath()));
+
+        // the checksum covers the whole file, so it also proves the validators caught up with the kept part
+        Net::FileSink resumed(target);
+        auto sha1 = QCryptographicHash::hash(data, QCryptographicHash::Sha1);
+        resumed.addValidator(new Net::ChecksumValidator(QCryptographicHash::Sha1, sha1));
+        QVERIFY(download(resumed, network, server.url()));
+        QCOMPARE(server.last_range, "bytes=" + QByteArray::number(kept) + "-");
+        QCOMPARE(server.last_if_range, QByteArray("\"v1\""));
+        QCOMPARE(readFile(target), data);
+        QVERIFY(!QFileInfo::exists(sink.partialPath()));
+        QVERIFY(!QFileInfo::exists(sink.journalPath()));
+    }
+
+    void test_restartWhenChanged()
+    {
+        QTemporaryDir tmp;
+        auto target = FS::PathCombine(tmp.path(), "file.bin");
+        FileServerStandIn server(someData(512 * 1024, 2), "\"v1\"");
+        QNetworkAccessManager network;
+
+        server.cut_next = 100 * 1000;
+        {
+            Net::FileSink sink(target);
+            QVERIFY(!download(sink, network, server.url()));
+            QVERIFY(QFileInfo::exists(sink.journalPath()));
+        }
+
+        auto changed = someData(400 * 1024, 3);
+        server.change(changed, "\"v2\"");
+        Net::FileSink sink(target);
+        QVERIFY(download(sink, network, server.url()));
+        QCOMPARE(server.last_if_range, QByteArray("\"v1\""));
+        QCOMPARE(readFile(target), changed);
+    }
+
+    void test_sameTargetTwice()
+    {
+        QTemporaryDir tmp;
+        auto target = FS::PathCombine(tmp.path(), "file.bin");
+        auto data = someData(1024 * 1024, 5);
+        FileServerStandIn server(data, "\"v1\"");
+        auto network = makeShared<QNetworkAccessManager>();
+
+        server.stall_next = 200 * 1000;
+        NetJob first("first", network, 1);
+        first.setAskRetry(false);
+        first.addNetAction(Net::Download::makeFile(server.url(), target));
+        first.start();
+        Net::FileSink paths(target);
+        QTRY_VERIFY(QFileInfo(paths.partialPath()).size() > 0);
+
+        // the same download into the same place, while the first one is still writing it
+        NetJob second("second", network, 1);
+        second.setAskRetry(false);
+        second.addNetAction(Net::Download::makeFile(server.url(), target));
+        second.start();
+
+        QTRY_VERIFY_WITH_TIMEOUT(first.isFinished() && second.isFinished(), 10000);
+        QVERIFY(first.wasSuccessful());
+        QVERIFY(second.wasSuccessful());
+        // the second one waited for the first to be done, and then took over its file
+        QCOMPARE(server.requests, 1);
+        QCOMPARE(readFile(target), data);
+        QVERIFY(!QFileInfo::exists(paths.partialPath()));
+    }
+
+    void test_sameUrlInMemory()
+    {
+        auto data = someData(1024 * 1024, 8);
+        FileServerStandIn server(data, "\"v1\"");
+        auto network = makeShared<QNetworkAccessManager>();
+
+        server.stall_next = 200 * 1000;
+        auto first_output = std::make_shared<QByteArray>();
+        NetJob first("first", network, 1);
+        first.setAskRetry(false);
+        first.addNetAction(Net::Download::makeByteArray(server.url(), first_output));
+        first.start();
+        QTRY_VERIFY(server.requests == 1);
+
+        auto second_output = std::make_shared<QByteArray>();
+        NetJob second("second", network, 1);
+        second.setAskRetry(false);
+        auto second_download = Net::Download::makeByteArray(server.url(), second_output);
+        auto sha1 = QCryptographicHash::hash(data, QCryptographicHash::Sha1);
+        second_download->addValidator(new Net::ChecksumValidator(QCryptographicHash::Sha1, sha1));
+        second.addNetAction(second_download);
+        second.start();
+
+        QTRY_VERIFY_WITH_TIMEOUT(first.isFinished() && second.isFinished(), 10000);
+        QVERIFY(first.wasSuccessful());
+        QVERIFY(second.wasSuccessful());
+        // the second one got the data the first one downloaded, and still checked it
+        QCOMPARE(server.requests, 1);
+        QCOMPARE(*second_output, data);
+    }
+
+    void test_nothingKeptWithoutRanges()
+    {
+        QTemporaryDir tmp;
+        auto target = FS::PathCombine(tmp.path(), "file.bin");
+        auto data = someData(512 * 1024, 4);
+        FileServerStandIn server(data, "\"v1\"");
+        server.ranges = false;
+        QNetworkAccessManager network;
+
+        server.cut_next = 100 * 1000;
+        {
+            Net::FileSink sink(target);
+            QVERIFY(!download(sink, network, server.url()));
+            QVERIFY(!QFileInfo::exists(sink.partialPath()));
+            QVERIFY(!QFileInfo::exists(sink.journalPath()));
+        }
+
+        Net::FileSink sink(target);
+        QVERIFY(download(sink, network, server.url()));
+        QVERIFY(server.last_range.isEmpty());
+        QCOMPARE(readFile(target), data);
+    }
+
+    void test_partialFolder()
+    {
+        QTemporaryDir tmp;
+        auto target = FS::PathCombine(tmp.path(), "instance", "mods", "mod.jar");
+        auto partials = FS::PathCombine(tmp.path(), "cache", "partial");
+        FileServerStandIn server(someData(512 * 1024, 6), "\"v1\"");
+        auto network = makeShared<QNetworkAccessManager>();
+
+        Net::FileSink::setPartialFolder(partials);
+        server.cut_next = 100 * 1000;
+        Net::FileSink sink(target);
+        QVERIFY(!download(sink, *network, server.url()));
+        Net::FileSink::setPartialFolder({});
+
+        // kept to resume from, but not where the instance would list it
+        QCOMPARE(QFileInfo(sink.partialPath()).absolutePath(), QFileInfo(partials).absoluteFilePath());
+        QVERIFY(QFileInfo::exists(sink.journalPath()));
+        QVERIFY(QDir(FS::PathCombine(tmp.path(), "instance", "mods")).isEmpty());
+
+        // once nothing is going to resume it, it goes away
+        sink.discardPartial();
+        QVERIFY(!QFileInfo::exists(sink.partialPath()));
+        QVERIFY(!QFileInfo::exists(sink.journalPath()));
+    }
+
+    void test_failedJobDiscardsPartials()
+    {
+        QTemporaryDir tmp;
+        auto target = FS::PathCombine(tmp.path(), "file.bin");
+        FileServerStandIn server(someData(512 * 1024, 7), "\"v1\"");
+        auto network = makeShared<QNetworkAccessManager>();
+
+        // every try gets cut off, until the job gives up
+        server.cut_all = 100 * 1000;
+        NetJob job("job", network, 1);
+        job.setAskRetry(false);
+        job.addNetAction(Net::Download::makeFile(server.url(), target));
+        job.start();
+        QTRY_VERIFY_WITH_TIMEOUT(job.isFinished(), 10000);
+        QVERIFY(!job.wasSuccessful());
+
+        Net::FileSink paths(target);
+        QVERIFY(!QFileInfo::exists(paths.partialPath()));
+        QVERIFY(!QFileInfo::exists(paths.journalPath()));
+    }
+};
+
+QTEST_GUILESS_MAIN(FileSinkTest)
+
+#include "FileSink_test.moc"
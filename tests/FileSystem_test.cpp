@@ -1,4 +1,5 @@
 #include <QDir>
+#include <QDirIterator>
 #include <QStandardPaths>
 #include <QTemporaryDir>
 #include <QTest>
@@ -353,6 +354,52 @@ class FileSystemTest : public QObject {
         }
     }
 
+    void test_copy_reports_bytes()
+    {
+        QString folder = QFINDTESTDATA("testdata/FileSystem/test_folder");
+        QTemporaryDir tempDir;
+        tempDir.setAutoRemove(true);
+        QDir target_dir(FS::PathCombine(tempDir.path(), "test_folder"));
+
+        qint64 expected_bytes = 0;
+        int expected_files = 0;
+        QDirIterator it(folder, QDir::Files | QDir::Hidden, QDirIterator::Subdirectories);
+        while (it.hasNext()) {
+            it.next();
+            expected_bytes += it.fileInfo().size();
+            expected_files++;
+        }
+
+        FS::copy c(folder, target_dir.path());
+        QVERIFY(c(true));
+        QCOMPARE(c.totalBytes(), expected_bytes);
+        QCOMPARE(int(c.totalCopied()), expected_files);
+
+        qint64 last_copied = 0;
+        qint64 last_total = 0;
+        int reports = 0;
+        connect(&c, &FS::copy::bytesCopied, [&](qint64 copied, qint64 total) {
+            last_copied = qMax(last_copied, copied);
+            last_total = total;
+            reports++;
+        });
+        QVERIFY(c());
+        QCOMPARE(reports, expected_files);
+        QCOMPARE(last_copied, expected_bytes);
+        QCOMPARE(last_total, expected_bytes);
+
+        QDirIterator copied(folder, QDir::Files | QDir::Hidden, QDirIterator::Subdirectories);
+        while (copied.hasNext()) {
+            auto path = copied.next();
+            auto relative = QDir(folder).relativeFilePath(path);
+            QCOMPARE(FS::read(target_dir.filePath(relative)), FS::read(path));
+        }
+
+        // without overwriting, the files that are already there are failures
+        QVERIFY(!c());
+        QCOMPARE(int(c.totalFailed()), expected_files);
+    }
+
     void test_getDesktop() { QCOMPARE(FS::getDesktopDir(), QStandardPaths::writableLocation(QStandardPaths::DesktopLocation)); }
 
     void test_link()
@@ -0,0 +1,352 @@
+#include <QCryptographicHash>
+#include <QDate>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QEventLoop>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QNetworkAccessManager>
+#include <QNetworkReply>
+#include <QSet>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QTest>
+#include <QTimer>
+#include <QUrlQuery>
+
+#include <modplatform/flame/FlameAPI.h>
+#include <modplatform/flame/FlameCheckUpdate.h>
+#include <modplatform/flame/FlameModIndex.h>
+
+#include <minecraft/mod/Mod.h>
+
+#include <algorithm>
+#include <cmath>
+
+// Answers the few CurseForge endpoints the update check uses, from a generated set of projects, after some latency.
+class CurseForgeStandIn : public QTcpServer {
+    Q_OBJECT
+
+   public:
+    struct File {
+        int id;
+        int mod_id;
+        QStringList game_versions;
+        QString loader;
+        int loader_id;
+        int release_type;
+        QString date;
+    };
+
+    CurseForgeStandIn(int project_count, int latency_ms) : m_latency_ms(latency_ms)
+    {
+        static const QStringList game_versions = { "1.19.2", "1.20.1" };
+        static const QList<QPair<QString, int>> loaders = { { "Forge", 1 }, { "Fabric", 4 }, { "NeoForge", 6 } };
+
+        for (int project = 0; project < project_count; project++) {
+            int mod_id = 1000 + project;
+            m_projects.append(mod_id);
+            // a project has from 1 to 20 files, spread over the game versions, loaders and release types. Some files are for both
+            // game versions, and some don't say which loader they are for (as with a lot of older uploads).
+            int file_count = 1 + project % 20;
+            for (int i = 0; i < file_count; i++) {
+                auto loader = (project + i) % 11 == 0 ? qMakePair(QString(), 0) : loaders.at((project + i / 2) % loaders.size());
+                auto versions = i % 5 == 4 ? game_versions : QStringList{ game_versions.at((project + i) % 2) };
+                m_files.append({ mod_id * 100 + i, mod_id, versions, loader.first, loader.second, 1 + (i * 7) % 3,
+                                 QDate(2023, 1, 1).addDays(i * 3 + project % 5).toString(Qt::ISODate) + "T12:00:00Z" });
+            }
+        }
+    }
+
+    QList<int> projects() const { return m_projects; }
+    QUrl url(QString path) const { return QUrl(QString("http://127.0.0.1:%1%2").arg(serverPort()).arg(path)); }
+
+    int requests = 0;
+    // per endpoint
+    int project_requests = 0;
+    int file_requests = 0;
+    int single_project_requests = 0;
+    // the most ids asked for in one request, and all the file ids asked for
+    int max_ids = 0;
+    QSet<int> requested_files;
+
+   protected:
+    void incomingConnection(qintptr handle) override
+    {
+        auto socket = new QTcpSocket(this);
+        socket->setSocketDescriptor(handle);
+        connect(socket, &QTcpSocket::readyRead, this, [this, socket] { readRequest(socket); });
+        connect(socket, &QTcpSocket::disconnected, socket, &QObject::deleteLater);
+    }
+
+   private:
+    void readRequest(QTcpSocket* socket)
+    {
+        auto& buffer = m_buffers[socket];
+        buffer += socket->readAll();
+
+        auto header_end = buffer.indexOf("\r\n\r\n");
+        if (header_end < 0)
+            return;
+        auto header_lines = buffer.left(header_end).split('\n');
+        int content_length = 0;
+        for (auto& line : header_lines) {
+            if (line.toLower().startsWith("content-length:"))
+                content_length = line.mid(15).trimmed().toInt();
+        }
+        if (buffer.size() < header_end + 4 + content_length)
+            return;
+
+        auto request_line = header_lines.first().trimmed().split(' ');
+        auto body = buffer.mid(header_end + 4, content_length);
+        buffer.remove(0, header_end + 4 + content_length);
+        requests++;
+
+        auto reply = answer(request_line.value(0), QUrl(QString::fromLatin1(request_line.value(1))), body);
+        QTimer::singleShot(m_latency_ms, socket, [socket, reply] {
+            socket->write("HTTP/1.1 200 OK\r\nContent-Type: application/json\r\nContent-Length: " + QByteArray::number(reply.size()) +
+                          "\r\n\r\n" + reply);
+        });
+    }
+
+    QByteArray answer(const QByteArray& method, const QUrl& url, const QByteArray& body)
+    {
+        QJsonArray data;
+        auto path = url.path();
+        if (method == "POST" && path == "/v1/mods") {
+            project_requests++;
+            auto ids = QJsonDocument::fromJson(body)["modIds"].toArray();
+            max_ids = qMax(max_ids, static_cast<int>(ids.size()));
+            for (auto id : ids)
+                data.append(projectJson(id.toInt()));
+        } else if (method == "POST" && path == "/v1/mods/files") {
+            file_requests++;
+            QSet<int> ids;
+            for (auto id : QJsonDocument::fromJson(body)["fileIds"].toArray())
+                ids.insert(id.toInt());
+            max_ids = qMax(max_ids, static_cast<int>(ids.size()));
+            requested_files.unite(ids);
+            for (auto& file : m_files) {
+                if (ids.contains(file.id))
+                    data.append(fileJson(file));
+            }
+        } else if (method == "GET" && path.startsWith("/v1/mods/") && path.endsWith("/files")) {
+            // what a single project update check used to ask for
+            single_project_requests++;
+            int mod_id = path.section('/', 3, 3).toInt();
+            auto game_version = QUrlQuery(url).queryItemValue("gameVersion");
+            for (auto& file : m_files) {
+                if (file.mod_id == mod_id && file.game_versions.contains(game_version))
+                    data.append(fileJson(file));
+            }
+        }
+        return QJsonDocument(QJsonObject{ { "data", data } }).toJson(QJsonDocument::Compact);
+    }
+
+    QJsonObject projectJson(int mod_id) const
+    {
+        // like CurseForge's: the latest file of each game version, loader and release type, with files for more than one game
+        // version listed once for each, and no loader at all for the files that don't have one
+        QMap<QString, QPair<QString, File>> latest;
+        for (auto& file : m_files) {
+            if (file.mod_id != mod_id)
+                continue;
+            for (auto& game_version : file.game_versions) {
+                auto key = QString("%1-%2-%3").arg(game_version).arg(file.loader_id).arg(file.release_type);
+                if (!latest.contains(key) || latest[key].second.date < file.date)
+                    latest[key] = { game_version, file };
+            }
+        }
+        QJsonArray indexes;
+        for (auto& [game_version, file] : latest) {
+            QJsonObject index{ { "gameVersion", game_version },
+                               { "fileId", file.id },
+                               { "filename", QString("mod-%1.jar").arg(file.id) },
+                               { "releaseType", file.release_type } };
+            if (file.loader_id != 0)
+                index["modLoader"] = file.loader_id;
+            indexes.append(index);
+        }
+        return { { "id", mod_id },
+                 { "name", QString("Mod %1").arg(mod_id) },
+                 { "slug", QString("mod-%1").arg(mod_id) },
+                 { "summary", "" },
+                 { "links", QJsonObject{ { "websiteUrl", QString("https://www.curseforge.com/minecraft/mc-mods/mod-%1").arg(mod_id) } } },
+                 { "authors", QJsonArray{ QJsonObject{ { "name", "someone" }, { "url", "https://www.curseforge.com/members/someone" } } } },
+                 { "latestFilesIndexes", indexes } };
+    }
+
+    static QJsonObject fileJson(const File& file)
+    {
+        auto sha1 = QCryptographicHash::hash(QByteArray::number(file.id), QCryptographicHash::Sha1).toHex();
+        auto game_versions = file.game_versions;
+        if (!file.loader.isEmpty())
+            game_versions.append(file.loader);
+        return { { "id", file.id },
+                 { "modId", file.mod_id },
+                 { "displayName", QString("Mod %1 build %2").arg(file.mod_id).arg(file.id) },
+                 { "fileName", QString("mod-%1.jar").arg(file.id) },
+                 { "fileDate", file.date },
+                 { "releaseType", file.release_type },
+                 { "downloadUrl", QString("https://edge.forgecdn.net/files/mod-%1.jar").arg(file.id) },
+                 { "gameVersions", QJsonArray::fromStringList(game_versions) },
+                 { "hashes", QJsonArray{ QJsonObject{ { "value", QString(sha1) }, { "algo", 1 } } } },
+                 { "dependencies", QJsonArray() } };
+    }
+
+    int m_latency_ms;
+    QList<int> m_projects;
+    QList<File> m_files;
+    QHash<QTcpSocket*, QByteArray> m_buffers;
+};
+
+// Sends what is meant for the CurseForge API to the stand-in instead.
+class CurseForgeNetwork : public QNetworkAccessManager {
+   public:
+    CurseForgeNetwork(quint16 port) : m_port(port) {}
+
+   protected:
+    QNetworkReply* createRequest(Operation op, const QNetworkRequest& original, QIODevice* data) override
+    {
+        QNetworkRequest request(original);
+        auto url = request.url();
+        if (url.host() == "api.curseforge.com") {
+            url.setScheme("http");
+            url.setHost("127.0.0.1");
+            url.setPort(m_port);
+            request.setUrl(url);
+        }
+        return QNetworkAccessManager::createRequest(op, request, data);
+    }
+
+   private:
+    quint16 m_port;
+};
+
+class FlameCheckUpdateTest : public QObject {
+    Q_OBJECT
+
+    const int m_project_count = 300;
+    const int m_latency_ms = 2;
+    const std::list<Version> m_game_versions = { Version("1.20.1") };
+    const QList<ModPlatform::ModLoaderType> m_loaders = { ModPlatform::Fabric };
+
+    static QByteArray waitFor(QNetworkReply* reply)
+    {
+        if (!reply->isFinished()) {
+            QEventLoop loop;
+            connect(reply, &QNetworkReply::finished, &loop, &QEventLoop::quit);
+            loop.exec();
+        }
+        reply->deleteLater();
+        return reply->readAll();
+    }
+
+    // the old way: one request per project, one after the other
+    QHash<int, QVariant> checkOneByOne(CurseForgeStandIn& server, QNetworkAccessManager& network)
+    {
+        FlameAPI api;
+        QHash<int, QVariant> latest;
+        for (auto mod_id : server.projects()) {
+            auto url = server.url(QString("/v1/mods/%1/files").arg(mod_id));
+            url.setQuery("pageSize=10000&gameVersion=" + m_game_versions.front().toString());
+            auto response = waitFor(network.get(QNetworkRequest(url)));
+
+            QList<ModPlatform::IndexedVersion> versions;
+            for (auto file : QJsonDocument::fromJson(response)["data"].toArray()) {
+                auto file_obj = file.toObject();
+                versions.append(FlameMod::loadIndexedPackVersion(file_obj));
+            }
+            auto version = api.getLatestVersion(versions, m_loaders, ModPlatform::Fabric);
+            latest.insert(mod_id, version.has_value() ? version->fileId : QVariant());
+        }
+        return latest;
+    }
+
+   private slots:
+    void test_batches()
+    {
+        QVERIFY(FlameCheckUpdate::batches({}).isEmpty());
+
+        QStringList ids;
+        for (int i = 0; i < 250; i++)
+            ids.append(QString::number(i));
+        auto batches = FlameCheckUpdate::batches(ids);
+        QCOMPARE(batches.size(), 3);
+        QStringList joined;
+        for (auto& batch : batches)
+            joined.append(batch);
+        QCOMPARE(joined, ids);
+    }
+
+    void test_sameUpdatesWithLessRequests()
+    {
+        CurseForgeStandIn server(m_project_count, m_latency_ms);
+        QVERIFY(server.listen(QHostAddress::LocalHost));
+
+        QElapsedTimer timer;
+        timer.start();
+        QNetworkAccessManager plain_network;
+        auto expected = checkOneByOne(server, plain_network);
+        auto one_by_one_ms = timer.restart();
+        auto one_by_one_requests = server.requests;
+        server.requests = 0;
+
+        // the mods are on the version the old check finds, so there is nothing to update if the new one agrees
+        std::list<Version> game_versions = m_game_versions;
+        std::vector<std::unique_ptr<Mod>> owned_mods;
+        QList<Mod*> mods;
+        for (auto mod_id : server.projects()) {
+            auto latest = expected.value(mod_id);
+            Metadata::ModStruct metadata;
+            metadata.name = QString("Mod %1").arg(mod_id);
+            metadata.slug = QString("mod-%1").arg(mod_id);
+            metadata.filename = QString("mod-%1.jar").arg(mod_id);
+            metadata.provider = ModPlatform::ResourceProvider::FLAME;
+            metadata.project_id = mod_id;
+            metadata.file_id = latest.isValid() ? latest.toInt() : mod_id * 100;
+            metadata.hash = QCryptographicHash::hash(QByteArray::number(metadata.file_id.toInt()), QCryptographicHash::Sha1).toHex();
+            metadata.hash_format = "sha1";
+            metadata.loaders = ModPlatform::Fabric;
+            owned_mods.emplace_back(new Mod(QDir("mods"), metadata));
+            mods.append(owned_mods.back().get());
+        }
+
+        auto network = makeShared<CurseForgeNetwork>(server.serverPort());
+        FlameCheckUpdate check(mods, game_versions, m_loaders, nullptr, network);
+        QHash<int, QVariant> latest;
+        connect(&check, &CheckUpdateTask::checkFailed, this,
+                [&latest](Mod* mod) { latest.insert(mod->metadata()->project_id.toInt(), QVariant()); });
+        QEventLoop loop;
+        connect(&check, &Task::finished, &loop, &QEventLoop::quit);
+        check.start();
+        if (check.isRunning())
+            loop.exec();
+        auto batched_ms = timer.elapsed();
+
+        QVERIFY(check.wasSuccessful());
+        QVERIFY(check.getUpdatable().empty());
+        for (auto& dependency : check.getDependencies())
+            latest.insert(dependency->pack->addonId.toInt(), dependency->version.fileId);
+
+        qInfo() << "One by one:" << one_by_one_requests << "requests in" << one_by_one_ms << "ms";
+        qInfo() << "Batched:" << server.requests << "requests in" << batched_ms << "ms";
+
+        QCOMPARE(latest, expected);
+        // some projects have files for 1.20.1 with the right loader, some don't
+        QVERIFY(std::any_of(expected.begin(), expected.end(), [](const QVariant& v) { return v.isValid(); }));
+        QVERIFY(std::any_of(expected.begin(), expected.end(), [](const QVariant& v) { return !v.isValid(); }));
+
+        QCOMPARE(one_by_one_requests, m_project_count);
+        QCOMPARE(server.single_project_requests, m_project_count);
+        QVERIFY(server.max_ids <= 100);
+        QCOMPARE(server.project_requests, static_cast<int>(std::ceil(m_project_count / 100.0)));
+        QCOMPARE(server.file_requests, static_cast<int>(std::ceil(server.requested_files.size() / 100.0)));
+        QCOMPARE(server.requests, server.project_requests + server.file_requests);
+    }
+};
+
+QTEST_GUILESS_MAIN(FlameCheckUpdateTest)
+
+#include "FlameCheckUpdate_test.moc"
@@ -0,0 +1,47 @@
+#include <QSignalSpy>
+#include <QTemporaryDir>
+#include <QTest>
+
+#include <FileSystem.h>
+
+#include <modplatform/helpers/HashUtils.h>
+
+class HashUtilsTest : public QObject {
+    Q_OBJECT
+
+   private slots:
+    void test_batchWithUnreadableFile()
+    {
+        QTemporaryDir tmp;
+        QVERIFY(tmp.isValid());
+        auto first = FS::PathCombine(tmp.path(), "first.jar");
+        auto second = FS::PathCombine(tmp.path(), "second.jar");
+        auto missing = FS::PathCombine(tmp.path(), "missing.jar");
+        FS::write(first, "first");
+        FS::write(second, "second");
+
+        Hashing::BatchHasher hasher({ first, missing, second }, { Hashing::Algorithm::Sha1, Hashing::Algorithm::Murmur2 });
+        QSignalSpy hashed(&hasher, &Hashing::BatchHasher::fileHashed);
+        QSignalSpy failed(&hasher, &Hashing::BatchHasher::fileFailed);
+        hasher.start();
+        QTRY_VERIFY(hasher.isFinished());
+
+        // one file missing doesn't take the others down with it
+        QVERIFY(hasher.wasSuccessful());
+        QCOMPARE(hashed.count(), 2);
+        QCOMPARE(failed.count(), 1);
+        QCOMPARE(failed.first().first().toString(), missing);
+        QCOMPARE(hasher.failedFiles(), QStringList{ missing });
+        QCOMPARE(hasher.warnings().size(), 1);
+
+        QCOMPARE(hasher.getResults().size(), 2);
+        QCOMPARE(hasher.getResult(first).value(Hashing::Algorithm::Sha1), Hashing::hash(QByteArray("first"), Hashing::Algorithm::Sha1));
+        QCOMPARE(hasher.getResult(second).value(Hashing::Algorithm::Murmur2),
+                 Hashing::hash(QByteArray("second"), Hashing::Algorithm::Murmur2));
+        QVERIFY(hasher.getResult(missing).isEmpty());
+    }
+};
+
+QTEST_GUILESS_MAIN(HashUtilsTest)
+
+#include "HashUtils_test.moc"
@@ -0,0 +1,86 @@
+#include <QDateTime>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTemporaryDir>
+#include <QTest>
+
+#include <FileSystem.h>
+#include <Json.h>
+
+#include <net/HttpMetaCache.h>
+
+class HttpMetaCacheTest : public QObject {
+    Q_OBJECT
+
+    static QString etagInJson(const QString& index)
+    {
+        for (auto entry : Json::requireArray(Json::requireObject(Json::requireDocument(index)), "entries")) {
+            if (Json::ensureString(Json::ensureObject(entry), "path") == "file.bin")
+                return Json::ensureString(Json::ensureObject(entry), "etag");
+        }
+        return {};
+    }
+
+    static void addEntry(HttpMetaCache& cache, const QString& etag)
+    {
+        auto entry = cache.resolveEntry("base", "file.bin");
+        entry->setETag(etag);
+        entry->makeEternal(true);
+        entry->setStale(false);
+        QVERIFY(cache.updateEntry(entry));
+    }
+
+   private slots:
+    void test_jsonExportedWhenTheIndexChanged()
+    {
+        QTemporaryDir tmp;
+        QVERIFY(tmp.isValid());
+        auto index = FS::PathCombine(tmp.path(), "metacache");
+        {
+            HttpMetaCache cache(index);
+            cache.addBase("base", FS::PathCombine(tmp.path(), "base"));
+            cache.Load();
+            addEntry(cache, "first");
+            // compacts, as there is no binary index yet
+            cache.SaveNow();
+        }
+        // older versions of the launcher only know about the JSON index
+        QCOMPARE(etagInJson(index), QString("first"));
+    }
+
+    void test_newerJsonIndexWins()
+    {
+        QTemporaryDir tmp;
+        QVERIFY(tmp.isValid());
+        auto index = FS::PathCombine(tmp.path(), "metacache");
+        {
+            HttpMetaCache cache(index);
+            cache.addBase("base", FS::PathCombine(tmp.path(), "base"));
+            cache.Load();
+            addEntry(cache, "first");
+        }
+
+        // an older version of the launcher changed the JSON index since
+        auto json = Json::requireObject(Json::requireDocument(index));
+        auto entries = Json::requireArray(json, "entries");
+        auto entry = entries.first().toObject();
+        entry["etag"] = "second";
+        json["entries"] = QJsonArray{ entry };
+        FS::write(index, QJsonDocument(json).toJson());
+        {
+            QFile file(index);
+            QVERIFY(file.open(QIODevice::ReadWrite));
+            QVERIFY(file.setFileTime(QDateTime::currentDateTime().addSecs(3600), QFileDevice::FileModificationTime));
+        }
+
+        HttpMetaCache cache(index);
+        cache.addBase("base", FS::PathCombine(tmp.path(), "base"));
+        cache.Load();
+        QCOMPARE(cache.getEntry("base", "file.bin")->getETag(), QString("second"));
+    }
+};
+
+QTEST_GUILESS_MAIN(HttpMetaCacheTest)
+
+#include "HttpMetaCache_test.moc"
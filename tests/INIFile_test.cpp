@@ -1,8 +1,10 @@
 #include <QTest>
 
 #include <settings/INIFile.h>
+#include <settings/INISettingsObject.h>
 #include <QList>
 #include <QSettings>
+#include <QTemporaryDir>
 #include <QTemporaryFile>
 #include <QVariant>
 #include "FileSystem.h"
@@ -190,6 +192,78 @@ PreLaunchCommand=)";
         FS::deletePath(fileName);
 #endif
     }
+
+    void test_PartialSettingsObject()
+    {
+        QTemporaryDir dir;
+        QVERIFY(dir.isValid());
+        QString fileName = FS::PathCombine(dir.path(), "instance.cfg");
+
+        INIFile full;
+        full.set("name", "On disk");
+        full.set("JvmArgs", "-Xss2M");
+        QVERIFY(full.saveFile(fileName));
+
+        // a stale header proves which values came from it and which from the file
+        INIFile header;
+        header.set("name", "From header");
+        INISettingsObject settings(fileName, header, { "name", "iconKey" });
+        settings.registerSetting("name", "Unnamed Instance");
+        settings.registerSetting("iconKey", "default");
+        settings.registerSetting("JvmArgs", "");
+
+        QCOMPARE(settings.get("name").toString(), QString("From header"));
+        QCOMPARE(settings.get("iconKey").toString(), QString("default"));
+        // anything else reads the whole file
+        QCOMPARE(settings.get("JvmArgs").toString(), QString("-Xss2M"));
+        QCOMPARE(settings.get("name").toString(), QString("On disk"));
+
+        // and writing never drops what wasn't in the header
+        INISettingsObject lazy(fileName, header, { "name", "iconKey" });
+        lazy.registerSetting("name", "Unnamed Instance");
+        lazy.registerSetting("JvmArgs", "");
+        lazy.set("name", "Renamed");
+
+        INIFile saved;
+        QVERIFY(saved.loadFile(fileName));
+        QCOMPARE(saved.get("name", "NOT SET").toString(), QString("Renamed"));
+        QCOMPARE(saved.get("JvmArgs", "NOT SET").toString(), QString("-Xss2M"));
+    }
+
+    void test_PartialSettingsObjectReadFails()
+    {
+        QTemporaryDir dir;
+        QVERIFY(dir.isValid());
+        QString fileName = FS::PathCombine(dir.path(), "instance.cfg");
+        QString awayName = fileName + ".away";
+
+        INIFile full;
+        full.set("name", "On disk");
+        full.set("JvmArgs", "-Xss2M");
+        QVERIFY(full.saveFile(fileName));
+
+        INIFile header;
+        header.set("name", "On disk");
+        INISettingsObject settings(fileName, header, { "name" });
+        settings.registerSetting("name", "Unnamed Instance");
+        settings.registerSetting("JvmArgs", "");
+
+        // the file can't be read when the rest of it is needed
+        QVERIFY(QFile::rename(fileName, awayName));
+        settings.set("name", "Renamed");
+        QVERIFY(!QFile::exists(fileName));
+        QCOMPARE(settings.get("name").toString(), QString("Renamed"));
+
+        // once it can, the change is saved along with everything that was in it
+        QVERIFY(QFile::rename(awayName, fileName));
+        QCOMPARE(settings.get("JvmArgs").toString(), QString("-Xss2M"));
+        QCOMPARE(settings.get("name").toString(), QString("Renamed"));
+
+        INIFile saved;
+        QVERIFY(saved.loadFile(fileName));
+        QCOMPARE(saved.get("name", "NOT SET").toString(), QString("Renamed"));
+        QCOMPARE(saved.get("JvmArgs", "NOT SET").toString(), QString("-Xss2M"));
+    }
 };
 
 QTEST_GUILESS_MAIN(IniFileTest)
@@ -0,0 +1,101 @@
+#include <QDataStream>
+#include <QTemporaryDir>
+#include <QTest>
+
+#include <FileSystem.h>
+
+#include <java/JavaCheckerCache.h>
+
+class JavaCheckerCacheTest : public QObject {
+    Q_OBJECT
+
+    JavaChecker::Result validResult(const QString& path)
+    {
+        JavaChecker::Result result;
+        result.path = path;
+        result.mojangPlatform = "64";
+        result.realPlatform = "amd64";
+        result.javaVersion = QString("17.0.8");
+        result.javaVendor = "Eclipse Adoptium";
+        result.is_64bit = true;
+        result.validity = JavaChecker::Result::Validity::Valid;
+        return result;
+    }
+
+   private slots:
+    void test_findAfterInsert()
+    {
+        QTemporaryDir tmp;
+        QVERIFY(tmp.isValid());
+        auto java = FS::PathCombine(tmp.path(), "java");
+        FS::write(java, "not really a JVM");
+
+        JavaCheckerCache cache;
+        JavaChecker::Result result;
+        QVERIFY(!cache.find(java, result));
+
+        cache.insert(java, validResult(java));
+        QVERIFY(cache.find(java, result));
+        QVERIFY(result.validity == JavaChecker::Result::Validity::Valid);
+        QCOMPARE(result.javaVersion.toString(), QString("17.0.8"));
+        QCOMPARE(result.realPlatform, QString("amd64"));
+        QCOMPARE(result.javaVendor, QString("Eclipse Adoptium"));
+        QVERIFY(result.is_64bit);
+
+        // a different binary at the same path has to be probed again
+        FS::write(java, "an updated JVM, bigger than before");
+        QVERIFY(!cache.find(java, result));
+    }
+
+    void test_onlyValidResults()
+    {
+        QTemporaryDir tmp;
+        QVERIFY(tmp.isValid());
+        auto java = FS::PathCombine(tmp.path(), "java");
+        FS::write(java, "not really a JVM");
+
+        JavaCheckerCache cache;
+        auto result = validResult(java);
+        result.validity = JavaChecker::Result::Validity::Errored;
+        cache.insert(java, result);
+        QVERIFY(!cache.find(java, result));
+
+        // nor paths that don't exist
+        auto missing = FS::PathCombine(tmp.path(), "missing");
+        cache.insert(missing, validResult(missing));
+        QVERIFY(!cache.find(missing, result));
+    }
+
+    void test_persistence()
+    {
+        QTemporaryDir tmp;
+        QVERIFY(tmp.isValid());
+        auto java = FS::PathCombine(tmp.path(), "java");
+        FS::write(java, "not really a JVM");
+        auto cacheFile = FS::PathCombine(tmp.path(), "javacheck.bin");
+
+        JavaCheckerCache(cacheFile).insert(java, validResult(java));
+
+        JavaCheckerCache reloaded(cacheFile);
+        JavaChecker::Result result;
+        QVERIFY(reloaded.find(java, result));
+        QCOMPARE(result.javaVersion.toString(), QString("17.0.8"));
+
+        // garbage is ignored rather than trusted
+        FS::write(cacheFile, "garbage");
+        JavaCheckerCache corrupted(cacheFile);
+        QVERIFY(!corrupted.find(java, result));
+
+        // even when it claims to have more entries than fit in the file
+        QByteArray data;
+        QDataStream out(&data, QIODevice::WriteOnly);
+        out << quint32(0x504a4343) << quint32(1) << quint32(0xffffffff);
+        FS::write(cacheFile, data);
+        JavaCheckerCache oversized(cacheFile);
+        QVERIFY(!oversized.find(java, result));
+    }
+};
+
+QTEST_GUILESS_MAIN(JavaCheckerCacheTest)
+
+#include "JavaCheckerCache_test.moc"
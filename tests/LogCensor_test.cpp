@@ -0,0 +1,47 @@
+#include <QTest>
+
+#include <launch/LogCensor.h>
+
+class LogCensorTest : public QObject {
+    Q_OBJECT
+
+   private slots:
+    void test_censor_data()
+    {
+        QTest::addColumn<QString>("line");
+        QTest::addColumn<QString>("expected");
+
+        QTest::newRow("nothing") << "[12:00:00] [main/INFO]: Setting user: Player" << "[12:00:00] [main/INFO]: Setting user: Player";
+        QTest::newRow("empty") << "" << "";
+        QTest::newRow("token") << "--accessToken eyJhbGciOi.abc" << "--accessToken <ACCESS TOKEN>";
+        QTest::newRow("repeated") << "a8f2b1c3 a8f2b1c3a8f2b1c3" << "<PROFILE ID> <PROFILE ID><PROFILE ID>";
+        QTest::newRow("longest wins") << "session token:eyJhbGciOi.abc:a8f2b1c3 end" << "session <SESSION ID> end";
+        QTest::newRow("shared prefix") << "eyJhbGciOi eyJhbGciOi.abc" << "eyJhbGciOi <ACCESS TOKEN>";
+        QTest::newRow("partial") << "token:eyJhbGciOi.abc:a8f2" << "token:<ACCESS TOKEN>:a8f2";
+        QTest::newRow("non ascii") << "ü a8f2b1c3 ü" << "ü <PROFILE ID> ü";
+    }
+    void test_censor()
+    {
+        QFETCH(QString, line);
+        QFETCH(QString, expected);
+
+        LogCensor censor({ { "token:eyJhbGciOi.abc:a8f2b1c3", "<SESSION ID>" },
+                           { "eyJhbGciOi.abc", "<ACCESS TOKEN>" },
+                           { "a8f2b1c3", "<PROFILE ID>" } });
+        QCOMPARE(censor.censor(line), expected);
+    }
+
+    void test_empty()
+    {
+        LogCensor censor;
+        QVERIFY(censor.isEmpty());
+        QCOMPARE(censor.censor("a line"), QString("a line"));
+
+        LogCensor emptyKey({ { "", "<NOTHING>" } });
+        QCOMPARE(emptyKey.censor("a line"), QString("a line"));
+    }
+};
+
+QTEST_GUILESS_MAIN(LogCensorTest)
+
+#include "LogCensor_test.moc"
@@ -0,0 +1,73 @@
+#include <QSignalSpy>
+#include <QTest>
+
+#include <launch/LogModel.h>
+
+#include <random>
+
+QStringList contents(LogModel& model)
+{
+    QStringList lines;
+    for (int i = 0; i < model.rowCount(); i++) {
+        auto index = model.index(i);
+        lines << QString("%1 %2").arg(model.data(index, LogModel::LevelRole).toInt()).arg(model.data(index, Qt::DisplayRole).toString());
+    }
+    return lines;
+}
+
+class LogModelTest : public QObject {
+    Q_OBJECT
+
+   private slots:
+    void test_batchMatchesSingleAppends_data()
+    {
+        QTest::addColumn<bool>("stopOnOverflow");
+
+        QTest::newRow("circular") << false;
+        QTest::newRow("stop on overflow") << true;
+    }
+    void test_batchMatchesSingleAppends()
+    {
+        QFETCH(bool, stopOnOverflow);
+
+        std::mt19937 eng(7);
+        for (int round = 0; round < 20; round++) {
+            LogModel single;
+            LogModel batched;
+            for (auto model : { &single, &batched }) {
+                model->setMaxLines(16);
+                model->setStopOnOverflow(stopOnOverflow);
+                model->setOverflowMessage("OVERFLOW");
+            }
+
+            int line = 0;
+            while (line < 60) {
+                QVector<LogModel::Line> batch;
+                int size = eng() % 20;
+                for (int i = 0; i < size; i++, line++) {
+                    auto level = static_cast<MessageLevel::Enum>(eng() % (MessageLevel::Fatal + 1));
+                    auto text = QString::number(line);
+                    single.append(level, text);
+                    batch.append({ level, text });
+                }
+
+                QSignalSpy inserted(&batched, &LogModel::rowsInserted);
+                batched.append(batch);
+                QVERIFY(inserted.count() <= 1);
+                QCOMPARE(contents(batched), contents(single));
+            }
+        }
+    }
+
+    void test_suspended()
+    {
+        LogModel model;
+        model.suspend(true);
+        model.append({ { MessageLevel::Message, "a" }, { MessageLevel::Message, "b" } });
+        QCOMPARE(model.rowCount(), 0);
+    }
+};
+
+QTEST_GUILESS_MAIN(LogModelTest)
+
+#include "LogModel_test.moc"
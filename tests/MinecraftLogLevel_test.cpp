@@ -0,0 +1,160 @@
+#include <QElapsedTimer>
+#include <QFile>
+#include <QRegularExpression>
+#include <QTest>
+
+#include <minecraft/MinecraftLogLevel.h>
+
+// What MinecraftInstance::guessLevel used to do, kept as the reference for the scanner.
+MessageLevel::Enum referenceGuess(const QString& line, MessageLevel::Enum level)
+{
+    QRegularExpression re("\\[(?<timestamp>[0-9:]+)\\] \\[[^/]+/(?<level>[^\\]]+)\\]");
+    auto match = re.match(line);
+    if (match.hasMatch()) {
+        // New style logs from log4j
+        QString timestamp = match.captured("timestamp");
+        QString levelStr = match.captured("level");
+        if (levelStr == "INFO")
+            level = MessageLevel::Message;
+        if (levelStr == "WARN")
+            level = MessageLevel::Warning;
+        if (levelStr == "ERROR")
+            level = MessageLevel::Error;
+        if (levelStr == "FATAL")
+            level = MessageLevel::Fatal;
+        if (levelStr == "TRACE" || levelStr == "DEBUG")
+            level = MessageLevel::Debug;
+    } else {
+        // Old style forge logs
+        if (line.contains("[INFO]") || line.contains("[CONFIG]") || line.contains("[FINE]") || line.contains("[FINER]") ||
+            line.contains("[FINEST]"))
+            level = MessageLevel::Message;
+        if (line.contains("[SEVERE]") || line.contains("[STDERR]"))
+            level = MessageLevel::Error;
+        if (line.contains("[WARNING]"))
+            level = MessageLevel::Warning;
+        if (line.contains("[DEBUG]"))
+            level = MessageLevel::Debug;
+    }
+    if (line.contains("overwriting existing"))
+        return MessageLevel::Fatal;
+    static const QString javaSymbol = "([a-zA-Z_$][a-zA-Z\\d_$]*\\.)+[a-zA-Z_$][a-zA-Z\\d_$]*";
+    if (line.contains("Exception in thread") || line.contains(QRegularExpression("\\s+at " + javaSymbol)) ||
+        line.contains(QRegularExpression("Caused by: " + javaSymbol)) ||
+        line.contains(QRegularExpression("([a-zA-Z_$][a-zA-Z\\d_$]*\\.)+[a-zA-Z_$]?[a-zA-Z\\d_$]*(Exception|Error|Throwable)")) ||
+        line.contains(QRegularExpression("... \\d+ more$")))
+        return MessageLevel::Error;
+    return level;
+}
+
+// Not a recording of a real game: the log is generated to look like the output of a modded 1.20.1 Forge client. It mixes
+// log4j lines from the usual threads and loggers, launcher preamble, stdout captured by log4j, and stack traces with the
+// frames, "Caused by:" and "... n more" lines that come with them.
+QStringList loadLog()
+{
+    QFile log(QFINDTESTDATA("testdata/MinecraftLogLevel/modded_client.log"));
+    if (!log.open(QIODevice::ReadOnly))
+        return {};
+    return QString::fromUtf8(log.readAll()).split('\n');
+}
+
+class MinecraftLogLevelTest : public QObject {
+    Q_OBJECT
+
+   private slots:
+    void test_parityWithGeneratedLog()
+    {
+        auto lines = loadLog();
+        QVERIFY(lines.size() > 1000);
+        for (auto& line : lines) {
+            for (auto level : { MessageLevel::StdOut, MessageLevel::StdErr }) {
+                QCOMPARE(MinecraftLogLevel::guess(line, level), referenceGuess(line, level));
+            }
+        }
+    }
+
+    void test_parityWithEdgeCases_data()
+    {
+        QTest::addColumn<QString>("line");
+
+        QTest::newRow("log4j with category") << "[12:00:00] [Render thread/WARN] [mixin/]: thing";
+        QTest::newRow("log4j unknown level") << "[12:00:00] [main/Weird]: x";
+        QTest::newRow("log4j without slash") << "[12:00:00] [main]: no slash";
+        QTest::newRow("log4j unterminated") << "[12:00:00] [main/INFO no close";
+        QTest::newRow("log4j empty timestamp") << "[] [main/INFO]: empty ts";
+        QTest::newRow("log4j bracket in thread") << "[12:00] [a]b/WARN]: x";
+        QTest::newRow("log4j empty thread") << "x [1:2] [/INFO]: x";
+        QTest::newRow("log4j later header") << "x [1:2] [t/]: y [3] [t/ERROR]: z";
+        QTest::newRow("old style mixed") << "2013-01-01 12:00:00 [DEBUG] [X] [WARNING] [SEVERE] [INFO]";
+        QTest::newRow("old style stderr") << "2013-01-01 12:00:00 [STDERR] bla";
+        QTest::newRow("overwriting") << "[12:00:00] [main/INFO]: Registry overwriting existing entry";
+        QTest::newRow("exception in thread") << "Exception in thread \"main\" java.lang.RuntimeException";
+        QTest::newRow("frame") << "\tat net.minecraft.client.Main.main(Main.java:10)";
+        QTest::newRow("frame without space") << "xat a.b";
+        QTest::newRow("frame at line start") << "at net.minecraft.Foo";
+        QTest::newRow("frame unqualified") << "\tat a.1";
+        QTest::newRow("frame number") << "\tat 1a.b";
+        QTest::newRow("caused by") << "Caused by: java.lang.NullPointerException: foo";
+        QTest::newRow("caused by unqualified") << "Caused by: foo";
+        QTest::newRow("omitted frames") << "\t... 23 more";
+        QTest::newRow("omitted frames short") << " 1 more";
+        QTest::newRow("omitted frames no number") << "\t... more";
+        QTest::newRow("numeric package") << "1.2.FooError";
+        QTest::newRow("mixed package") << "x9a.FooError";
+        QTest::newRow("bare throwable") << ".Exception";
+        QTest::newRow("throwable prefix") << "mod.ErrorHandler loaded";
+        QTest::newRow("separated throwable") << "foo.bar baz Exception";
+        QTest::newRow("non ascii") << "[12:00:00] [main/INFO]: Ünïcödé at ä.b Caused by: é.f ... 1 more";
+    }
+    void test_parityWithEdgeCases()
+    {
+        QFETCH(QString, line);
+        for (auto level : { MessageLevel::StdOut, MessageLevel::StdErr }) {
+            QCOMPARE(MinecraftLogLevel::guess(line, level), referenceGuess(line, level));
+        }
+    }
+
+    void benchmark_reference()
+    {
+        auto lines = loadLog();
+        QElapsedTimer timer;
+        qint64 passes = 0, nsecs = 0;
+        QBENCHMARK
+        {
+            timer.start();
+            for (auto& line : lines)
+                referenceGuess(line, MessageLevel::StdOut);
+            nsecs += timer.nsecsElapsed();
+            passes++;
+        }
+        reportThroughput(lines.size() * passes, nsecs);
+    }
+
+    void benchmark_guess()
+    {
+        auto lines = loadLog();
+        QElapsedTimer timer;
+        qint64 passes = 0, nsecs = 0;
+        QBENCHMARK
+        {
+            timer.start();
+            for (auto& line : lines)
+                MinecraftLogLevel::guess(line, MessageLevel::StdOut);
+            nsecs += timer.nsecsElapsed();
+            passes++;
+        }
+        reportThroughput(lines.size() * passes, nsecs);
+    }
+
+   private:
+    // the time per pass over the log depends on the log, lines per second compares with how fast the game prints them
+    static void reportThroughput(qint64 lines, qint64 nsecs)
+    {
+        if (nsecs > 0)
+            qInfo().noquote() << QString("%1 lines per second").arg(qRound64(lines * 1e9 / nsecs));
+    }
+};
+
+QTEST_GUILESS_MAIN(MinecraftLogLevelTest)
+
+#include "MinecraftLogLevel_test.moc"
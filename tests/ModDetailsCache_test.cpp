@@ -0,0 +1,51 @@
+#include <QTemporaryDir>
+#include <QTest>
+
+#include <FileSystem.h>
+
+#include <minecraft/mod/ModDetailsCache.h>
+
+class ModDetailsCacheTest : public QObject {
+    Q_OBJECT
+
+    static ModDetails details(const QString& id)
+    {
+        ModDetails details;
+        details.mod_id = id;
+        details.name = id;
+        return details;
+    }
+
+   private slots:
+    void test_saveDropsGoneMods()
+    {
+        QTemporaryDir tmp;
+        QVERIFY(tmp.isValid());
+        auto cache_file = FS::PathCombine(tmp.path(), "mods.details");
+        QFileInfo kept(FS::PathCombine(tmp.path(), "kept.jar"));
+        QFileInfo removed(FS::PathCombine(tmp.path(), "removed.jar"));
+        FS::write(kept.filePath(), "kept");
+        FS::write(removed.filePath(), "removed");
+
+        ModDetailsCache cache(cache_file);
+        cache.insert(kept, details("kept"), {});
+        cache.insert(removed, details("removed"), {});
+        cache.save();
+
+        // the folder is updated later: unchanged mods aren't looked up again, and one of them is gone
+        FS::deletePath(removed.filePath());
+        cache.save();
+
+        ModDetailsCache reloaded(cache_file);
+        ModDetails found;
+        QImage icon;
+        QVERIFY(reloaded.find(kept, found, icon));
+        QCOMPARE(found.mod_id, QString("kept"));
+        FS::write(removed.filePath(), "removed");
+        QVERIFY(!reloaded.find(QFileInfo(removed.filePath()), found, icon));
+    }
+};
+
+QTEST_GUILESS_MAIN(ModDetailsCacheTest)
+
+#include "ModDetailsCache_test.moc"
@@ -0,0 +1,216 @@
+#include <QDirIterator>
+#include <QEventLoop>
+#include <QRandomGenerator>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QTemporaryDir>
+#include <QTest>
+#include <QTimer>
+
+#include <FileSystem.h>
+#include <MMCZip.h>
+
+#include <modplatform/ModpackPrefetchTask.h>
+
+// Serves files by name, answering every request only after a delay, like a CDN a few hops away would.
+class CdnStandIn : public QTcpServer {
+    Q_OBJECT
+
+   public:
+    CdnStandIn(int latency_ms) : m_latency_ms(latency_ms) { listen(QHostAddress::LocalHost); }
+
+    QUrl url(const QString& name) const { return QUrl(QString("http://127.0.0.1:%1/%2").arg(serverPort()).arg(name)); }
+
+    QHash<QString, QByteArray> files;
+    int requests = 0;
+
+   protected:
+    void incomingConnection(qintptr handle) override
+    {
+        auto socket = new QTcpSocket(this);
+        socket->setSocketDescriptor(handle);
+        connect(socket, &QTcpSocket::readyRead, this, [this, socket] { readRequests(socket); });
+        connect(socket, &QTcpSocket::disconnected, socket, &QObject::deleteLater);
+    }
+
+   private:
+    void readRequests(QTcpSocket* socket)
+    {
+        auto& buffer = m_buffers[socket];
+        buffer += socket->readAll();
+        int header_end;
+        while ((header_end = buffer.indexOf("\r\n\r\n")) >= 0) {
+            // "GET /name HTTP/1.1"
+            auto request_line = buffer.left(buffer.indexOf("\r\n")).split(' ');
+            auto name = request_line.size() > 1 ? QString::fromUtf8(request_line[1].mid(1)) : QString();
+            buffer.remove(0, header_end + 4);
+            requests++;
+
+            QByteArray response;
+            if (files.contains(name)) {
+                auto body = files[name];
+                response = "HTTP/1.1 200 OK\r\nContent-Length: " + QByteArray::number(body.size()) + "\r\n\r\n" + body;
+            } else {
+                response = "HTTP/1.1 404 Not Found\r\nContent-Length: 0\r\n\r\n";
+            }
+            QTimer::singleShot(m_latency_ms, socket, [socket, response] { socket->write(response); });
+        }
+    }
+
+    int m_latency_ms;
+    QHash<QTcpSocket*, QByteArray> m_buffers;
+};
+
+class ModpackPrefetchTest : public QObject {
+    Q_OBJECT
+
+    static QString sha512(const QByteArray& data) { return QCryptographicHash::hash(data, QCryptographicHash::Sha512).toHex(); }
+
+   private slots:
+    void test_modrinthFiles()
+    {
+        auto index = QString(R"({
+            "formatVersion": 1,
+            "game": "minecraft",
+            "files": [
+                { "path": "mods/always.jar", "hashes": { "sha512": "%1" }, "downloads": [ "https://cdn.example/always.jar" ] },
+                { "path": "mods/client.jar", "hashes": { "sha512": "%2" }, "downloads": [ "https://cdn.example/client.jar" ],
+                  "env": { "client": "required", "server": "unsupported" } },
+                { "path": "mods/optional.jar", "hashes": { "sha512": "%3" }, "downloads": [ "https://cdn.example/optional.jar" ],
+                  "env": { "client": "optional" } },
+                { "path": "mods/server.jar", "hashes": { "sha512": "%3" }, "downloads": [ "https://cdn.example/server.jar" ],
+                  "env": { "client": "unsupported" } },
+                { "path": "mods/nowhere.jar", "hashes": { "sha512": "%3" }, "downloads": [] }
+            ]
+        })")
+                         .arg(sha512("always"), sha512("client"), sha512("other"))
+                         .toUtf8();
+
+        auto files = ModpackPrefetchTask::modrinthFiles(index);
+        QCOMPARE(files.size(), 2);
+        QCOMPARE(files[0].url, QUrl("https://cdn.example/always.jar"));
+        QCOMPARE(files[0].algorithm, QCryptographicHash::Sha512);
+        QCOMPARE(files[0].hash, sha512("always"));
+        QCOMPARE(files[1].url, QUrl("https://cdn.example/client.jar"));
+
+        // the creation task is the one reporting broken indexes
+        QVERIFY(ModpackPrefetchTask::modrinthFiles("{ \"files\": 3 }").isEmpty());
+        QVERIFY(ModpackPrefetchTask::modrinthFiles("not json").isEmpty());
+    }
+
+    void test_flameFiles()
+    {
+        auto sha1 = QString(QCryptographicHash::hash("mod", QCryptographicHash::Sha1).toHex());
+
+        Flame::Manifest pack;
+        Flame::File file;
+        file.fileId = 1;
+        file.version.downloadUrl = "https://edge.example/mod.jar";
+        file.version.hash_type = "sha1";
+        file.version.hash = sha1;
+        pack.files.insert(1, file);
+
+        // optional, blocked, or only with a hash the store doesn't share: left to the creation task
+        file.fileId = 2;
+        file.required = false;
+        pack.files.insert(2, file);
+        file.fileId = 3;
+        file.required = true;
+        file.version.downloadUrl.clear();
+        pack.files.insert(3, file);
+        file.fileId = 4;
+        file.version.downloadUrl = "https://edge.example/other.jar";
+        file.version.hash_type = "md5";
+        pack.files.insert(4, file);
+
+        auto files = ModpackPrefetchTask::flameFiles(pack);
+        QCOMPARE(files.size(), 1);
+        QCOMPARE(files[0].url, QUrl("https://edge.example/mod.jar"));
+        QCOMPARE(files[0].algorithm, QCryptographicHash::Sha1);
+        QCOMPARE(files[0].hash, sha1);
+    }
+
+    // What prefetching buys an import: the pack's mods are downloaded while its overrides are extracted, instead of
+    // only once the extraction is done. Both rows do the same work against the same stand-in, only the order differs.
+    void benchmark_import_data()
+    {
+        QTest::addColumn<bool>("overlap");
+        QTest::newRow("extract, then download") << false;
+        QTest::newRow("download while extracting") << true;
+    }
+
+    void benchmark_import()
+    {
+        QFETCH(bool, overlap);
+
+        const int mod_count = 48;
+        const int override_count = 400;
+        QRandomGenerator random(42);
+        auto randomData = [&random](int size) {
+            QByteArray data(size, Qt::Uninitialized);
+            random.fillRange(reinterpret_cast<quint32*>(data.data()), size / sizeof(quint32));
+            return data;
+        };
+
+        CdnStandIn cdn(25);
+        QStringList entries;
+        for (int i = 0; i < mod_count; i++) {
+            auto name = QString("mod%1.jar").arg(i);
+            cdn.files[name] = randomData(256 * 1024);
+            entries << QString(R"({ "path": "mods/%1", "hashes": { "sha512": "%2" }, "downloads": [ "%3" ] })")
+                           .arg(name, sha512(cdn.files[name]), cdn.url(name).toString());
+        }
+        auto index = QString(R"({ "formatVersion": 1, "game": "minecraft", "files": [ %1 ] })").arg(entries.join(',')).toUtf8();
+
+        QTemporaryDir tmp;
+        QVERIFY(tmp.isValid());
+        auto overrides = FS::PathCombine(tmp.path(), "pack");
+        for (int i = 0; i < override_count; i++)
+            FS::write(FS::PathCombine(overrides, "overrides", "config", QString("config%1.dat").arg(i)), randomData(32 * 1024));
+        QFileInfoList files;
+        QDirIterator it(overrides, QDir::Files, QDirIterator::Subdirectories);
+        while (it.hasNext()) {
+            it.next();
+            files << it.fileInfo();
+        }
+        auto pack = FS::PathCombine(tmp.path(), "pack.mrpack");
+        QVERIFY(MMCZip::compressDirFiles(pack, overrides, files));
+
+        auto network = makeShared<QNetworkAccessManager>();
+        int run = 0;
+        QBENCHMARK
+        {
+            auto root = FS::PathCombine(tmp.path(), QString("run%1").arg(run++));
+            auto store = std::make_shared<ContentStore>(FS::PathCombine(root, "store"));
+            auto extract = makeShared<MMCZip::ExtractZipTask>(pack, QDir(FS::PathCombine(root, "instance")), "overrides/");
+            auto prefetch = makeShared<ModpackPrefetchTask>(store, network, 6);
+            prefetch->setModrinthIndex(index);
+
+            QEventLoop loop;
+            int running = 2;
+            auto done = [&loop, &running] {
+                if (--running == 0)
+                    loop.quit();
+            };
+            connect(extract.get(), &Task::finished, &loop, done);
+            connect(prefetch.get(), &Task::finished, &loop, done);
+            if (!overlap)
+                connect(extract.get(), &Task::finished, prefetch.get(), [task = prefetch.get()] { task->start(); });
+
+            extract->start();
+            if (overlap)
+                prefetch->start();
+            loop.exec();
+
+            QVERIFY(extract->wasSuccessful());
+            QVERIFY(prefetch->wasSuccessful());
+        }
+
+        // every run downloaded every mod exactly once
+        QCOMPARE(cdn.requests, mod_count * run);
+    }
+};
+
+QTEST_GUILESS_MAIN(ModpackPrefetchTest)
+
+#include "ModpackPrefetch_test.moc"
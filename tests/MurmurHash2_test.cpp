@@ -0,0 +1,101 @@
+#include <QDirIterator>
+#include <QTest>
+
+#include <modplatform/helpers/HashUtils.h>
+
+#include <MurmurHash2.h>
+#include <random>
+
+// The original two pass, byte at a time implementation, kept as the reference for the CurseForge fingerprint.
+uint32_t referenceHash(const QByteArray& data)
+{
+    auto filter_out = [](char c) { return (c == 9 || c == 10 || c == 13 || c == 32); };
+
+    uint32_t size = 0;
+    for (char c : data) {
+        if (!filter_out(c))
+            size += 1;
+    }
+
+    char buffer[4];
+    int index = 0;
+    Murmur2::IncrementalHashInfo info{ (uint32_t)1 ^ size, (uint32_t)size };
+    for (char c : data) {
+        if (filter_out(c))
+            continue;
+
+        buffer[index] = c;
+        index = (index + 1) % 4;
+
+        if (index == 0)
+            Murmur2::FourBytes_MurmurHash2(reinterpret_cast<unsigned char*>(&buffer), info);
+    }
+    Murmur2::FourBytes_MurmurHash2(reinterpret_cast<unsigned char*>(&buffer), info);
+
+    return info.h;
+}
+
+QByteArray randomData(int size, unsigned seed)
+{
+    std::mt19937 eng(seed);
+    QByteArray data(size, Qt::Uninitialized);
+    for (auto& c : data) {
+        // plenty of whitespace, so both the word and the byte paths get exercised
+        c = eng() % 4 == 0 ? " \t\n\r"[eng() % 4] : static_cast<char>(eng());
+    }
+    return data;
+}
+
+class MurmurHash2Test : public QObject {
+    Q_OBJECT
+
+   private slots:
+    void test_parityWithTestData()
+    {
+        QDirIterator it(QFINDTESTDATA("testdata"), QDir::Files, QDirIterator::Subdirectories);
+        int checked = 0;
+        while (it.hasNext()) {
+            auto path = it.next();
+            QFile file(path);
+            QVERIFY(file.open(QIODevice::ReadOnly));
+            auto expected = QString::number(referenceHash(file.readAll()));
+            file.close();
+
+            QCOMPARE(Hashing::hash(path, Hashing::Algorithm::Murmur2), expected);
+            checked++;
+        }
+        QVERIFY(checked > 0);
+    }
+
+    void test_parityWithRandomData()
+    {
+        // every tail length and alignment around the word size
+        for (int size = 0; size < 64; size++) {
+            auto data = randomData(size, size);
+            QCOMPARE(Murmur2::curseForgeHash(data.constData(), data.size()), referenceHash(data));
+            QCOMPARE(Hashing::hash(data, Hashing::Algorithm::Murmur2), QString::number(referenceHash(data)));
+        }
+    }
+
+    void benchmark_reference()
+    {
+        auto data = randomData(16 * 1024 * 1024, 42);
+        QBENCHMARK
+        {
+            referenceHash(data);
+        }
+    }
+
+    void benchmark_curseForgeHash()
+    {
+        auto data = randomData(16 * 1024 * 1024, 42);
+        QBENCHMARK
+        {
+            Murmur2::curseForgeHash(data.constData(), data.size());
+        }
+    }
+};
+
+QTEST_GUILESS_MAIN(MurmurHash2Test)
+
+#include "MurmurHash2_test.moc"
@@ -0,0 +1,148 @@
+#include <QTest>
+
+#include <net/RequestScheduler.h>
+
+#include <memory>
+#include <vector>
+
+using Net::Priority;
+using Net::RequestScheduler;
+
+class RequestSchedulerTest : public QObject {
+    Q_OBJECT
+
+    struct Request {
+        QObject owner;
+        bool started = false;
+        bool retried = false;
+        RequestScheduler::Result leader;
+    };
+
+    std::vector<std::unique_ptr<Request>> m_requests;
+
+    Request* enqueue(const QString& url, Priority priority = Priority::Normal, const QString& key = {})
+    {
+        m_requests.push_back(std::make_unique<Request>());
+        auto request = m_requests.back().get();
+        RequestScheduler::instance()->enqueue(
+            &request->owner, QUrl(url), key, priority, [request] { request->started = true; },
+            [request](const RequestScheduler::Result& leader) {
+                request->retried = true;
+                request->leader = leader;
+            });
+        return request;
+    }
+
+   private slots:
+    void cleanup()
+    {
+        for (auto& request : m_requests)
+            RequestScheduler::instance()->release(&request->owner);
+        m_requests.clear();
+        QCOMPARE(RequestScheduler::instance()->queuedCount(), 0);
+    }
+
+    void test_perHostLimit()
+    {
+        auto scheduler = RequestScheduler::instance();
+        scheduler->setMaxPerHost(2);
+
+        auto first = enqueue("https://a.example/1");
+        auto second = enqueue("https://a.example/2");
+        auto third = enqueue("https://a.example/3");
+        auto other = enqueue("https://b.example/1");
+
+        QVERIFY(first->started);
+        QVERIFY(second->started);
+        QVERIFY(!third->started);
+        // other hosts have their own budget
+        QVERIFY(other->started);
+        QCOMPARE(scheduler->activeCount("a.example"), 2);
+
+        scheduler->release(&first->owner);
+        QVERIFY(third->started);
+        QCOMPARE(scheduler->activeCount("a.example"), 2);
+    }
+
+    void test_priorities()
+    {
+        auto scheduler = RequestScheduler::instance();
+        scheduler->setMaxPerHost(1);
+
+        auto running = enqueue("https://a.example/running");
+        auto icon = enqueue("https://a.example/icon", Priority::Background);
+        auto install = enqueue("https://a.example/install");
+        auto launch = enqueue("https://a.example/launch", Priority::Blocking);
+        QVERIFY(running->started);
+
+        scheduler->release(&running->owner);
+        QVERIFY(launch->started);
+        QVERIFY(!install->started);
+        QVERIFY(!icon->started);
+
+        scheduler->release(&launch->owner);
+        QVERIFY(install->started);
+        QVERIFY(!icon->started);
+
+        // dropping a queued request doesn't hand out its connection
+        auto dropped = enqueue("https://a.example/dropped");
+        scheduler->release(&dropped->owner);
+        QVERIFY(!dropped->started);
+
+        scheduler->release(&install->owner);
+        QVERIFY(icon->started);
+    }
+
+    void test_sameKeyWaits()
+    {
+        auto scheduler = RequestScheduler::instance();
+        scheduler->setMaxPerHost(6);
+
+        auto leader = enqueue("https://a.example/lib.jar", Priority::Normal, "lib");
+        auto follower = enqueue("https://a.example/lib.jar", Priority::Normal, "lib");
+        QVERIFY(leader->started);
+        QVERIFY(!follower->started);
+        QCOMPARE(scheduler->queuedCount(), 0);
+
+        scheduler->release(&leader->owner, { true, "data" });
+        QVERIFY(!follower->retried);
+        QTRY_VERIFY(follower->retried);
+        QVERIFY(!follower->started);
+        // so it can take over what the leader got
+        QVERIFY(follower->leader.succeeded);
+        QCOMPARE(follower->leader.data, QByteArray("data"));
+    }
+
+    void test_droppedLeader()
+    {
+        auto scheduler = RequestScheduler::instance();
+        scheduler->setMaxPerHost(6);
+
+        auto leader = enqueue("https://a.example/lib.jar", Priority::Normal, "lib");
+        auto follower = enqueue("https://a.example/lib.jar", Priority::Normal, "lib");
+
+        // a leader that goes away without a result leaves the followers to fetch it themselves
+        scheduler->release(&leader->owner);
+        QTRY_VERIFY(follower->retried);
+        QVERIFY(!follower->leader.succeeded);
+    }
+
+    void test_followerRaisesLeaderPriority()
+    {
+        auto scheduler = RequestScheduler::instance();
+        scheduler->setMaxPerHost(1);
+
+        auto running = enqueue("https://a.example/running");
+        auto other = enqueue("https://a.example/other");
+        auto leader = enqueue("https://a.example/lib.jar", Priority::Background, "lib");
+        enqueue("https://a.example/lib.jar", Priority::Blocking, "lib");
+
+        scheduler->release(&running->owner);
+        QVERIFY(leader->started);
+        QVERIFY(!other->started);
+    }
+};
+
+QTEST_GUILESS_MAIN(RequestSchedulerTest)
+
+#include "RequestScheduler_test.moc"
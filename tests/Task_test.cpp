@@ -1,3 +1,4 @@
+#include <QElapsedTimer>
 #include <QTest>
 #include <QThread>
 #include <QTimer>
@@ -34,6 +35,19 @@ class BasicTask_MultiStep : public Task {
     void executeTask() override {}
 };
 
+/* Reports a lot of progress in one go, like a download getting many small chunks. */
+class ChattyTask : public Task {
+    Q_OBJECT
+
+   private:
+    void executeTask() override
+    {
+        for (int i = 1; i <= 1000; i++)
+            emit progress(i, 1000);
+        QTimer::singleShot(50, this, &ChattyTask::emitSucceeded);
+    }
+};
+
 class BigConcurrentTask : public ConcurrentTask {
     Q_OBJECT
 
@@ -124,6 +138,55 @@ class TaskTest : public QObject {
         QCOMPARE(t.getTotalProgress(), total);
     }
 
+    void test_progressIsCoalesced()
+    {
+        BasicTask t;
+        int emitted = 0;
+        qint64 last = 0;
+        connect(&t, &Task::progress, [&](qint64 current, qint64) {
+            emitted++;
+            last = current;
+        });
+
+        // however slow the machine, there is at most one update per interval, plus the first one
+        QElapsedTimer elapsed;
+        elapsed.start();
+        auto bound = [&elapsed] { return elapsed.elapsed() / BasicTask::s_progress_interval_ms + 2; };
+
+        for (int i = 1; i <= 1000; i++)
+            t.setProgress(i, 2000);
+        QVERIFY(emitted <= bound());
+        // what was held back still goes out
+        QTRY_COMPARE(last, qint64(1000));
+        QVERIFY(emitted <= bound());
+
+        // and the end right away
+        t.setProgress(2000, 2000);
+        QCOMPARE(last, qint64(2000));
+    }
+
+    void test_concurrentProgressIsCoalesced()
+    {
+        ConcurrentTask t;
+        t.addTask(makeShared<ChattyTask>());
+        t.addTask(makeShared<ChattyTask>());
+
+        int step_updates = 0;
+        connect(&t, &Task::stepProgress, [&](const TaskStepProgress& step) {
+            if (!step.isDone())
+                step_updates++;
+        });
+
+        QElapsedTimer elapsed;
+        elapsed.start();
+        t.start();
+        QVERIFY2(QTest::qWaitFor([&]() { return t.isFinished(); }, 1000), "Task didn't finish as it should.");
+        QVERIFY(t.wasSuccessful());
+        QVERIFY(step_updates > 0);
+        // a batch per interval, not one per progress report, each with an update for both subtasks at most
+        QVERIFY(step_updates <= 2 * (elapsed.elapsed() / BasicTask::s_progress_interval_ms + 2));
+    }
+
     void test_basicRun()
     {
         BasicTask t;
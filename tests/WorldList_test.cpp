@@ -0,0 +1,67 @@
+#include <QTemporaryDir>
+#include <QTest>
+
+#include <FileSystem.h>
+
+#include <minecraft/WorldList.h>
+
+class WorldListTest : public QObject {
+    Q_OBJECT
+
+    int rowOf(WorldList& list, const QString& folderName)
+    {
+        for (int i = 0; i < list.rowCount(); i++) {
+            if (list[i].folderName() == folderName)
+                return i;
+        }
+        return -1;
+    }
+
+   private slots:
+    void test_scan()
+    {
+        QTemporaryDir tmp;
+        QVERIFY(tmp.isValid());
+        auto saves = FS::PathCombine(tmp.path(), "saves");
+        QVERIFY(FS::copy(QFINDTESTDATA("testdata/WorldList/saves"), saves)());
+        FS::ensureFolderPathExists(FS::PathCombine(saves, "not a world"));
+
+        WorldList list(saves, nullptr);
+        QVERIFY(list.update());
+        list.waitForUpdate();
+
+        QCOMPARE(list.rowCount(), 2);
+        int first = rowOf(list, "first");
+        QVERIFY(first != -1);
+        QCOMPARE(list[first].name(), QString("First World"));
+        QCOMPARE(qint64(list[first].seed()), qint64(42));
+        QCOMPARE(list[rowOf(list, "second")].name(), QString("Second World"));
+
+        // sizes are only calculated once they are shown, sorting or asking for the raw value doesn't count
+        QCOMPARE(qint64(list[first].bytes()), qint64(-1));
+        int second = rowOf(list, "second");
+        QCOMPARE(list.data(list.index(second, WorldList::SizeColumn), WorldList::SizeRole).toLongLong(), -1LL);
+        QCOMPARE(list.data(list.index(second, WorldList::SizeColumn), Qt::UserRole).toLongLong(), -1LL);
+        list.data(list.index(first, WorldList::SizeColumn), Qt::DisplayRole);
+        QTRY_VERIFY(list[first].bytes() >= 0);
+        QCOMPARE(qint64(list[first].bytes()), qint64(World::calculateSize(QFileInfo(FS::PathCombine(saves, "first")))));
+        QCOMPARE(qint64(list[rowOf(list, "second")].bytes()), qint64(-1));
+
+        // unchanged worlds keep what is known about them across scans
+        QVERIFY(list.update());
+        list.waitForUpdate();
+        QCOMPARE(list.rowCount(), 2);
+        QVERIFY(list[rowOf(list, "first")].bytes() > 0);
+
+        // and removed ones go away
+        QVERIFY(FS::deletePath(FS::PathCombine(saves, "second")));
+        QVERIFY(list.update());
+        list.waitForUpdate();
+        QCOMPARE(list.rowCount(), 1);
+        QCOMPARE(list[0].folderName(), QString("first"));
+    }
+};
+
+QTEST_GUILESS_MAIN(WorldListTest)
+
+#include "WorldList_test.moc"